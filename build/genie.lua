@@ -77,3 +77,5 @@ end
 AddProject("dev")
 AddProject("samples")
 AddProject("forge")
+AddProject("shadercompiler")
+AddProject("tests")
@@ -7,9 +7,7 @@
 // ---------------------------------------- TODO LIST ------------------------------------------ //
 // Features coming up:
 //
-//	> Shader Precompilation: precompile shaders to avoid compiling at every start-up.
 //	> Shader Visual Studio integration 2: shader compilation from solution.
-//		- req: Shader Precompilation
 //
 //	> GFX Stencil State.
 //	> GFX Display List: command recording for later execution.
@@ -20,7 +18,6 @@
 //	> GFX Line Rendering.
 //  > GFX Per Frame Resources
 //  > GFX Per Pass Resources
-//  > GFX Pipeline State Caching
 //
 //	> Object Loading from file (.obj).
 //	> Scene Loading (.gltf, .usd?).
@@ -33,7 +33,7 @@ private:
 	BufferHandle m_CubeVtxBuf;
 	BufferHandle m_CubeIdxBuf;
 
-	BufferHandle m_CubeCbvBuf; ShaderResourceProxy m_CubeCbvBufProxy;
+	ShaderResourceProxy m_CubeCbvBufProxy;
 
 	struct CubeCB
 	{
@@ -83,12 +83,11 @@ public:
 		auto idxBufDesc = AllocIndexBufferDesc(numIndices);
 		m_CubeIdxBuf = rm.CreateBuffer(idxBufDesc, &Cube::s_Indices, numIndices * sizeof(uint16), "Cube Index Buffer");
 
-		// Create a constant buffer and fill it with the necessary constant data for rendering the cube.
+		// Fill in the constant data for rendering the cube. It is copied to per-frame memory when bound,
+		// so no constant buffer needs to be created for it.
 		m_CubeCB.viewProjMatrix = ComputeViewProjectionMatrix();
 		m_CubeCB.vtxBufIdx = rm.GetBindlessSRV(m_CubeVtxBuf);
 
-		m_CubeCbvBuf = rm.CreateBuffer(AllocCbvBufferDesc(sizeof(CubeCB)), &m_CubeCB, sizeof(CubeCB), "Cube Constant Buffer");
-
 		m_CubeModelMatrix = float4x4::identity();
 	}
 
@@ -101,7 +100,6 @@ public:
 		rm.DestroyPipeline(m_CubePso);
 		rm.DestroyBuffer(m_CubeVtxBuf);
 		rm.DestroyBuffer(m_CubeIdxBuf);
-		rm.DestroyBuffer(m_CubeCbvBuf);
 
 		DestroyIntermediateRenderTargets();
 	}
@@ -128,11 +126,11 @@ public:
 
 		ctx.BeginRenderPass(m_CubePso, rpDesc);
 		{
-			// Bind our constant buffer containing the bindless index to the vertex buffer and camera matrix
+			// Bind our constant data containing the bindless index to the vertex buffer and camera matrix
 			// information. The model matrix is passed via push constants so that we only have to update the
-			// constant buffer data once.
+			// constant data when the camera changes.
 			ctx.SetPushConstants(&m_CubeModelMatrix, sizeof(float4x4));
-			ctx.BindConstantBuffer(m_CubeCbvBufProxy, m_CubeCbvBuf);
+			ctx.BindDynamicConstantBuffer(m_CubeCbvBufProxy, m_CubeCB);
 			ctx.BindIndexBuffer(m_CubeIdxBuf);
 			ctx.DrawIndexed(36);
 		}
@@ -162,9 +160,6 @@ public:
 		CreateIntermediateRenderTargets(event.m_WindowSize);
 
 		m_CubeCB.viewProjMatrix = ComputeViewProjectionMatrix();
-
-		GPUResourceManager& rm = ctx.GetGPUResourceManager();
-		rm.UpdateBuffer(m_CubeCbvBuf, &m_CubeCB, sizeof(m_CubeCB));
 	}
 
 	void OnReloadShadersEvent() override
@@ -13,12 +13,13 @@ using namespace vast;
  * --------
  * This sample renders a textured cube and sphere rotating inside a skybox and reflecting the
  * environment. The textures are loaded from disk. The cube uses point sampling while the sphere
- * does bilinear filtering.
+ * does bilinear filtering. Per object constants change every frame, so instead of keeping a
+ * constant buffer per object, they are copied into per-frame memory when binding them.
  * 
  * All code for this sample is contained within this file plus the shader files 'Fullscreen.hlsl'
  * and '03_TexturedMesh.hlsl'.
  * 
- * Topics: texture loading, samplers, perspective camera, skybox
+ * Topics: texture loading, samplers, perspective camera, skybox, dynamic constant buffers
  *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 class Textures final : public ISample
@@ -32,7 +33,6 @@ private:
 	{
 		BufferHandle vtxBuf;
 		BufferHandle idxBuf;
-		BufferHandle cbvBuf;
 		TextureHandle colorTex;
 		uint32 numIndices;
 
@@ -113,7 +113,6 @@ public:
 		{
 			// Create the cube vertex buffer with bindless access.
 			auto vtxBufDesc = AllocVertexBufferDesc(sizeof(Cube::s_Vertices_PosNormalUv), sizeof(Cube::s_Vertices_PosNormalUv[0]));
-			auto cbvBufDesc = AllocCbvBufferDesc(sizeof(Drawable::CB));
 
 			m_TexturedDrawables[0].vtxBuf = rm.CreateBuffer(vtxBufDesc, &Cube::s_Vertices_PosNormalUv, sizeof(Cube::s_Vertices_PosNormalUv), "Cube Vertex Buffer");
 			// Note: This time, we render the cube without an index buffer.
@@ -125,8 +124,6 @@ public:
 			m_TexturedDrawables[0].cb.vtxBufIdx = rm.GetBindlessSRV(m_TexturedDrawables[0].vtxBuf);
 			m_TexturedDrawables[0].cb.colorTexIdx = rm.GetBindlessSRV(m_TexturedDrawables[0].colorTex);
 			m_TexturedDrawables[0].cb.colorSamplerIdx = IDX(SamplerState::POINT_CLAMP);
-
-			m_TexturedDrawables[0].cbvBuf = rm.CreateBuffer(cbvBufDesc, &m_TexturedDrawables[0].cb, sizeof(Drawable::CB), "Cube Constant Buffer");
 		}
 
 		{
@@ -139,7 +136,6 @@ public:
 
 			auto vtxBufDesc = AllocVertexBufferDesc(vtxSize, sizeof(Vtx3fPos3fNormal2fUv));
 			auto idxBufDesc = AllocIndexBufferDesc(numIndices);
-			auto cbvBufDesc = AllocCbvBufferDesc(sizeof(Drawable::CB));
 
 			m_TexturedDrawables[1].vtxBuf = rm.CreateBuffer(vtxBufDesc, sphereVertexData.data(), sphereVertexData.size() * sizeof(Vtx3fPos3fNormal2fUv), "Sphere Vertex Buffer");
 			m_TexturedDrawables[1].idxBuf = rm.CreateBuffer(idxBufDesc, sphereIndexData.data(), sphereIndexData.size() * sizeof(uint16), "Sphere Index Buffer");
@@ -151,8 +147,6 @@ public:
 			m_TexturedDrawables[1].cb.vtxBufIdx = rm.GetBindlessSRV(m_TexturedDrawables[1].vtxBuf);
 			m_TexturedDrawables[1].cb.colorTexIdx = rm.GetBindlessSRV(m_TexturedDrawables[1].colorTex);
 			m_TexturedDrawables[1].cb.colorSamplerIdx = IDX(SamplerState::LINEAR_CLAMP);
-
-			m_TexturedDrawables[1].cbvBuf = rm.CreateBuffer(cbvBufDesc, &m_TexturedDrawables[1].cb, sizeof(Drawable::CB), "Sphere Constant Buffer");
 		}
 	}
 
@@ -173,7 +167,6 @@ public:
 		{
 			rm.DestroyBuffer(i.vtxBuf);
 			if (i.idxBuf.IsValid()) rm.DestroyBuffer(i.idxBuf);
-			rm.DestroyBuffer(i.cbvBuf);
 			rm.DestroyTexture(i.colorTex);
 		}
 
@@ -192,11 +185,6 @@ public:
 
 		rm.UpdateBuffer(m_FrameCbvBuf, &m_FrameCB, sizeof(FrameCB));
 
-		for (auto& i : m_TexturedDrawables)
-		{
-			rm.UpdateBuffer(i.cbvBuf, &i.cb, sizeof(Drawable::CB));
-		}
-
 		VAST_PROFILE_GPU_BEGIN("Forward Render Pass", ctx);
 
 		// Transition and clear our intermediate color and depth targets and set the pipeline state
@@ -220,13 +208,13 @@ public:
 						if (!rm.GetIsReady(i.idxBuf))
 							continue;
 
-						ctx.BindConstantBuffer(m_TexturedMeshCbvProxy, i.cbvBuf);
+						ctx.BindDynamicConstantBuffer(m_TexturedMeshCbvProxy, i.cb);
 						ctx.BindIndexBuffer(i.idxBuf);
 						ctx.DrawIndexed(i.numIndices);
 					}
 					else
 					{
-						ctx.BindConstantBuffer(m_TexturedMeshCbvProxy, i.cbvBuf);
+						ctx.BindDynamicConstantBuffer(m_TexturedMeshCbvProxy, i.cb);
 						ctx.Draw(i.numIndices);
 					}
 				}
@@ -0,0 +1,56 @@
+PROJ_DIR = path.getabsolute("../")
+
+-- Note: Only device-agnostic engine sources are built into the tool (instead of linking against
+-- vast), so that it also builds on Linux asset build machines.
+project "shadercompiler"
+	kind "ConsoleApp"
+	language "C++"
+	
+	AddLibrary(spdlog)
+	AddLibrary(hlslpp)
+	
+	files
+	{
+		path.join(PROJ_DIR, "src/**.h"),
+		path.join(PROJ_DIR, "src/**.cpp"),
+		path.join(ROOT_DIR, "src/Core/Filesystem.cpp"),
+		path.join(ROOT_DIR, "src/Core/Log.cpp"),
+		path.join(ROOT_DIR, "src/Core/ThreadPool.cpp"),
+		path.join(ROOT_DIR, "src/Core/Tracing.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/ShaderArchive.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/ShaderFileCache.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/API/DX12/DX12_ShaderCompiler.cpp"),
+	}
+	
+	includedirs
+	{
+		path.join(PROJ_DIR, "src"),
+		path.join(ROOT_DIR, "src"),
+		path.join(ROOT_DIR, "vendor"),
+	}
+	
+	configuration "windows"
+		AddLibrary(DirectXShaderCompiler)
+		
+	-- The DXC release for Linux provides libdxcompiler.so and the headers dxcapi.h depends on there
+	-- (i.e. dxc/Support/WinAdapter.h), found through DXC_DIR.
+	configuration "linux"
+		includedirs { path.join(os.getenv("DXC_DIR") or "", "include") }
+		libdirs { path.join(os.getenv("DXC_DIR") or "", "lib") }
+		links { "dxcompiler", "pthread", "dl" }
+	
+	configuration "Debug"
+		links { "minitrace" }
+		defines { "MTR_ENABLED" }
+		targetdir 	(path.join(PROJ_DIR, "build/bin/Debug/"))
+		objdir 		(path.join(PROJ_DIR, "build/obj/Debug/"))
+		
+	configuration "Release"
+		targetdir 	(path.join(PROJ_DIR, "build/bin/Release/"))
+		objdir 		(path.join(PROJ_DIR, "build/obj/Release/"))
+		
+	configuration { "windows", "Debug" }
+		CopyDebugDLLs(PROJ_DIR)
+		
+	configuration { "windows", "Release" }
+		CopyReleaseDLLs(PROJ_DIR)
@@ -0,0 +1,234 @@
+#include "vastpch.h"
+#include "Core/ThreadPool.h"
+#include "Graphics/ShaderArchive.h"
+#include "Graphics/ShaderFileCache.h"
+#include "Graphics/API/DX12/DX12_ShaderCompiler.h"
+
+#include "dx12/DirectXShaderCompiler/inc/dxcapi.h"
+
+#include <filesystem>
+#include <fstream>
+#include <regex>
+
+// ===================================== SHADER COMPILER TOOL =====================================
+//
+// Compiles every shader entry point found in the given shader folders and packs the results into
+// a shader archive, which the engine can then load instead of compiling at startup (see the
+// 'ShaderArchive' argument).
+//
+// Usage: shadercompiler -o <archive> [-j <threads>] [-I <include dir>]... <shader dir>...
+//
+// All .hlsl files under each shader folder are compiled, with shader names relative to the folder
+// they were found in (i.e. the same names used in ShaderDesc). Entry points are found by naming
+// convention: functions named VS_*, PS_* and CS_* are compiled as vertex, pixel and compute shaders
+// respectively. Shader folders are also used as include directories, in the order given.
+//
+// Shaders are compiled with the same arguments and defines the engine uses at runtime, for the
+// configuration (Debug/Release) the tool was built in. Only device-agnostic code is used, so the
+// tool also builds and runs on Linux.
+//
+// ================================================================================================
+
+using namespace vast;
+
+struct ShaderJob
+{
+	std::string shaderName;
+	std::string filePath;
+	std::string entryPoint;
+	ShaderType type;
+
+	bool bSucceeded = false;
+	Vector<uint8> bytecode;
+	Vector<uint8> reflection;
+};
+
+static ShaderType GetShaderTypeFromEntryPoint(const std::string& entryPoint)
+{
+	if (entryPoint.starts_with("VS_")) return ShaderType::VERTEX;
+	if (entryPoint.starts_with("PS_")) return ShaderType::PIXEL;
+	if (entryPoint.starts_with("CS_")) return ShaderType::COMPUTE;
+	return ShaderType::UNKNOWN;
+}
+
+static void FindShaderEntryPoints(const std::filesystem::path& shaderDir, Vector<ShaderJob>& outJobs)
+{
+	// Function definitions (return type followed by name) named by entry point convention.
+	static const std::regex s_EntryPointRegex(R"(^\s*[A-Za-z_][\w<>, ]*\s+((VS|PS|CS)_\w+)\s*\()");
+
+	Vector<std::filesystem::path> files;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(shaderDir))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".hlsl")
+		{
+			files.push_back(entry.path());
+		}
+	}
+	// Note: Directory iteration order is unspecified, sort so that archives are reproducible.
+	std::sort(files.begin(), files.end());
+
+	for (const auto& file : files)
+	{
+		std::ifstream source(file);
+		std::string line;
+		while (std::getline(source, line))
+		{
+			// Note: Skip statements, which could be calls to functions following the same convention.
+			std::smatch match;
+			if (line.find(';') == std::string::npos && std::regex_search(line, match, s_EntryPointRegex))
+			{
+				ShaderJob job;
+				job.shaderName = std::filesystem::relative(file, shaderDir).generic_string();
+				job.filePath = file.string();
+				job.entryPoint = match[1].str();
+				job.type = GetShaderTypeFromEntryPoint(job.entryPoint);
+				outJobs.push_back(std::move(job));
+			}
+		}
+	}
+}
+
+static void CompileShaderJob(ShaderJob& job, DX12ShaderCompiler& compiler, const Vector<std::wstring>& includeDirs, const Vector<std::wstring>& defines)
+{
+	ShaderCompilerArguments sca;
+	sca.shaderType = job.type;
+	sca.shaderName = std::wstring(job.shaderName.begin(), job.shaderName.end());
+	sca.shaderEntryPoint = std::wstring(job.entryPoint.begin(), job.entryPoint.end());
+	sca.includeDirectories = includeDirs;
+	sca.additionalDefines = defines;
+
+	IDxcBlobEncoding* source = compiler.LoadShader(std::wstring(job.filePath.begin(), job.filePath.end()));
+	if (!source)
+		return;
+
+	IDxcResult* result = compiler.CompileShader(source, sca);
+	source->Release();
+	if (!result)
+		return;
+
+	IDxcBlob* bytecode = compiler.ExtractShaderOutput(result);
+	IDxcBlob* reflection = compiler.ExtractShaderReflectionBlob(result);
+	if (bytecode && bytecode->GetBufferSize() && reflection && reflection->GetBufferSize())
+	{
+		const uint8* bytecodeData = static_cast<const uint8*>(bytecode->GetBufferPointer());
+		const uint8* reflectionData = static_cast<const uint8*>(reflection->GetBufferPointer());
+		job.bytecode.assign(bytecodeData, bytecodeData + bytecode->GetBufferSize());
+		job.reflection.assign(reflectionData, reflectionData + reflection->GetBufferSize());
+		job.bSucceeded = true;
+	}
+
+	if (reflection) reflection->Release();
+	if (bytecode) bytecode->Release();
+	result->Release();
+}
+
+static int PrintUsage()
+{
+	VAST_LOG_ERROR("Usage: shadercompiler -o <archive> [-j <threads>] [-I <include dir>]... <shader dir>...");
+	return EXIT_FAILURE;
+}
+
+int main(int argc, char** argv)
+{
+	VAST_LOGGING_ONLY(Log::Init());
+
+	std::string outputPath;
+	uint32 numThreads = 0;
+	Vector<std::string> shaderDirs;
+	Vector<std::string> extraIncludeDirs;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		const bool bHasValue = (i + 1 < argc);
+		if (arg == "-o" && bHasValue)
+		{
+			outputPath = argv[++i];
+		}
+		else if (arg == "-j" && bHasValue)
+		{
+			numThreads = static_cast<uint32>(std::stoul(argv[++i]));
+		}
+		else if (arg == "-I" && bHasValue)
+		{
+			extraIncludeDirs.push_back(argv[++i]);
+		}
+		else if (!arg.empty() && arg[0] != '-')
+		{
+			shaderDirs.push_back(arg);
+		}
+		else
+		{
+			return PrintUsage();
+		}
+	}
+
+	if (outputPath.empty() || shaderDirs.empty())
+		return PrintUsage();
+
+	Vector<ShaderJob> jobs;
+	Vector<std::wstring> includeDirs;
+	for (const auto& dir : shaderDirs)
+	{
+		if (!std::filesystem::is_directory(dir))
+		{
+			VAST_LOG_ERROR("Shader folder '{}' not found.", dir);
+			return EXIT_FAILURE;
+		}
+		FindShaderEntryPoints(dir, jobs);
+		includeDirs.push_back(std::wstring(dir.begin(), dir.end()));
+	}
+	for (const auto& dir : extraIncludeDirs)
+	{
+		includeDirs.push_back(std::wstring(dir.begin(), dir.end()));
+	}
+
+	ThreadPool threadPool(numThreads);
+	ShaderFileCache fileCache;
+	Vector<Ptr<DX12ShaderCompiler>> compilers(threadPool.GetNumThreads());
+	for (auto& compiler : compilers)
+	{
+		compiler = MakePtr<DX12ShaderCompiler>(fileCache);
+	}
+
+	VAST_LOG_INFO("Compiling {} shaders with {} using {} threads.", jobs.size(), compilers[0]->GetVersionString(), threadPool.GetNumThreads());
+
+	const Vector<std::wstring> defines = GetEngineShaderDefines();
+	threadPool.ParallelFor(static_cast<uint32>(jobs.size()), [&](uint32 i, uint32 threadIdx)
+		{
+			CompileShaderJob(jobs[i], *compilers[threadIdx], includeDirs, defines);
+		});
+
+	ShaderArchiveWriter writer;
+	uint32 numFailed = 0;
+	for (const auto& job : jobs)
+	{
+		if (!job.bSucceeded)
+		{
+			VAST_LOG_ERROR("Failed to compile shader '{}' with entry point '{}'.", job.shaderName, job.entryPoint);
+			numFailed++;
+			continue;
+		}
+
+		if (!writer.AddShader(job.shaderName, job.entryPoint, job.type, job.bytecode.data(), job.bytecode.size(), job.reflection.data(), job.reflection.size()))
+		{
+			VAST_LOG_WARNING("Skipping shader '{}' with entry point '{}' found in more than one shader folder.", job.shaderName, job.entryPoint);
+		}
+	}
+
+	if (numFailed > 0)
+	{
+		VAST_LOG_ERROR("{} shaders failed to compile, no archive written.", numFailed);
+		return EXIT_FAILURE;
+	}
+
+	if (!writer.Write(outputPath))
+	{
+		VAST_LOG_ERROR("Failed to write shader archive '{}'.", outputPath);
+		return EXIT_FAILURE;
+	}
+
+	VAST_LOG_INFO("Wrote {} shaders to '{}'.", writer.GetNumShaders(), outputPath);
+	VAST_LOGGING_ONLY(Log::Stop());
+	return EXIT_SUCCESS;
+}
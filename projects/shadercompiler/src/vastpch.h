@@ -0,0 +1,6 @@
+#pragma once
+
+// Note: The tool uses its own precompiled header so that engine sources built into it don't pull
+// in application/windowing headers (e.g. Core/App.h). Since this folder comes first in the include
+// directories, it also replaces the engine's vastpch.h for those sources.
+#include "Core/Core.h"
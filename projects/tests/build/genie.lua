@@ -0,0 +1,51 @@
+PROJ_DIR = path.getabsolute("../")
+
+-- Note: Headless tests and benchmarks for device-agnostic engine code. Like the shadercompiler,
+-- only the engine sources under test are built into the project (instead of linking against vast),
+-- so that it also builds and runs on Linux.
+project "tests"
+	kind "ConsoleApp"
+	language "C++"
+	
+	AddLibrary(spdlog)
+	AddLibrary(hlslpp)
+	
+	files
+	{
+		path.join(PROJ_DIR, "src/**.h"),
+		path.join(PROJ_DIR, "src/**.cpp"),
+		path.join(ROOT_DIR, "src/Core/Filesystem.cpp"),
+		path.join(ROOT_DIR, "src/Core/Log.cpp"),
+		path.join(ROOT_DIR, "src/Core/ThreadPool.cpp"),
+		path.join(ROOT_DIR, "src/Core/Tracing.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/DisplayList.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/DrawQueue.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/QueueScheduler.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/RenderGraph.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/Resources.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/ShaderCache.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/ShaderFileCache.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/ShaderPermutation.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/ShaderReflection.cpp"),
+		path.join(ROOT_DIR, "src/Graphics/ShaderResourceProxy.cpp"),
+	}
+	
+	includedirs
+	{
+		path.join(PROJ_DIR, "src"),
+		path.join(ROOT_DIR, "src"),
+		path.join(ROOT_DIR, "vendor"),
+	}
+	
+	configuration "linux"
+		links { "pthread" }
+	
+	configuration "Debug"
+		links { "minitrace" }
+		defines { "MTR_ENABLED" }
+		targetdir 	(path.join(PROJ_DIR, "build/bin/Debug/"))
+		objdir 		(path.join(PROJ_DIR, "build/obj/Debug/"))
+		
+	configuration "Release"
+		targetdir 	(path.join(PROJ_DIR, "build/bin/Release/"))
+		objdir 		(path.join(PROJ_DIR, "build/obj/Release/"))
@@ -0,0 +1,162 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/DisplayList.h"
+
+using namespace vast;
+
+static constexpr uint32 NUM_BENCHMARK_DRAWS = 100000;
+
+// Records the commands of a typical mesh draw, returning the number of commands recorded.
+static uint32 RecordMeshDraw(DisplayList& dl, BufferHandle vtxBuf, BufferHandle idxBuf, uint32 drawIdx)
+{
+	const uint32 pushConstants[4] = { drawIdx, drawIdx + 1, drawIdx + 2, drawIdx + 3 };
+	dl.BindVertexBuffer(vtxBuf);
+	dl.BindIndexBuffer(idxBuf);
+	dl.SetPushConstants(pushConstants, sizeof(pushConstants));
+	dl.DrawIndexed(36, drawIdx);
+	return 4;
+}
+
+VAST_TEST(DisplayList_RecordAndIterate)
+{
+	HandlePool<Buffer, 4> bufferPool;
+	const BufferHandle vtxBuf = bufferPool.AllocHandle();
+	const BufferHandle idxBuf = bufferPool.AllocHandle();
+
+	DisplayList dl;
+	VAST_CHECK(dl.IsEmpty());
+	const uint32 numCommands = RecordMeshDraw(dl, vtxBuf, idxBuf, 7);
+	dl.Dispatch(uint3(1, 2, 3));
+	VAST_CHECK(dl.GetNumCommands() == numCommands + 1);
+	VAST_CHECK(!dl.HasOverflowed());
+
+	Vector<DisplayListCmdType> types;
+	uint32 offset = 0;
+	dl.ForEachCommand([&](const DisplayListCmd& cmd)
+	{
+		VAST_CHECK(cmd.size % DISPLAY_LIST_CMD_ALIGNMENT == 0);
+		VAST_CHECK(reinterpret_cast<uintptr_t>(&cmd) % DISPLAY_LIST_CMD_ALIGNMENT == 0);
+		offset += cmd.size;
+		types.push_back(cmd.type);
+
+		switch (cmd.type)
+		{
+		case DisplayListCmdType::BIND_VERTEX_BUFFER:
+			VAST_CHECK(static_cast<const DisplayListCmds::BindVertexBuffer&>(cmd).h == vtxBuf);
+			break;
+		case DisplayListCmdType::BIND_INDEX_BUFFER:
+			VAST_CHECK(static_cast<const DisplayListCmds::BindIndexBuffer&>(cmd).h == idxBuf);
+			break;
+		case DisplayListCmdType::SET_PUSH_CONSTANTS:
+		{
+			const auto& c = static_cast<const DisplayListCmds::SetPushConstants&>(cmd);
+			VAST_CHECK(c.dataSize == 4 * sizeof(uint32));
+			VAST_CHECK(reinterpret_cast<const uint32*>(c.GetData())[3] == 10);
+			break;
+		}
+		case DisplayListCmdType::DRAW_INDEXED_INSTANCED:
+		{
+			const auto& c = static_cast<const DisplayListCmds::DrawIndexedInstanced&>(cmd);
+			VAST_CHECK(c.idxCountPerInst == 36 && c.instCount == 1 && c.startIdxLocation == 7);
+			break;
+		}
+		case DisplayListCmdType::DISPATCH:
+		{
+			const auto& c = static_cast<const DisplayListCmds::Dispatch&>(cmd);
+			VAST_CHECK(c.threadGroupCount[0] == 1 && c.threadGroupCount[1] == 2 && c.threadGroupCount[2] == 3);
+			break;
+		}
+		default:
+			VAST_CHECK(false);
+		}
+	});
+	VAST_CHECK(offset == dl.GetUsedBytes());
+	VAST_CHECK(types.size() == dl.GetNumCommands());
+	VAST_CHECK(types.front() == DisplayListCmdType::BIND_VERTEX_BUFFER && types.back() == DisplayListCmdType::DISPATCH);
+
+	dl.Reset();
+	VAST_CHECK(dl.IsEmpty() && dl.GetUsedBytes() == 0);
+}
+
+VAST_TEST(DisplayList_IterateRange)
+{
+	HandlePool<Buffer, 4> bufferPool;
+	const BufferHandle vtxBuf = bufferPool.AllocHandle();
+	const BufferHandle idxBuf = bufferPool.AllocHandle();
+
+	DisplayList dl;
+	RecordMeshDraw(dl, vtxBuf, idxBuf, 0);
+	const uint32 rangeBegin = dl.GetUsedBytes();
+	RecordMeshDraw(dl, vtxBuf, idxBuf, 1);
+	const uint32 rangeEnd = dl.GetUsedBytes();
+	RecordMeshDraw(dl, vtxBuf, idxBuf, 2);
+
+	uint32 numCommands = 0;
+	dl.ForEachCommand(rangeBegin, rangeEnd, [&](const DisplayListCmd& cmd)
+	{
+		if (cmd.type == DisplayListCmdType::DRAW_INDEXED_INSTANCED)
+		{
+			VAST_CHECK(static_cast<const DisplayListCmds::DrawIndexedInstanced&>(cmd).startIdxLocation == 1);
+		}
+		++numCommands;
+	});
+	VAST_CHECK(numCommands == 4);
+}
+
+VAST_BENCHMARK(DisplayList_Record)
+{
+	HandlePool<Buffer, 4> bufferPool;
+	const BufferHandle vtxBuf = bufferPool.AllocHandle();
+	const BufferHandle idxBuf = bufferPool.AllocHandle();
+
+	DisplayList dl(NUM_BENCHMARK_DRAWS * 128);
+	RunBenchmark("DisplayList record 100k draws (400k commands)", 20, [&]()
+	{
+		dl.Reset();
+		for (uint32 i = 0; i < NUM_BENCHMARK_DRAWS; ++i)
+		{
+			RecordMeshDraw(dl, vtxBuf, idxBuf, i);
+		}
+		g_BenchmarkSink = g_BenchmarkSink + dl.GetUsedBytes();
+	});
+}
+
+VAST_BENCHMARK(DisplayList_Iterate)
+{
+	HandlePool<Buffer, 4> bufferPool;
+	const BufferHandle vtxBuf = bufferPool.AllocHandle();
+	const BufferHandle idxBuf = bufferPool.AllocHandle();
+
+	DisplayList dl(NUM_BENCHMARK_DRAWS * 128);
+	for (uint32 i = 0; i < NUM_BENCHMARK_DRAWS; ++i)
+	{
+		RecordMeshDraw(dl, vtxBuf, idxBuf, i);
+	}
+
+	RunBenchmark("DisplayList iterate 100k draws (400k commands)", 20, [&]()
+	{
+		uint64 checksum = 0;
+		dl.ForEachCommand([&](const DisplayListCmd& cmd)
+		{
+			switch (cmd.type)
+			{
+			case DisplayListCmdType::BIND_VERTEX_BUFFER:
+				checksum += static_cast<const DisplayListCmds::BindVertexBuffer&>(cmd).h.GetIndex();
+				break;
+			case DisplayListCmdType::BIND_INDEX_BUFFER:
+				checksum += static_cast<const DisplayListCmds::BindIndexBuffer&>(cmd).h.GetIndex();
+				break;
+			case DisplayListCmdType::SET_PUSH_CONSTANTS:
+				checksum += static_cast<const DisplayListCmds::SetPushConstants&>(cmd).GetData()[0];
+				break;
+			case DisplayListCmdType::DRAW_INDEXED_INSTANCED:
+				checksum += static_cast<const DisplayListCmds::DrawIndexedInstanced&>(cmd).startIdxLocation;
+				break;
+			default:
+				break;
+			}
+		});
+		g_BenchmarkSink = g_BenchmarkSink + checksum;
+	});
+}
@@ -0,0 +1,113 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/DrawQueue.h"
+
+#include <random>
+
+using namespace vast;
+
+static constexpr uint32 NUM_BENCHMARK_DRAWS = 1000000;
+
+static uint64 MakeRandomDrawSortKey(std::mt19937& rng, PipelineHandle pipeline)
+{
+	const uint8 pass = static_cast<uint8>(rng() % 4);
+	const uint32 material = rng() % 1024;
+	const float depth = float(rng() % 10000) / 10000.0f;
+	return MakeDrawSortKey(pass, pipeline, material, depth);
+}
+
+VAST_TEST(DrawQueue_SortsByKey)
+{
+	HandlePool<Pipeline, 16> pipelinePool;
+	Vector<PipelineHandle> pipelines;
+	for (uint32 i = 0; i < 8; ++i)
+	{
+		pipelines.push_back(pipelinePool.AllocHandle());
+	}
+
+	std::mt19937 rng(42);
+	DrawQueue dq(1024 * 1024);
+	for (uint32 i = 0; i < 4096; ++i)
+	{
+		const PipelineHandle pipeline = pipelines[rng() % pipelines.size()];
+		DisplayList& dl = dq.BeginDraw(MakeRandomDrawSortKey(rng, pipeline));
+		dl.BindPipeline(pipeline);
+		dl.DrawIndexed(36, i);
+		dq.EndDraw();
+	}
+	VAST_CHECK(!dq.IsSorted());
+	dq.Sort();
+	VAST_CHECK(dq.IsSorted());
+	VAST_CHECK(dq.GetNumDraws() == 4096);
+
+	const Vector<DrawQueueItem>& items = dq.GetItems();
+	for (uint32 i = 1; i < items.size(); ++i)
+	{
+		VAST_CHECK(items[i - 1].key <= items[i].key);
+	}
+
+	// Draws of a pass are visited in order, and each pipeline is seen in a single contiguous run.
+	uint32 numDraws = 0, numPipelineSwitches = 0;
+	for (uint8 pass = 0; pass < 4; ++pass)
+	{
+		uint64 prevPipeline = UINT64_MAX;
+		dq.ForEachDraw(pass, [&](const DrawQueueItem& item)
+		{
+			VAST_CHECK(GetDrawSortKeyPass(item.key) == pass);
+			const uint64 pipeline = item.key >> DRAW_SORT_KEY_PIPELINE_SHIFT;
+			if (pipeline != prevPipeline)
+			{
+				++numPipelineSwitches;
+				prevPipeline = pipeline;
+			}
+			++numDraws;
+		});
+	}
+	VAST_CHECK(numDraws == dq.GetNumDraws());
+	VAST_CHECK(numPipelineSwitches <= 4 * pipelines.size());
+}
+
+VAST_TEST(DrawQueue_DepthOrder)
+{
+	HandlePool<Pipeline, 4> pipelinePool;
+	const PipelineHandle pipeline = pipelinePool.AllocHandle();
+
+	VAST_CHECK(MakeDrawSortKey(0, pipeline, 0, 0.25f) < MakeDrawSortKey(0, pipeline, 0, 0.75f));
+	VAST_CHECK(MakeDrawSortKey(0, pipeline, 0, 0.25f, true) > MakeDrawSortKey(0, pipeline, 0, 0.75f, true));
+	// Depth only breaks ties between draws sharing pass, pipeline and material.
+	VAST_CHECK(MakeDrawSortKey(0, pipeline, 1, 0.0f) > MakeDrawSortKey(0, pipeline, 0, 1.0f));
+	VAST_CHECK(MakeDrawSortKey(1, pipeline, 0, 0.0f) > MakeDrawSortKey(0, pipeline, 1, 1.0f));
+	VAST_CHECK(GetDrawSortKeyPass(MakeDrawSortKey(200, pipeline, 0, 0.5f)) == 200);
+}
+
+VAST_BENCHMARK(DrawQueue_Sort)
+{
+	HandlePool<Pipeline, 64> pipelinePool;
+	Vector<PipelineHandle> pipelines;
+	for (uint32 i = 0; i < 64; ++i)
+	{
+		pipelines.push_back(pipelinePool.AllocHandle());
+	}
+
+	std::mt19937 rng(42);
+	Vector<uint64> keys(NUM_BENCHMARK_DRAWS);
+	for (auto& key : keys)
+	{
+		key = MakeRandomDrawSortKey(rng, pipelines[rng() % pipelines.size()]);
+	}
+
+	// Note: Draws have no commands, so this mostly measures the sort, plus pushing the items.
+	DrawQueue dq;
+	RunBenchmark("DrawQueue record and sort 1M draws", 10, [&]()
+	{
+		dq.Reset();
+		for (uint64 key : keys)
+		{
+			dq.BeginDraw(key);
+			dq.EndDraw();
+		}
+		dq.Sort();
+		g_BenchmarkSink = g_BenchmarkSink + dq.GetItems().back().key;
+	});
+}
@@ -0,0 +1,113 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/GraphicsTypes.h"
+#include "Graphics/LocalResourceStates.h"
+
+using namespace vast;
+
+struct TestResource
+{
+	ResourceState state = ResourceState::NONE;
+};
+
+using TestLocalState = LocalResourceState<TestResource, ResourceState>;
+using TestTransition = LocalResourceTransition<TestResource, ResourceState>;
+
+static const TestTransition* FindTransition(const Vector<TestTransition>& transitions, const TestResource& r)
+{
+	for (const auto& t : transitions)
+	{
+		if (t.resource == &r)
+			return &t;
+	}
+	return nullptr;
+}
+
+static bool HasTransition(const Vector<TestTransition>& transitions, const TestResource& r, ResourceState before, ResourceState after)
+{
+	const TestTransition* t = FindTransition(transitions, r);
+	return t && t->before == before && t->after == after;
+}
+
+VAST_TEST(LocalResourceStates_ResolvedInSubmissionOrder)
+{
+	TestResource a, b, c;
+	a.state = ResourceState::PIXEL_SHADER_RESOURCE;
+
+	// Local states as recorded by 4 lists in parallel. Resources are first used by different lists,
+	// so every list but the first one depends on the states earlier lists leave resources in.
+	const Vector<TestLocalState> lists[] =
+	{
+		{ { &a, ResourceState::RENDER_TARGET, ResourceState::PIXEL_SHADER_RESOURCE } },
+		{ { &a, ResourceState::PIXEL_SHADER_RESOURCE, ResourceState::PIXEL_SHADER_RESOURCE }, { &b, ResourceState::RENDER_TARGET, ResourceState::RENDER_TARGET } },
+		{ { &b, ResourceState::PIXEL_SHADER_RESOURCE, ResourceState::PIXEL_SHADER_RESOURCE }, { &c, ResourceState::UNORDERED_ACCESS, ResourceState::UNORDERED_ACCESS } },
+		{ { &a, ResourceState::RENDER_TARGET, ResourceState::RENDER_TARGET }, { &c, ResourceState::NON_PIXEL_SHADER_RESOURCE, ResourceState::UNORDERED_ACCESS } },
+	};
+
+	Vector<TestTransition> transitions[NELEM(lists)];
+	for (uint32 i = 0; i < NELEM(lists); ++i)
+	{
+		ResolveLocalResourceStates(lists[i], transitions[i], ResourceState::UNORDERED_ACCESS);
+	}
+
+	VAST_CHECK(transitions[0].size() == 1);
+	VAST_CHECK(HasTransition(transitions[0], a, ResourceState::PIXEL_SHADER_RESOURCE, ResourceState::RENDER_TARGET));
+
+	// The first list leaves 'a' in the state the second one expects, so no transition is needed.
+	VAST_CHECK(transitions[1].size() == 1);
+	VAST_CHECK(!FindTransition(transitions[1], a));
+	VAST_CHECK(HasTransition(transitions[1], b, ResourceState::NONE, ResourceState::RENDER_TARGET));
+
+	VAST_CHECK(HasTransition(transitions[2], b, ResourceState::RENDER_TARGET, ResourceState::PIXEL_SHADER_RESOURCE));
+	VAST_CHECK(HasTransition(transitions[2], c, ResourceState::NONE, ResourceState::UNORDERED_ACCESS));
+	VAST_CHECK(!FindTransition(transitions[2], a));
+
+	VAST_CHECK(HasTransition(transitions[3], a, ResourceState::PIXEL_SHADER_RESOURCE, ResourceState::RENDER_TARGET));
+	VAST_CHECK(HasTransition(transitions[3], c, ResourceState::UNORDERED_ACCESS, ResourceState::NON_PIXEL_SHADER_RESOURCE));
+
+	// Global states end up in the state the last list using each resource leaves it in.
+	VAST_CHECK(a.state == ResourceState::RENDER_TARGET);
+	VAST_CHECK(b.state == ResourceState::PIXEL_SHADER_RESOURCE);
+	VAST_CHECK(c.state == ResourceState::UNORDERED_ACCESS);
+}
+
+VAST_TEST(LocalResourceStates_UnusedResourcesUntouched)
+{
+	TestResource a, b;
+	b.state = ResourceState::DEPTH_WRITE;
+
+	const Vector<TestLocalState> list = { { &a, ResourceState::UNORDERED_ACCESS, ResourceState::NON_PIXEL_SHADER_RESOURCE } };
+	Vector<TestTransition> transitions;
+	ResolveLocalResourceStates(list, transitions, ResourceState::UNORDERED_ACCESS);
+
+	VAST_CHECK(transitions.size() == 1);
+	VAST_CHECK(HasTransition(transitions, a, ResourceState::NONE, ResourceState::UNORDERED_ACCESS));
+	VAST_CHECK(a.state == ResourceState::NON_PIXEL_SHADER_RESOURCE);
+	VAST_CHECK(b.state == ResourceState::DEPTH_WRITE);
+}
+
+VAST_TEST(LocalResourceStates_NoOpTransitionsDropped)
+{
+	TestResource a, b, c;
+	a.state = ResourceState::PIXEL_SHADER_RESOURCE;
+	b.state = ResourceState::UNORDERED_ACCESS;
+	c.state = ResourceState::DEPTH_WRITE;
+
+	const Vector<TestLocalState> list =
+	{
+		{ &a, ResourceState::PIXEL_SHADER_RESOURCE, ResourceState::RENDER_TARGET },
+		{ &b, ResourceState::UNORDERED_ACCESS, ResourceState::UNORDERED_ACCESS },
+		{ &c, ResourceState::DEPTH_WRITE, ResourceState::DEPTH_WRITE },
+	};
+	Vector<TestTransition> transitions;
+	ResolveLocalResourceStates(list, transitions, ResourceState::UNORDERED_ACCESS);
+
+	// Resources already in the expected state need no transition, but unordered accesses across
+	// lists must still be separated by a UAV barrier.
+	VAST_CHECK(transitions.size() == 1);
+	VAST_CHECK(HasTransition(transitions, b, ResourceState::UNORDERED_ACCESS, ResourceState::UNORDERED_ACCESS));
+	VAST_CHECK(a.state == ResourceState::RENDER_TARGET);
+	VAST_CHECK(b.state == ResourceState::UNORDERED_ACCESS);
+	VAST_CHECK(c.state == ResourceState::DEPTH_WRITE);
+}
@@ -0,0 +1,84 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include <cstring>
+
+using namespace vast;
+
+struct TestCase
+{
+	const char* name;
+	TestFn fn;
+	bool bIsBenchmark;
+};
+
+// Note: Function local so that test cases can be registered during static initialization of any
+// translation unit.
+static Vector<TestCase>& GetTestCases()
+{
+	static Vector<TestCase> s_TestCases;
+	return s_TestCases;
+}
+
+static uint32 s_NumFailedChecks = 0;
+
+namespace vast
+{
+	volatile uint64 g_BenchmarkSink = 0;
+
+	bool RegisterTestCase(const char* name, TestFn fn, bool bIsBenchmark)
+	{
+		GetTestCases().push_back(TestCase{ name, fn, bIsBenchmark });
+		return true;
+	}
+
+	void ReportCheckFailed(const char* expr, const char* file, int line)
+	{
+		VAST_LOG_ERROR("[test] Check '{}' FAILED ({}, line {}).", expr, file, line);
+		++s_NumFailedChecks;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::Init();
+
+	bool bRunBenchmarks = false;
+	const char* filter = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--bench") == 0)
+		{
+			bRunBenchmarks = true;
+		}
+		else
+		{
+			filter = argv[i];
+		}
+	}
+
+	uint32 numRun = 0, numFailed = 0;
+	for (const auto& tc : GetTestCases())
+	{
+		if (tc.bIsBenchmark != bRunBenchmarks || (filter && !strstr(tc.name, filter)))
+			continue;
+
+		const uint32 numFailedChecks = s_NumFailedChecks;
+		tc.fn();
+		++numRun;
+
+		if (s_NumFailedChecks != numFailedChecks)
+		{
+			VAST_LOG_ERROR("[test] {} FAILED", tc.name);
+			++numFailed;
+		}
+		else if (!bRunBenchmarks)
+		{
+			VAST_LOG_INFO("[test] {} passed", tc.name);
+		}
+	}
+
+	VAST_LOG_INFO("[test] {} of {} {} passed.", numRun - numFailed, numRun, bRunBenchmarks ? "benchmarks" : "tests");
+	Log::Stop();
+	return numFailed ? 1 : 0;
+}
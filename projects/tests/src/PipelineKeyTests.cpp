@@ -0,0 +1,116 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/Resources.h"
+
+using namespace vast;
+
+static PipelineDesc MakeTestPipelineDesc()
+{
+	PipelineDesc desc;
+	desc.vs = AllocVertexShaderDesc("Cube.hlsl");
+	desc.ps = AllocPixelShaderDesc("Cube.hlsl");
+	desc.depthStencilState = DepthStencilState::Preset::kEnabled;
+	desc.renderPassLayout = { { TexFormat::RGBA8_UNORM }, TexFormat::D32_FLOAT };
+	return desc;
+}
+
+VAST_TEST(PipelineKey_EquivalentDescsCollide)
+{
+	const PipelineDesc base = MakeTestPipelineDesc();
+	const PipelineKey key = MakePipelineKey(base);
+	VAST_CHECK(key == MakePipelineKey(MakeTestPipelineDesc()));
+
+	// State that doesn't affect the created pipeline is ignored.
+	PipelineDesc desc = base;
+	desc.depthStencilState = DepthStencilState{ false, false, CompareFunc::NONE };
+	PipelineDesc equivalent = base;
+	equivalent.depthStencilState = DepthStencilState{ false, true, CompareFunc::GREATER };
+	VAST_CHECK(MakePipelineKey(desc) == MakePipelineKey(equivalent));
+
+	desc = base;
+	desc.blendStates[0].srcBlend = Blend::ONE;
+	desc.blendStates[1] = BlendState::Preset::kAdditive;
+	VAST_CHECK(MakePipelineKey(desc) == key);
+
+	// Formats after the first unused render target slot are never bound.
+	desc = base;
+	desc.renderPassLayout.rtFormats[2] = TexFormat::RGBA8_UNORM;
+	VAST_CHECK(MakePipelineKey(desc) == key);
+
+	// Shaders are identified by name and entry point, regardless of the path they are loaded from.
+	desc = base;
+	desc.vs.filePath = "other/path/";
+	desc.vs.shaderName = "CUBE.hlsl";
+	VAST_CHECK(MakePipelineKey(desc) == key);
+
+	const PipelineDesc c = CanonicalizePipelineDesc(equivalent);
+	VAST_CHECK(!c.depthStencilState.depthWrite && c.depthStencilState.depthFunc == CompareFunc::NONE);
+	VAST_CHECK(MakePipelineKey(c) == MakePipelineKey(equivalent));
+}
+
+VAST_TEST(PipelineKey_DifferentDescsDontCollide)
+{
+	const PipelineDesc base = MakeTestPipelineDesc();
+	Vector<PipelineKey> keys = { MakePipelineKey(base) };
+
+	PipelineDesc desc = base;
+	desc.ps = AllocPixelShaderDesc("Cube.hlsl", VAST_SHADERS_SOURCE_PATH, "PS_Other");
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.ps.permutationDomain = ShaderPermutationDomain{ { "USE_TEXTURE" } };
+	desc.ps.permutation = desc.ps.permutationDomain.Set(0, "USE_TEXTURE", 1);
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.ps = ShaderDesc{};
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.blendStates[0] = BlendState::Preset::kAdditive;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.blendStates[0].writeMask = ColorWrite::RED;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.depthStencilState = DepthStencilState::Preset::kEnabledReadOnly;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.depthStencilState = DepthStencilState::Preset::kDisabled;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.rasterizerState.cullMode = CullMode::BACK;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.rasterizerState.fillMode = FillMode::WIREFRAME;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.renderPassLayout.rtFormats[0] = TexFormat::RGBA8_UNORM_SRGB;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.renderPassLayout.rtFormats[1] = TexFormat::RGBA8_UNORM;
+	keys.push_back(MakePipelineKey(desc));
+
+	desc = base;
+	desc.renderPassLayout.dsFormat = TexFormat::UNKNOWN;
+	keys.push_back(MakePipelineKey(desc));
+
+	// Compute pipelines never collide with graphics pipelines using the same shader file.
+	keys.push_back(MakePipelineKey(AllocComputeShaderDesc("Cube.hlsl")));
+
+	for (uint32 i = 0; i < keys.size(); ++i)
+	{
+		for (uint32 j = i + 1; j < keys.size(); ++j)
+		{
+			VAST_CHECK(keys[i] != keys[j]);
+		}
+	}
+}
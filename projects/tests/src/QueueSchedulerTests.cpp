@@ -0,0 +1,76 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/QueueScheduler.h"
+
+using namespace vast;
+
+VAST_TEST(QueueScheduler_ElidesSatisfiedWaits)
+{
+	QueueScheduler qs;
+	qs.BeginFrame();
+
+	// Compute waits on upload, then graphics waits on compute: graphics has transitively waited on
+	// upload as well.
+	qs.OnExecute(QueueType::UPLOAD);
+	qs.OnSignal(QueueType::UPLOAD, 1);
+	VAST_CHECK(qs.RequestWait(QueueType::COMPUTE, QueueSyncPoint{ QueueType::UPLOAD, 1 }));
+	qs.OnExecute(QueueType::COMPUTE);
+	qs.OnSignal(QueueType::COMPUTE, 1);
+	VAST_CHECK(qs.RequestWait(QueueType::GRAPHICS, QueueSyncPoint{ QueueType::COMPUTE, 1 }));
+
+	VAST_CHECK(!qs.RequestWait(QueueType::GRAPHICS, QueueSyncPoint{ QueueType::COMPUTE, 1 }));
+	VAST_CHECK(!qs.RequestWait(QueueType::GRAPHICS, QueueSyncPoint{ QueueType::UPLOAD, 1 }));
+	VAST_CHECK(qs.GetNumElidedWaits() == 2);
+	VAST_CHECK(qs.GetKnownValue(QueueType::GRAPHICS, QueueType::UPLOAD) == 1);
+
+	// A later upload signal wasn't covered by any wait.
+	qs.OnSignal(QueueType::UPLOAD, 2);
+	VAST_CHECK(qs.RequestWait(QueueType::GRAPHICS, QueueSyncPoint{ QueueType::UPLOAD, 2 }));
+}
+
+VAST_TEST(QueueScheduler_SimulatesTimeline)
+{
+	QueueScheduler qs;
+	qs.BeginFrame();
+
+	// Graphics work that doesn't depend on compute overlaps with it, the rest waits for it.
+	qs.OnExecute(QueueType::COMPUTE, 4.0f);
+	qs.OnSignal(QueueType::COMPUTE, 1);
+	qs.OnExecute(QueueType::GRAPHICS, 1.0f);
+	qs.OnSignal(QueueType::GRAPHICS, 1);
+	VAST_CHECK(qs.RequestWait(QueueType::GRAPHICS, QueueSyncPoint{ QueueType::COMPUTE, 1 }));
+	qs.OnExecute(QueueType::GRAPHICS, 2.0f);
+	qs.OnSignal(QueueType::GRAPHICS, 2);
+
+	const QueueTimelineResult result = SimulateQueueTimeline(qs.GetFrameEvents(), qs.GetFrameStartValues());
+	VAST_CHECK(!result.bDeadlock);
+	VAST_CHECK(result.queueEndTime[IDX(QueueType::COMPUTE)] == 4.0f);
+	VAST_CHECK(result.queueEndTime[IDX(QueueType::GRAPHICS)] == 6.0f);
+	VAST_CHECK(result.queueStallTime[IDX(QueueType::GRAPHICS)] == 3.0f);
+}
+
+VAST_TEST(QueueScheduler_WaitsOnPreviousFrames)
+{
+	QueueScheduler qs;
+	qs.BeginFrame();
+	qs.OnExecute(QueueType::COMPUTE, 1.0f);
+	qs.OnSignal(QueueType::COMPUTE, 1);
+
+	// Next frame waits on a value signaled last frame, which was reached before the frame began.
+	qs.BeginFrame();
+	VAST_CHECK(qs.GetFrameStartValues()[IDX(QueueType::COMPUTE)] == 1);
+	VAST_CHECK(qs.RequestWait(QueueType::GRAPHICS, QueueSyncPoint{ QueueType::COMPUTE, 1 }));
+	qs.OnExecute(QueueType::GRAPHICS, 1.0f);
+	qs.OnSignal(QueueType::GRAPHICS, 1);
+
+	const QueueTimelineResult result = SimulateQueueTimeline(qs.GetFrameEvents(), qs.GetFrameStartValues());
+	VAST_CHECK(!result.bDeadlock);
+	VAST_CHECK(result.queueEndTime[IDX(QueueType::GRAPHICS)] == 1.0f);
+	VAST_CHECK(result.queueStallTime[IDX(QueueType::GRAPHICS)] == 0.0f);
+
+	// Waits on values that are never signaled still deadlock.
+	Vector<QueueEvent> events = qs.GetFrameEvents();
+	events.push_back(QueueEvent{ QueueEventType::WAIT, QueueType::UPLOAD, QueueSyncPoint{ QueueType::COMPUTE, 2 } });
+	VAST_CHECK(SimulateQueueTimeline(events, qs.GetFrameStartValues()).bDeadlock);
+}
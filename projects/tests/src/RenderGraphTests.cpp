@@ -0,0 +1,255 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/RenderGraph.h"
+
+using namespace vast;
+
+static const RGPass* FindPass(const RenderGraph& rg, const std::string& name)
+{
+	for (const auto& pass : rg.GetPasses())
+	{
+		if (pass.name == name)
+			return &pass;
+	}
+	return nullptr;
+}
+
+static const RGResource* FindResource(const RenderGraph& rg, const std::string& name)
+{
+	for (const auto& r : rg.GetResources())
+	{
+		if (r.name == name)
+			return &r;
+	}
+	return nullptr;
+}
+
+static const RGBarrier* FindBarrier(const RenderGraph& rg, const RGPass& pass, const std::string& resourceName)
+{
+	for (const auto& barrier : pass.barriers)
+	{
+		if (rg.GetResources()[barrier.resourceIdx].name == resourceName)
+			return &barrier;
+	}
+	return nullptr;
+}
+
+VAST_TEST(RenderGraph_CullsPassesWithUnusedOutputs)
+{
+	HandlePool<Texture, 4> texturePool;
+	const TextureHandle backBuffer = texturePool.AllocHandle();
+	const TextureDesc rtDesc = AllocRenderTargetDesc(TexFormat::RGBA8_UNORM, uint2(64, 64));
+
+	RenderGraph rg;
+	RGTextureHandle rgBackBuffer = rg.ImportTexture("BackBuffer", backBuffer, ResourceState::NONE);
+	RGTextureHandle unused, scene;
+
+	rg.AddPass("Unused", [&](RenderGraphBuilder& b) { unused = b.CreateTexture("UnusedRT", rtDesc); }, nullptr);
+	rg.AddPass("Scene", [&](RenderGraphBuilder& b) { scene = b.CreateTexture("SceneRT", rtDesc); }, nullptr);
+	// Only consumer of 'Unused', culled along with it.
+	rg.AddPass("ReadsUnused", [&](RenderGraphBuilder& b) { b.Read(unused); b.CreateTexture("UnusedRT2", rtDesc); }, nullptr);
+	rg.AddPass("Composite", [&](RenderGraphBuilder& b)
+	{
+		b.Read(scene);
+		rgBackBuffer = b.Write(rgBackBuffer);
+	}, nullptr);
+	// Not consumed, but kept because of its side effects.
+	rg.AddPass("Debug", [&](RenderGraphBuilder& b) { b.CreateTexture("DebugRT", rtDesc); b.SetSideEffects(); }, nullptr);
+	rg.Compile();
+
+	VAST_CHECK(FindPass(rg, "Unused")->bCulled);
+	VAST_CHECK(FindPass(rg, "ReadsUnused")->bCulled);
+	VAST_CHECK(!FindPass(rg, "Scene")->bCulled);
+	VAST_CHECK(!FindPass(rg, "Composite")->bCulled);
+	VAST_CHECK(!FindPass(rg, "Debug")->bCulled);
+	VAST_CHECK(rg.GetStats().numCulledPasses == 2);
+	VAST_CHECK(rg.GetExecutionOrder().size() == 3);
+
+	// Culled resources take no memory.
+	for (const auto& r : rg.GetResources())
+	{
+		VAST_CHECK(r.IsUsed() == (r.name != "UnusedRT" && r.name != "UnusedRT2"));
+	}
+}
+
+VAST_TEST(RenderGraph_WriteKeepsProducerOfPreviousVersion)
+{
+	HandlePool<Texture, 4> texturePool;
+	const TextureHandle backBuffer = texturePool.AllocHandle();
+	const TextureDesc rtDesc = AllocRenderTargetDesc(TexFormat::RGBA8_UNORM, uint2(64, 64));
+
+	// 'Accumulate' loads the contents 'Clear' created, so 'Clear' is kept even though nothing reads
+	// the version it produced.
+	RenderGraph rg;
+	RGTextureHandle rgBackBuffer = rg.ImportTexture("BackBuffer", backBuffer, ResourceState::NONE);
+	RGTextureHandle accum;
+	rg.AddPass("Clear", [&](RenderGraphBuilder& b) { accum = b.CreateTexture("AccumRT", rtDesc); }, nullptr);
+	rg.AddPass("Accumulate", [&](RenderGraphBuilder& b) { accum = b.Write(accum); }, nullptr);
+	rg.AddPass("Resolve", [&](RenderGraphBuilder& b)
+	{
+		b.Read(accum);
+		rgBackBuffer = b.Write(rgBackBuffer);
+	}, nullptr);
+	// Culled along with 'Clear2', which nothing but it depends on.
+	RGTextureHandle unused;
+	rg.AddPass("Clear2", [&](RenderGraphBuilder& b) { unused = b.CreateTexture("UnusedRT", rtDesc); }, nullptr);
+	rg.AddPass("Accumulate2", [&](RenderGraphBuilder& b) { unused = b.Write(unused); }, nullptr);
+	rg.Compile();
+
+	VAST_CHECK(!FindPass(rg, "Clear")->bCulled);
+	VAST_CHECK(!FindPass(rg, "Accumulate")->bCulled);
+	VAST_CHECK(!FindPass(rg, "Resolve")->bCulled);
+	VAST_CHECK(FindPass(rg, "Clear2")->bCulled);
+	VAST_CHECK(FindPass(rg, "Accumulate2")->bCulled);
+	VAST_CHECK(rg.GetStats().numCulledPasses == 2);
+
+	// Only the pass creating the texture discards it, the one writing over it keeps its contents.
+	const RGBarrier* accumBarrier = FindBarrier(rg, *FindPass(rg, "Accumulate"), "AccumRT");
+	VAST_CHECK(!accumBarrier || (!accumBarrier->bAliasing && !accumBarrier->bDiscard));
+}
+
+VAST_TEST(RenderGraph_AliasesTransientsWithDisjointLifetimes)
+{
+	HandlePool<Texture, 4> texturePool;
+	const TextureHandle backBuffer = texturePool.AllocHandle();
+	const TextureDesc rtDesc = AllocRenderTargetDesc(TexFormat::RGBA8_UNORM, uint2(256, 256));
+	const TextureDesc dsDesc = AllocDepthStencilTargetDesc(TexFormat::D32_FLOAT, uint2(256, 256));
+	BufferDesc bufDesc;
+	bufDesc.size = 256 * 256 * 4;
+	bufDesc.viewFlags = BufViewFlags::UAV;
+
+	// A -> B -> C -> D, where each resource is only read by the next pass: A and C, as well as B and
+	// D, have disjoint lifetimes and can share memory.
+	RenderGraph rg;
+	RGTextureHandle rgBackBuffer = rg.ImportTexture("BackBuffer", backBuffer, ResourceState::NONE);
+	RGTextureHandle a, b, d;
+	RGBufferHandle c;
+	rg.AddPass("PassA", [&](RenderGraphBuilder& builder) { a = builder.CreateTexture("A", rtDesc); }, nullptr);
+	rg.AddPass("PassB", [&](RenderGraphBuilder& builder) { builder.Read(a); b = builder.CreateTexture("B", dsDesc); }, nullptr);
+	rg.AddPass("PassC", [&](RenderGraphBuilder& builder) { builder.Read(b); c = builder.CreateBuffer("C", bufDesc); }, nullptr);
+	rg.AddPass("PassD", [&](RenderGraphBuilder& builder) { builder.Read(c); d = builder.CreateTexture("D", rtDesc); }, nullptr);
+	rg.AddPass("Present", [&](RenderGraphBuilder& builder)
+	{
+		builder.Read(d);
+		rgBackBuffer = builder.Write(rgBackBuffer);
+	}, nullptr);
+	rg.Compile();
+
+	const RenderGraphStats& stats = rg.GetStats();
+	VAST_CHECK(stats.numCulledPasses == 0);
+	VAST_CHECK(stats.numTransientResources == 4);
+	VAST_CHECK(stats.transientHeapSize < stats.transientUnaliasedSize);
+
+	const Vector<RGResource>& resources = rg.GetResources();
+	for (uint32 i = 0; i < resources.size(); ++i)
+	{
+		for (uint32 j = i + 1; j < resources.size(); ++j)
+		{
+			const RGResource& r0 = resources[i];
+			const RGResource& r1 = resources[j];
+			if (!r0.IsTransient() || !r1.IsTransient())
+				continue;
+
+			const bool bLifetimesOverlap = r0.firstUse <= r1.lastUse && r1.firstUse <= r0.lastUse;
+			const bool bMemoryOverlaps = r0.heapOffset < r1.heapOffset + r1.allocInfo.size && r1.heapOffset < r0.heapOffset + r0.allocInfo.size;
+			VAST_CHECK(!(bLifetimesOverlap && bMemoryOverlaps));
+		}
+	}
+
+	// Every aliased resource is activated with an aliasing barrier on first use, and render/depth
+	// targets are also discarded.
+	const std::pair<const char*, const char*> passOutputs[] = { { "PassA", "A" }, { "PassB", "B" }, { "PassC", "C" }, { "PassD", "D" } };
+	for (const auto& [passName, resourceName] : passOutputs)
+	{
+		const RGResource* created = FindResource(rg, resourceName);
+		const RGBarrier* barrier = FindBarrier(rg, *FindPass(rg, passName), resourceName);
+		if (created->bAliased)
+		{
+			VAST_CHECK(barrier && barrier->bAliasing);
+			VAST_CHECK(barrier && barrier->bDiscard == (created->type == RGResourceType::TEXTURE));
+		}
+		else
+		{
+			VAST_CHECK(!barrier || (!barrier->bAliasing && !barrier->bDiscard));
+		}
+	}
+	VAST_CHECK(FindResource(rg, "A")->bAliased && FindResource(rg, "B")->bAliased);
+}
+
+VAST_TEST(RenderGraph_SeparateHeapsPerResourceKind)
+{
+	HandlePool<Texture, 4> texturePool;
+	const TextureHandle backBuffer = texturePool.AllocHandle();
+	const TextureDesc rtDesc = AllocRenderTargetDesc(TexFormat::RGBA8_UNORM, uint2(256, 256));
+	TextureDesc srvDesc = rtDesc;
+	srvDesc.viewFlags = TexViewFlags::SRV | TexViewFlags::UAV;
+	BufferDesc bufDesc;
+	bufDesc.size = 256 * 256 * 4;
+	bufDesc.viewFlags = BufViewFlags::UAV;
+
+	// Same chain of disjoint lifetimes as above, but on a device that can't mix kinds of resources
+	// in a heap, so only resources of the same kind may alias.
+	RenderGraph rg;
+	RenderGraphMemoryQuery query;
+	query.buffer = [](const BufferDesc& desc) { return EstimateAllocationInfo(desc); };
+	query.texture = [](const TextureDesc& desc) { return EstimateAllocationInfo(desc); };
+	query.bSupportsMixedHeaps = false;
+	rg.SetMemoryQuery(query);
+
+	RGTextureHandle rgBackBuffer = rg.ImportTexture("BackBuffer", backBuffer, ResourceState::NONE);
+	RGTextureHandle a, b, d;
+	RGBufferHandle c;
+	rg.AddPass("PassA", [&](RenderGraphBuilder& builder) { a = builder.CreateTexture("A", rtDesc); }, nullptr);
+	rg.AddPass("PassB", [&](RenderGraphBuilder& builder) { builder.Read(a); b = builder.CreateTexture("B", srvDesc); }, nullptr);
+	rg.AddPass("PassC", [&](RenderGraphBuilder& builder) { builder.Read(b); c = builder.CreateBuffer("C", bufDesc); }, nullptr);
+	rg.AddPass("PassD", [&](RenderGraphBuilder& builder) { builder.Read(c); d = builder.CreateTexture("D", rtDesc); }, nullptr);
+	rg.AddPass("Present", [&](RenderGraphBuilder& builder)
+	{
+		builder.Read(d);
+		rgBackBuffer = builder.Write(rgBackBuffer);
+	}, nullptr);
+	rg.Compile();
+
+	VAST_CHECK(FindResource(rg, "A")->heapType == MemoryHeapType::RT_DS_TEXTURES);
+	VAST_CHECK(FindResource(rg, "B")->heapType == MemoryHeapType::NON_RT_DS_TEXTURES);
+	VAST_CHECK(FindResource(rg, "C")->heapType == MemoryHeapType::BUFFERS);
+	VAST_CHECK(FindResource(rg, "D")->heapType == MemoryHeapType::RT_DS_TEXTURES);
+
+	// A and D alias each other, while B and C have a heap to themselves.
+	VAST_CHECK(FindResource(rg, "A")->bAliased && FindResource(rg, "D")->bAliased);
+	VAST_CHECK(!FindResource(rg, "B")->bAliased && !FindResource(rg, "C")->bAliased);
+
+	const RenderGraphStats& stats = rg.GetStats();
+	VAST_CHECK(stats.transientHeapSizes[IDX(MemoryHeapType::MIXED)] == 0);
+	VAST_CHECK(stats.transientHeapSizes[IDX(MemoryHeapType::RT_DS_TEXTURES)] == FindResource(rg, "A")->allocInfo.size);
+	VAST_CHECK(stats.transientHeapSizes[IDX(MemoryHeapType::NON_RT_DS_TEXTURES)] == FindResource(rg, "B")->allocInfo.size);
+	VAST_CHECK(stats.transientHeapSizes[IDX(MemoryHeapType::BUFFERS)] == FindResource(rg, "C")->allocInfo.size);
+	VAST_CHECK(stats.transientHeapSize < stats.transientUnaliasedSize);
+}
+
+VAST_TEST(RenderGraph_ImportedResourceBarriers)
+{
+	HandlePool<Texture, 4> texturePool;
+	const TextureHandle inTex = texturePool.AllocHandle();
+	const TextureHandle outTex = texturePool.AllocHandle();
+
+	// Imported resources already in the requested state need no barrier, otherwise they get one
+	// from the imported state.
+	RenderGraph rg;
+	RGTextureHandle rgIn = rg.ImportTexture("In", inTex, ResourceState::PIXEL_SHADER_RESOURCE);
+	RGTextureHandle rgOut = rg.ImportTexture("Out", outTex, ResourceState::PIXEL_SHADER_RESOURCE);
+	rg.AddPass("Blit", [&](RenderGraphBuilder& b)
+	{
+		b.Read(rgIn);
+		rgOut = b.Write(rgOut);
+	}, nullptr);
+	rg.Compile();
+
+	const RGPass* pass = FindPass(rg, "Blit");
+	VAST_CHECK(pass->barriers.size() == 1);
+	VAST_CHECK(!FindBarrier(rg, *pass, "In"));
+	const RGBarrier* outBarrier = FindBarrier(rg, *pass, "Out");
+	VAST_CHECK(outBarrier && outBarrier->before == ResourceState::PIXEL_SHADER_RESOURCE && outBarrier->after == ResourceState::RENDER_TARGET);
+	VAST_CHECK(outBarrier && !outBarrier->bAliasing && !outBarrier->bDiscard);
+}
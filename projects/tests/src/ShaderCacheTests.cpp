@@ -0,0 +1,102 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Core/Filesystem.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/ShaderFileCache.h"
+
+#include <filesystem>
+
+using namespace vast;
+
+// Creates an empty directory for the test under the system's temporary directory.
+static std::filesystem::path MakeTestDirectory(const char* name)
+{
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "vast_tests" / name;
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+	return dir;
+}
+
+static void WriteTextFile(const std::filesystem::path& path, const std::string& text)
+{
+	std::filesystem::create_directories(path.parent_path());
+	Filesystem::WriteFile(path.string(), text.data(), text.size());
+}
+
+// Writes a shader and the header it includes from an include directory under 'root'.
+static void WriteTestShader(const std::filesystem::path& root, const std::string& headerText)
+{
+	WriteTextFile(root / "shaders" / "test.hlsl", "#include \"common.hlsli\"\nfloat4 main() : SV_Target { return Color(); }\n");
+	WriteTextFile(root / "include" / "common.hlsli", headerText);
+}
+
+static Vector<std::wstring> MakeCompilerArgs(const std::filesystem::path& root, const wchar_t* define)
+{
+	return { L"test.hlsl", L"-E", L"main", L"-T", L"ps_6_6", L"-I", (root / "include").wstring(), L"-D", define };
+}
+
+static uint64 ComputeTestShaderKey(const std::filesystem::path& root, const wchar_t* define = L"FOO=1")
+{
+	ShaderFileCache fileCache;
+	const Vector<std::wstring> includeDirs = { (root / "include").wstring() };
+	uint64 key = 0;
+	VAST_CHECK(ComputeShaderCacheKey((root / "shaders" / "test.hlsl").string(), includeDirs, fileCache, MakeCompilerArgs(root, define), "dxc 1.0", key));
+	return key;
+}
+
+VAST_TEST(ShaderCache_KeyInvalidation)
+{
+	const std::filesystem::path dir = MakeTestDirectory("ShaderCache_KeyInvalidation");
+	const std::string header = "float4 Color() { return 1; }\n";
+
+	// Identical projects in different locations share keys, despite include directories being
+	// passed to the compiler as absolute paths.
+	WriteTestShader(dir / "checkout0", header);
+	WriteTestShader(dir / "checkout1", header);
+	const uint64 key = ComputeTestShaderKey(dir / "checkout0");
+	VAST_CHECK(key == ComputeTestShaderKey(dir / "checkout1"));
+
+	// Anything affecting the output changes the key: defines and the contents of included files.
+	VAST_CHECK(key != ComputeTestShaderKey(dir / "checkout0", L"FOO=2"));
+	WriteTestShader(dir / "checkout1", "float4 Color() { return 0; }\n");
+	VAST_CHECK(key != ComputeTestShaderKey(dir / "checkout1"));
+
+	// Sources that can't be read have no key.
+	ShaderFileCache fileCache;
+	uint64 missingKey = 0;
+	VAST_CHECK(!ComputeShaderCacheKey((dir / "missing.hlsl").string(), {}, fileCache, {}, "dxc 1.0", missingKey));
+
+	std::filesystem::remove_all(dir);
+}
+
+VAST_TEST(ShaderCache_LoadAndStore)
+{
+	const std::filesystem::path dir = MakeTestDirectory("ShaderCache_LoadAndStore");
+	ShaderCache cache(dir.string());
+	VAST_CHECK(cache.IsEnabled());
+
+	const uint8 bytecode[] = { 0xDE, 0xAD, 0xBE, 0xEF };
+	const uint8 reflection[] = { 1, 2, 3 };
+	ShaderCacheEntry entry;
+	VAST_CHECK(!cache.Load(1, entry));
+	VAST_CHECK(cache.Store(1, bytecode, sizeof(bytecode), reflection, sizeof(reflection)));
+
+	VAST_CHECK(cache.Load(1, entry));
+	VAST_CHECK(entry.bytecode == Vector<uint8>(bytecode, bytecode + sizeof(bytecode)));
+	VAST_CHECK(entry.reflection == Vector<uint8>(reflection, reflection + sizeof(reflection)));
+	VAST_CHECK(!cache.Load(2, entry));
+
+	// Truncated entries are rejected, and replaced on the next store.
+	Vector<uint8> data;
+	VAST_CHECK(Filesystem::ReadFile(cache.GetEntryPath(1), data));
+	VAST_CHECK(Filesystem::WriteFile(cache.GetEntryPath(1), data.data(), data.size() - 1));
+	VAST_CHECK(!cache.Load(1, entry));
+	VAST_CHECK(cache.Store(1, bytecode, sizeof(bytecode), reflection, sizeof(reflection)));
+	VAST_CHECK(cache.Load(1, entry));
+
+	const ShaderCacheStats stats = cache.GetStats();
+	VAST_CHECK(stats.numHits == 2 && stats.numMisses == 3 && stats.numRejected == 1 && stats.numStores == 2);
+
+	std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,91 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/ShaderReflection.h"
+
+#include <cstring>
+
+using namespace vast;
+
+static ShaderReflection MakeTestReflection()
+{
+	ShaderReflection reflection;
+	reflection.inputParameters =
+	{
+		{ "POSITION", 0, 3, 0x7 },
+		{ "TEXCOORD", 1, 3, 0x3 },
+	};
+	reflection.resources =
+	{
+		{ "ObjectConstantBuffer", ShaderResourceType::CONSTANT_BUFFER, 0, 0, 256 },
+		{ "ColorTexture", ShaderResourceType::SRV, 1, 2, 0 },
+		{ "OutputTexture", ShaderResourceType::UAV, 0, 0, 0 },
+		{ "LinearSampler", ShaderResourceType::SAMPLER, 3, 1, 0 },
+	};
+	return reflection;
+}
+
+VAST_TEST(ShaderReflection_RoundTrip)
+{
+	const ShaderReflection reflection = MakeTestReflection();
+	const Vector<uint8> data = SerializeShaderReflection(reflection);
+
+	ShaderReflection result;
+	VAST_CHECK(DeserializeShaderReflection(data.data(), data.size(), result));
+	VAST_CHECK(result == reflection);
+
+	// Empty reflection (e.g. compute shaders without resources) is valid too.
+	const Vector<uint8> emptyData = SerializeShaderReflection(ShaderReflection{});
+	VAST_CHECK(DeserializeShaderReflection(emptyData.data(), emptyData.size(), result));
+	VAST_CHECK(result.inputParameters.empty() && result.resources.empty());
+}
+
+VAST_TEST(ShaderReflection_RejectsTruncatedData)
+{
+	const Vector<uint8> data = SerializeShaderReflection(MakeTestReflection());
+
+	// Every prefix of the data is invalid.
+	ShaderReflection result;
+	VAST_CHECK(!DeserializeShaderReflection(nullptr, 0, result));
+	for (size_t size = 1; size < data.size(); ++size)
+	{
+		VAST_CHECK(!DeserializeShaderReflection(data.data(), size, result));
+	}
+}
+
+VAST_TEST(ShaderReflection_RejectsInvalidData)
+{
+	const ShaderReflection reflection = MakeTestReflection();
+	const Vector<uint8> data = SerializeShaderReflection(reflection);
+	ShaderReflection result;
+
+	// Magic and version are the first two words.
+	Vector<uint8> badMagic = data;
+	badMagic[0] ^= 0xFF;
+	VAST_CHECK(!DeserializeShaderReflection(badMagic.data(), badMagic.size(), result));
+
+	Vector<uint8> badVersion = data;
+	uint32 version = 0;
+	memcpy(&version, badVersion.data() + sizeof(uint32), sizeof(version));
+	version++;
+	memcpy(badVersion.data() + sizeof(uint32), &version, sizeof(version));
+	VAST_CHECK(!DeserializeShaderReflection(badVersion.data(), badVersion.size(), result));
+
+	Vector<uint8> trailingBytes = data;
+	trailingBytes.push_back(0);
+	VAST_CHECK(!DeserializeShaderReflection(trailingBytes.data(), trailingBytes.size(), result));
+
+	// Resource types are validated. The type is the word right after the last resource name.
+	ShaderReflection single;
+	single.resources = { { "Buffer", ShaderResourceType::SRV, 0, 0, 0 } };
+	Vector<uint8> badType = SerializeShaderReflection(single);
+	const uint32 invalidType = static_cast<uint32>(ShaderResourceType::SAMPLER) + 1;
+	memcpy(badType.data() + badType.size() - 4 * sizeof(uint32), &invalidType, sizeof(invalidType));
+	VAST_CHECK(!DeserializeShaderReflection(badType.data(), badType.size(), result));
+
+	// Counts larger than the data are caught without allocating for them.
+	Vector<uint8> badCount = SerializeShaderReflection(ShaderReflection{});
+	const uint32 hugeCount = UINT32_MAX;
+	memcpy(badCount.data() + 2 * sizeof(uint32), &hugeCount, sizeof(hugeCount));
+	VAST_CHECK(!DeserializeShaderReflection(badCount.data(), badCount.size(), result));
+}
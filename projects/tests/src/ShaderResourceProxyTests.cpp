@@ -0,0 +1,122 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Graphics/ShaderResourceProxy.h"
+
+#include <unordered_map>
+
+using namespace vast;
+
+static constexpr uint32 NUM_BENCHMARK_TABLES = 10000;
+static constexpr uint32 NUM_BENCHMARK_LOOKUPS = 1000000;
+
+// Shader resources as used by a typical pipeline.
+static const std::string s_PipelineResources[] =
+{
+	"FrameConstantBuffer", "ObjectConstantBuffer", "MaterialConstantBuffer", "LightConstantBuffer",
+	"g_ColorTexture", "g_NormalTexture", "g_ShadowMap", "g_EnvironmentMap",
+};
+
+static void RegisterPipelineResources(ShaderResourceProxyTable& table)
+{
+	for (uint32 i = 0; i < NELEM(s_PipelineResources); ++i)
+	{
+		table.Register(s_PipelineResources[i], ShaderResourceProxy{ i });
+	}
+}
+
+VAST_TEST(ShaderResourceProxyTable_LookupAfterBuild)
+{
+	ShaderResourceProxyTable table;
+	RegisterPipelineResources(table);
+	VAST_CHECK(table.IsRegistered("g_ShadowMap"));
+	VAST_CHECK(!table.IsRegistered("g_Unused"));
+	table.Build();
+
+	for (uint32 i = 0; i < NELEM(s_PipelineResources); ++i)
+	{
+		VAST_CHECK(table.LookupShaderResource(MakeShaderResourceKey(s_PipelineResources[i])).idx == i);
+	}
+	VAST_CHECK(table.LookupShaderResource(ShaderResourceName("ObjectConstantBuffer").key).idx == 1);
+	VAST_CHECK(!table.LookupShaderResource(ShaderResourceName("g_Unused").key).IsValid());
+
+	// Tables of any size map every registered resource to its own slot.
+	for (uint32 numResources = 0; numResources <= 64; ++numResources)
+	{
+		table.Reset();
+		for (uint32 i = 0; i < numResources; ++i)
+		{
+			table.Register("Resource" + std::to_string(i), ShaderResourceProxy{ i });
+		}
+		table.Build();
+		for (uint32 i = 0; i < numResources; ++i)
+		{
+			VAST_CHECK(table.LookupShaderResource(MakeShaderResourceKey("Resource" + std::to_string(i))).idx == i);
+		}
+		VAST_CHECK(!table.LookupShaderResource(MakeShaderResourceKey("Resource" + std::to_string(numResources))).IsValid());
+	}
+}
+
+// Note: The map benchmarks replicate the unordered_map keyed by name that ShaderResourceProxyTable
+// used to be, to compare against.
+
+VAST_BENCHMARK(ShaderResourceProxyTable_Build)
+{
+	ShaderResourceProxyTable table;
+	RunBenchmark("ShaderResourceProxyTable register and build 10k tables (8 resources)", 20, [&]()
+	{
+		for (uint32 i = 0; i < NUM_BENCHMARK_TABLES; ++i)
+		{
+			table.Reset();
+			RegisterPipelineResources(table);
+			table.Build();
+			g_BenchmarkSink = g_BenchmarkSink + table.LookupShaderResource(ShaderResourceName("g_ShadowMap").key).idx;
+		}
+	});
+
+	std::unordered_map<std::string, ShaderResourceProxy> map;
+	RunBenchmark("unordered_map register 10k tables (8 resources)", 20, [&]()
+	{
+		for (uint32 i = 0; i < NUM_BENCHMARK_TABLES; ++i)
+		{
+			map.clear();
+			for (uint32 j = 0; j < NELEM(s_PipelineResources); ++j)
+			{
+				map[s_PipelineResources[j]] = ShaderResourceProxy{ j };
+			}
+			g_BenchmarkSink = g_BenchmarkSink + map["g_ShadowMap"].idx;
+		}
+	});
+}
+
+VAST_BENCHMARK(ShaderResourceProxyTable_Lookup)
+{
+	ShaderResourceProxyTable table;
+	RegisterPipelineResources(table);
+	table.Build();
+	const ShaderResourceKey keys[] = { ShaderResourceName("g_ColorTexture").key, ShaderResourceName("ObjectConstantBuffer").key };
+	RunBenchmark("ShaderResourceProxyTable 1M lookups", 20, [&]()
+	{
+		uint64 checksum = 0;
+		for (uint32 i = 0; i < NUM_BENCHMARK_LOOKUPS; ++i)
+		{
+			checksum += table.LookupShaderResource(keys[i & 1]).idx;
+		}
+		g_BenchmarkSink = g_BenchmarkSink + checksum;
+	});
+
+	std::unordered_map<std::string, ShaderResourceProxy> map;
+	for (uint32 i = 0; i < NELEM(s_PipelineResources); ++i)
+	{
+		map[s_PipelineResources[i]] = ShaderResourceProxy{ i };
+	}
+	RunBenchmark("unordered_map 1M lookups", 20, [&]()
+	{
+		uint64 checksum = 0;
+		for (uint32 i = 0; i < NUM_BENCHMARK_LOOKUPS; ++i)
+		{
+			checksum += map[(i & 1) ? "ObjectConstantBuffer" : "g_ColorTexture"].idx;
+		}
+		g_BenchmarkSink = g_BenchmarkSink + checksum;
+	});
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Core/Timer.h"
+
+// ===================================== TESTS AND BENCHMARKS =====================================
+//
+// Headless tests and benchmarks for device-agnostic engine code, built into a single executable.
+//
+// Usage: tests [--bench] [filter]
+//
+// By default all tests are run, and the process returns a non-zero exit code if any of them fails.
+// With --bench, benchmarks are run instead. If a filter is given, only test cases whose name
+// contains it are run.
+//
+// Test cases are registered on static initialization by defining them with VAST_TEST or
+// VAST_BENCHMARK in any source file of the project, e.g.:
+//
+//		VAST_TEST(DisplayList_RecordAndIterate)
+//		{
+//			DisplayList dl;
+//			...
+//			VAST_CHECK(dl.GetNumCommands() == 3);
+//		}
+//
+// A failed VAST_CHECK is logged and fails the test, but doesn't stop it.
+//
+// ================================================================================================
+
+namespace vast
+{
+	using TestFn = void(*)();
+
+	bool RegisterTestCase(const char* name, TestFn fn, bool bIsBenchmark);
+	void ReportCheckFailed(const char* expr, const char* file, int line);
+
+	// Written to by benchmarks so that the compiler can't optimize away the work being measured.
+	extern volatile uint64 g_BenchmarkSink;
+
+	// Runs 'f' the given number of times after a warm-up run, and logs the average time per run.
+	template<typename F>
+	void RunBenchmark(const char* name, uint32 numRuns, F&& f)
+	{
+		f();
+
+		Timer timer;
+		for (uint32 i = 0; i < numRuns; ++i)
+		{
+			f();
+		}
+		timer.Update();
+		VAST_LOG_INFO("[bench] {}: {:.3f} ms (average of {} runs)", name, timer.GetElapsedMilliseconds<double>() / numRuns, numRuns);
+	}
+}
+
+#define __VAST_TEST_CASE_IMPL(name, bIsBenchmark)													\
+	static void name();																				\
+	static const bool XCAT(s_Registered_, name) = ::vast::RegisterTestCase(#name, &name, bIsBenchmark);	\
+	static void name()
+
+#define VAST_TEST(name)			__VAST_TEST_CASE_IMPL(name, false)
+#define VAST_BENCHMARK(name)	__VAST_TEST_CASE_IMPL(name, true)
+
+#define VAST_CHECK(expr)																			\
+	do																								\
+	{																								\
+		if (!(expr))																				\
+		{																							\
+			::vast::ReportCheckFailed(STR(expr), __FILE__, __LINE__);								\
+		}																							\
+	} while(0)
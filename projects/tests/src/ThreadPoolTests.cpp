@@ -0,0 +1,62 @@
+#include "vastpch.h"
+#include "Tests.h"
+
+#include "Core/ThreadPool.h"
+
+using namespace vast;
+
+VAST_TEST(ThreadPool_RunsEveryItemOnce)
+{
+	ThreadPool pool(3);
+	Vector<std::atomic<uint32>> numRuns(1000);
+	std::atomic<bool> bValidThreadIdxs = true;
+	pool.ParallelFor(static_cast<uint32>(numRuns.size()), [&](uint32 i, uint32 threadIdx)
+		{
+			numRuns[i]++;
+			bValidThreadIdxs = bValidThreadIdxs && threadIdx < pool.GetNumThreads();
+		});
+
+	VAST_CHECK(bValidThreadIdxs);
+	VAST_CHECK(std::all_of(numRuns.begin(), numRuns.end(), [](const std::atomic<uint32>& n) { return n == 1; }));
+}
+
+VAST_TEST(ThreadPool_ConcurrentCallsDontWaitForEachOther)
+{
+	ThreadPool pool(1, 2);
+	VAST_CHECK(pool.GetNumThreads() == 3);
+
+	// A long-running call from another thread (e.g. a background shader reload) blocks until the
+	// call from this thread is done, which would never happen if calls were serialized.
+	std::atomic<bool> bHasStarted = false;
+	std::atomic<bool> bIsDone = false;
+	std::atomic<uint32> backgroundThreadIdx = UINT32_MAX;
+	std::thread background([&]()
+		{
+			pool.ParallelFor(1, [&](uint32, uint32 threadIdx)
+				{
+					backgroundThreadIdx = threadIdx;
+					bHasStarted = true;
+					while (!bIsDone)
+					{
+						std::this_thread::yield();
+					}
+				});
+		});
+	while (!bHasStarted)
+	{
+		std::this_thread::yield();
+	}
+
+	std::atomic<uint32> numRuns = 0;
+	std::atomic<bool> bUniqueThreadIdxs = true;
+	pool.ParallelFor(8, [&](uint32, uint32 threadIdx)
+		{
+			numRuns++;
+			bUniqueThreadIdxs = bUniqueThreadIdxs && threadIdx != backgroundThreadIdx;
+		});
+	bIsDone = true;
+	background.join();
+
+	VAST_CHECK(numRuns == 8);
+	VAST_CHECK(bUniqueThreadIdxs);
+}
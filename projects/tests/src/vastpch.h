@@ -0,0 +1,5 @@
+#pragma once
+
+// Note: Same as in the shadercompiler project, engine sources built into the tests use this header
+// instead of the engine's vastpch.h, so that no application/windowing headers are pulled in.
+#include "Core/Core.h"
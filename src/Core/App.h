@@ -13,7 +13,8 @@ int main(int argc, char** argv)									\
 	return Win32_Main(argc, argv, &app);						\
 }																
 #else
-#error "Unsupported platform!"
+// Note: Windowed applications are only supported on Windows, other platforms can only build tools
+// with their own main function.
 #endif
 
 namespace vast
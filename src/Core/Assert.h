@@ -48,9 +48,10 @@ static void LogFatalError(const std::string_view fmt, Args&&... args)
 #endif // VAST_ENABLE_ASSERTS
 
 // Note: SELECT_MACRO will not work here because VAST_ASSERTF can take any number of arguments.
-// Passing __LINE__ into the macro to avoid trailing comma from __VA_ARGS__.
+// Passing __LINE__ into the macro to avoid trailing comma from __VA_ARGS__. The ## in the F variants
+// removes the comma before an empty __VA_ARGS__ (MSVC does this implicitly, GCC/Clang do not).
 #define VAST_ASSERT(expr)				__VAST_ASSERT_IMPL(expr, "", __LINE__)
-#define VAST_ASSERTF(expr, fmt, ...)	__VAST_ASSERT_IMPL(expr, fmt, __LINE__, __VA_ARGS__)
+#define VAST_ASSERTF(expr, fmt, ...)	__VAST_ASSERT_IMPL(expr, fmt, __LINE__, ##__VA_ARGS__)
 
 #define VAST_VERIFY(expr)				__VAST_VERIFY_IMPL(expr, "", __LINE__)
-#define VAST_VERIFYF(expr, fmt, ...)	__VAST_VERIFY_IMPL(expr, fmt, __LINE__, __VA_ARGS__)
+#define VAST_VERIFYF(expr, fmt, ...)	__VAST_VERIFY_IMPL(expr, fmt, __LINE__, ##__VA_ARGS__)
@@ -8,6 +8,9 @@
 #else
 #error "Invalid Platform: x86 builds not supported"
 #endif
+#elif defined(__linux__)
+// Note: Linux is only supported for device-agnostic code (e.g. tools, render graph compilation).
+#define VAST_PLATFORM_LINUX
 #else
 #error "Invalid Platform: Unknown Platform"
 #endif
@@ -16,7 +19,11 @@
 
 #ifdef VAST_DEBUG
 #define VAST_ENABLE_ASSERTS 1
+#ifdef VAST_PLATFORM_WINDOWS
 #define VAST_DEBUGBREAK() __debugbreak()
+#else
+#define VAST_DEBUGBREAK() __builtin_trap()
+#endif
 
 #define VAST_DEBUG_ONLY(x) x
 #else
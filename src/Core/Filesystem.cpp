@@ -2,6 +2,19 @@
 #include "Core/Filesystem.h"
 
 #include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef VAST_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace vast
 {
@@ -19,11 +32,188 @@ namespace vast
 			return std::filesystem::path(__FILE__).filename().string();
 		}
 
+		std::string GetExecutableName()
+		{
+#ifdef VAST_PLATFORM_WINDOWS
+			char path[MAX_PATH];
+			const DWORD length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+			if (length == 0 || length == MAX_PATH)
+				return std::string();
+			return std::filesystem::path(std::string(path, length)).stem().string();
+#else
+			std::error_code ec;
+			const std::filesystem::path path = std::filesystem::read_symlink("/proc/self/exe", ec);
+			return ec ? std::string() : path.stem().string();
+#endif
+		}
+
 		bool FileExists(const std::string& filePath)
 		{
 			return std::filesystem::exists(filePath);
 		}
 
+		int64_t GetLastWriteTime(const std::string& filePath)
+		{
+			std::error_code ec;
+			const auto t = std::filesystem::last_write_time(filePath, ec);
+			return ec ? INT64_MIN : static_cast<int64_t>(t.time_since_epoch().count());
+		}
+
+		bool CreateDirectories(const std::string& dirPath)
+		{
+			std::error_code ec;
+			std::filesystem::create_directories(dirPath, ec);
+			return std::filesystem::is_directory(dirPath, ec);
+		}
+
+		bool ReadFile(const std::string& filePath, std::vector<uint8_t>& outData)
+		{
+			std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+			if (!file)
+				return false;
+
+			const std::streamsize size = file.tellg();
+			if (size < 0)
+				return false;
+
+			outData.resize(static_cast<size_t>(size));
+			file.seekg(0, std::ios::beg);
+			return size == 0 || file.read(reinterpret_cast<char*>(outData.data()), size).good();
+		}
+
+		bool WriteFile(const std::string& filePath, const void* data, size_t size)
+		{
+			// Note: Unique per thread, so concurrent writers of the same file don't share a temp file.
+			const std::string tmpPath = filePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+			{
+				std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+				if (!file || !file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)))
+					return false;
+			}
+
+			std::error_code ec;
+			std::filesystem::rename(tmpPath, filePath, ec);
+			if (ec)
+			{
+				std::filesystem::remove(tmpPath, ec);
+				return false;
+			}
+			return true;
+		}
+
+		//
+
+		MappedFile::~MappedFile()
+		{
+			Close();
+		}
+
+#ifdef VAST_PLATFORM_WINDOWS
+		bool MappedFile::Open(const std::string& filePath)
+		{
+			Close();
+
+			HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER size = {};
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (!data)
+			{
+				if (mapping) CloseHandle(mapping);
+				CloseHandle(file);
+				return false;
+			}
+
+			m_FileHandle = file;
+			m_MappingHandle = mapping;
+			m_Data = static_cast<const uint8_t*>(data);
+			m_Size = static_cast<size_t>(size.QuadPart);
+			return true;
+		}
+
+		void MappedFile::Close()
+		{
+			if (m_Data) UnmapViewOfFile(m_Data);
+			if (m_MappingHandle) CloseHandle(m_MappingHandle);
+			if (m_FileHandle) CloseHandle(m_FileHandle);
+
+			m_Data = nullptr;
+			m_Size = 0;
+			m_FileHandle = nullptr;
+			m_MappingHandle = nullptr;
+		}
+#else
+		bool MappedFile::Open(const std::string& filePath)
+		{
+			Close();
+
+			const int fd = open(filePath.c_str(), O_RDONLY);
+			if (fd < 0)
+				return false;
+
+			struct stat st = {};
+			if (fstat(fd, &st) != 0 || st.st_size == 0)
+			{
+				close(fd);
+				return false;
+			}
+
+			void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			// Note: The mapping keeps its own reference to the file.
+			close(fd);
+			if (data == MAP_FAILED)
+				return false;
+
+			m_Data = static_cast<const uint8_t*>(data);
+			m_Size = static_cast<size_t>(st.st_size);
+			return true;
+		}
+
+		void MappedFile::Close()
+		{
+			if (m_Data) munmap(const_cast<uint8_t*>(m_Data), m_Size);
+
+			m_Data = nullptr;
+			m_Size = 0;
+		}
+#endif
+
+		//
+
+		void FileWatcher::AddFile(const std::string& filePath)
+		{
+			if (!IsWatching(filePath))
+			{
+				m_Files[filePath] = GetLastWriteTime(filePath);
+			}
+		}
+
+		bool FileWatcher::IsWatching(const std::string& filePath) const
+		{
+			return m_Files.find(filePath) != m_Files.end();
+		}
+
+		void FileWatcher::Poll(std::vector<std::string>& outChangedFiles)
+		{
+			for (auto& [filePath, lastWriteTime] : m_Files)
+			{
+				const int64_t writeTime = GetLastWriteTime(filePath);
+				if (writeTime != lastWriteTime)
+				{
+					lastWriteTime = writeTime;
+					outChangedFiles.push_back(filePath);
+				}
+			}
+		}
 	}
 
 }
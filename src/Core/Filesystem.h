@@ -2,7 +2,10 @@
 
 #include "Core/Defines.h"
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace vast
 {
@@ -11,7 +14,64 @@ namespace vast
 	{
 		std::string GetWorkingDirectory();
 		std::string GetCurrentFilename();
+		// Returns the filename of the running executable without its extension, or an empty string if
+		// it can't be determined.
+		std::string GetExecutableName();
 
 		bool FileExists(const std::string& filePath);
+		// Returns INT64_MIN if the file doesn't exist.
+		int64_t GetLastWriteTime(const std::string& filePath);
+		bool CreateDirectories(const std::string& dirPath);
+
+		// Note: Types.h depends on this header, so engine type aliases can't be used here.
+		bool ReadFile(const std::string& filePath, std::vector<uint8_t>& outData);
+		// Writes to a temporary file first, so readers never observe a partially written file.
+		bool WriteFile(const std::string& filePath, const void* data, size_t size);
+
+		// Read-only view of a whole file mapped into memory. Pages are loaded on first access, and the
+		// view stays valid until the file is closed.
+		class MappedFile
+		{
+		public:
+			MappedFile() = default;
+			~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			bool Open(const std::string& filePath);
+			void Close();
+
+			bool IsOpen() const { return m_Data != nullptr; }
+			const uint8_t* GetData() const { return m_Data; }
+			size_t GetSize() const { return m_Size; }
+
+		private:
+			const uint8_t* m_Data = nullptr;
+			size_t m_Size = 0;
+#ifdef VAST_PLATFORM_WINDOWS
+			void* m_FileHandle = nullptr;
+			void* m_MappingHandle = nullptr;
+#endif
+		};
+
+		// Detects changes to a set of files by comparing their last write time against the one seen
+		// when they were added or last reported. Polling only touches the watched files, so it is
+		// cheap for small sets (e.g. shader sources and their includes) and works on any platform.
+		class FileWatcher
+		{
+		public:
+			// Does nothing if the file is already watched.
+			void AddFile(const std::string& filePath);
+			bool IsWatching(const std::string& filePath) const;
+
+			// Appends files that were modified, deleted or recreated since the last poll.
+			void Poll(std::vector<std::string>& outChangedFiles);
+			size_t GetNumFiles() const { return m_Files.size(); }
+
+		private:
+			// Last write time, or INT64_MIN if the file didn't exist.
+			std::unordered_map<std::string, int64_t> m_Files;
+		};
 	}
 }
\ No newline at end of file
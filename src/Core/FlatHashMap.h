@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Core/Assert.h"
+#include "Core/Types.h"
+
+namespace vast
+{
+
+	// Open-addressing hash map from 64-bit keys that are already hashes (e.g. HashString results),
+	// so their low bits are used directly to pick a slot. Keys and values are stored in a single
+	// flat array with linear probing, and removals shift entries back instead of leaving
+	// tombstones. A key of 0 is reserved to mark empty slots.
+	template<typename T>
+	class FlatHashMap
+	{
+	public:
+		static constexpr uint64 EMPTY_KEY = 0;
+
+		FlatHashMap(uint32 initialCapacity = 16)
+			: m_Slots()
+			, m_Size(0)
+		{
+			uint32 capacity = 16;
+			while (capacity < initialCapacity)
+			{
+				capacity *= 2;
+			}
+			m_Slots.resize(capacity);
+		}
+
+		// Returns nullptr if the key isn't in the map. Pointers are invalidated by Insert and Remove.
+		T* Find(uint64 key)
+		{
+			return const_cast<T*>(static_cast<const FlatHashMap*>(this)->Find(key));
+		}
+
+		const T* Find(uint64 key) const
+		{
+			VAST_ASSERT(key != EMPTY_KEY);
+			for (uint32 i = GetSlotIdx(key); ; i = GetNextSlotIdx(i))
+			{
+				const Slot& slot = m_Slots[i];
+				if (slot.key == key)
+					return &slot.value;
+				if (slot.key == EMPTY_KEY)
+					return nullptr;
+			}
+		}
+
+		bool Contains(uint64 key) const
+		{
+			return Find(key) != nullptr;
+		}
+
+		// Inserts or overwrites the value for the given key.
+		void Insert(uint64 key, const T& value)
+		{
+			VAST_ASSERT(key != EMPTY_KEY);
+			// Note: Keep the load factor under 3/4, probe lengths grow quickly beyond that.
+			if ((m_Size + 1) * 4 > m_Slots.size() * 3)
+			{
+				Grow();
+			}
+
+			uint32 i = GetSlotIdx(key);
+			while (m_Slots[i].key != EMPTY_KEY && m_Slots[i].key != key)
+			{
+				i = GetNextSlotIdx(i);
+			}
+
+			if (m_Slots[i].key == EMPTY_KEY)
+			{
+				m_Slots[i].key = key;
+				m_Size++;
+			}
+			m_Slots[i].value = value;
+		}
+
+		bool Remove(uint64 key)
+		{
+			VAST_ASSERT(key != EMPTY_KEY);
+			uint32 i = GetSlotIdx(key);
+			while (m_Slots[i].key != key)
+			{
+				if (m_Slots[i].key == EMPTY_KEY)
+					return false;
+				i = GetNextSlotIdx(i);
+			}
+
+			// Shift back following entries in the same probe sequence, so that lookups never stop
+			// early at the slot we just emptied.
+			for (uint32 j = GetNextSlotIdx(i); m_Slots[j].key != EMPTY_KEY; j = GetNextSlotIdx(j))
+			{
+				const uint32 home = GetSlotIdx(m_Slots[j].key);
+				const bool bCanMove = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+				if (bCanMove)
+				{
+					m_Slots[i] = std::move(m_Slots[j]);
+					i = j;
+				}
+			}
+			m_Slots[i] = Slot();
+			m_Size--;
+			return true;
+		}
+
+		void Clear()
+		{
+			for (auto& slot : m_Slots)
+			{
+				slot = Slot();
+			}
+			m_Size = 0;
+		}
+
+		uint32 GetSize() const { return m_Size; }
+		bool IsEmpty() const { return m_Size == 0; }
+
+	private:
+		struct Slot
+		{
+			uint64 key = EMPTY_KEY;
+			T value = {};
+		};
+
+		uint32 GetSlotIdx(uint64 key) const { return static_cast<uint32>(key) & (static_cast<uint32>(m_Slots.size()) - 1); }
+		uint32 GetNextSlotIdx(uint32 i) const { return (i + 1) & (static_cast<uint32>(m_Slots.size()) - 1); }
+
+		void Grow()
+		{
+			Vector<Slot> oldSlots(m_Slots.size() * 2);
+			std::swap(oldSlots, m_Slots);
+			m_Size = 0;
+			for (auto& slot : oldSlots)
+			{
+				if (slot.key != EMPTY_KEY)
+				{
+					Insert(slot.key, slot.value);
+				}
+			}
+		}
+
+		Vector<Slot> m_Slots;
+		uint32 m_Size;
+	};
+
+}
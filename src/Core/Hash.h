@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Core/Types.h"
+
+#include <string_view>
+#include <type_traits>
+
+namespace vast
+{
+	// 64-bit FNV-1a
+	constexpr uint64 HASH_OFFSET_BASIS = 0xcbf29ce484222325ull;
+	constexpr uint64 HASH_PRIME = 0x100000001b3ull;
+
+	inline uint64 HashBytes(const void* data, size_t size, uint64 seed = HASH_OFFSET_BASIS)
+	{
+		const uint8* bytes = static_cast<const uint8*>(data);
+		uint64 h = seed;
+		for (size_t i = 0; i < size; ++i)
+		{
+			h = (h ^ bytes[i]) * HASH_PRIME;
+		}
+		return h;
+	}
+
+	// Same as HashBytes over the characters of the string, but usable in constant expressions (e.g.
+	// to hash string literals at compile time).
+	constexpr uint64 HashString(std::string_view s, uint64 seed = HASH_OFFSET_BASIS)
+	{
+		uint64 h = seed;
+		for (char c : s)
+		{
+			h = (h ^ static_cast<uint8>(c)) * HASH_PRIME;
+		}
+		return h;
+	}
+
+	// Accumulates a hash from multiple values. Strings and buffers are prefixed with their size, so
+	// that different splits of the same bytes (e.g. "ab" + "c" and "a" + "bc") hash differently.
+	class Hasher
+	{
+	public:
+		void AddBytes(const void* data, size_t size)
+		{
+			m_Hash = HashBytes(&size, sizeof(size), m_Hash);
+			m_Hash = HashBytes(data, size, m_Hash);
+		}
+
+		template<typename T>
+		void Add(const T& v)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			m_Hash = HashBytes(&v, sizeof(T), m_Hash);
+		}
+
+		void Add(const std::string& s) { AddBytes(s.data(), s.size()); }
+		void Add(const std::wstring& s) { AddBytes(s.data(), s.size() * sizeof(wchar_t)); }
+
+		uint64 Get() const { return m_Hash; }
+
+	private:
+		uint64 m_Hash = HASH_OFFSET_BASIS;
+	};
+
+}
@@ -30,14 +30,15 @@ namespace vast
 			currSample = (currSample + 1) % StatHistory::kHistorySize;
 		}
 
-		void UpdateAverages()
+		// Zero samples are skipped unless they are meaningful for the stat (e.g. no stall).
+		void UpdateAverages(bool bCountZeroSamples = false)
 		{
 			tAvg = 0;
 			tMax = 0;
 			uint32 validSamples = 0;
 			for (double v : history)
 			{
-				if (v > 0.0)
+				if (v > 0.0 || bCountZeroSamples)
 				{
 					++validSamples;
 					tAvg += v;
@@ -137,6 +138,12 @@ namespace vast
 	static StatHistory s_GpuStats;
 	static PlotHistory s_GpuPlot;
 
+	// Fence Wait Stalls
+	static Array<StatHistory, IDX(FenceWaitCause::COUNT)> s_StallStats;
+	static StatHistory s_TotalStallStats;
+	static PlotHistory s_StallPlot;
+	static FenceWaitLatencyStats s_FenceWaitLatencyTotals;
+
 	// General
 	static float s_tLastStatsUpdate = 0.0f;
 	static float s_StatUpdateFrequencySeconds = 0.1f;
@@ -174,6 +181,17 @@ namespace vast
 			s_GpuStats.RecordTimeLast(durationMs);
 			if (Profiler::ui::g_bShowProfiler) s_GpuPlot.RecordTimeLast(static_cast<float>(durationMs));
 		}
+		{
+			const FenceWaitStats& waitStats = ctx.GetLastFrameFenceWaitStats();
+			for (uint32 i = 0; i < IDX(FenceWaitCause::COUNT); ++i)
+			{
+				s_StallStats[i].RecordTimeLast(waitStats.waitTimeMs[i]);
+			}
+			s_FenceWaitLatencyTotals += waitStats.latency;
+			double durationMs = waitStats.GetTotalWaitTimeMs();
+			s_TotalStallStats.RecordTimeLast(durationMs);
+			if (Profiler::ui::g_bShowProfiler) s_StallPlot.RecordTimeLast(static_cast<float>(durationMs));
+		}
 
 		float tTimeNowSeconds = s_Timer.GetElapsedSeconds<float>();
 		// Check if we should update stats this frame (i.e. recompute averages).
@@ -185,6 +203,11 @@ namespace vast
 
 			s_FrameStats.UpdateAverages();
 			s_GpuStats.UpdateAverages();
+			for (auto& stats : s_StallStats)
+			{
+				stats.UpdateAverages(true);
+			}
+			s_TotalStallStats.UpdateAverages(true);
 		}
 		// Check if we should reset min/max value on plots this frame.
 		if (Profiler::ui::g_bShowProfiler && (tTimeNowSeconds - s_tLastPlotsMaxReset) >= s_PlotMaxResetFrequencySeconds)
@@ -193,6 +216,7 @@ namespace vast
 
 			s_FramePlot.ResetMinMax();
 			s_GpuPlot.ResetMinMax();
+			s_StallPlot.ResetMinMax();
 		}
 
 		// Reset user profiles if needed.
@@ -508,6 +532,46 @@ namespace vast
 		ImGui::PlotLines("", plot.history.data(), static_cast<int>(plot.kHistorySize), 0, overlay, std::min(plot.tMin, std::max(float(avg) - 1.5f, 0.0f)), std::max(plot.tMax, float(avg) + 1.5f), ImVec2(availableWidth, 80.0f));
 	}
 
+	static void DrawStallsTable()
+	{
+		ImGui::BeginTable("Stalls", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg);
+
+		ImGui::TableSetupColumn("Cause");
+		ImGui::TableSetupColumn("Avg");
+		ImGui::TableSetupColumn("Max");
+		ImGui::TableHeadersRow();
+
+		for (uint32 i = 0; i < IDX(FenceWaitCause::COUNT); ++i)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::Text("%s", g_FenceWaitCauseNames[i]);
+			if (i == IDX(FenceWaitCause::FRAME_PACING) && ImGui::IsItemHovered())
+			{
+				// Note: Frame pacing stalls mean the CPU got ahead of the GPU by the max number of
+				// frames in flight.
+				ImGui::SetTooltip("CPU waiting on the GPU to finish a previous frame (GPU-bound).");
+			}
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f ms", s_StallStats[i].tAvg);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f ms", s_StallStats[i].tMax);
+		}
+
+		ImGui::EndTable();
+
+		const FenceWaitLatencyStats& l = s_FenceWaitLatencyTotals;
+		const uint32 numWaits = l.numSpinWaits + l.numBlockingWaits;
+		if (numWaits > 0)
+		{
+			ImGui::Text("Resolved by spinning: %u/%u waits (%.1f%%)", l.numSpinWaits, numWaits, 100.0 * l.numSpinWaits / numWaits);
+			if (l.numBlockingWaits > 0)
+			{
+				ImGui::Text("Blocking waits: avg %.3f ms (max %.3f ms)", l.blockTimeUs / 1000.0 / l.numBlockingWaits, l.maxBlockTimeUs / 1000.0);
+			}
+		}
+	}
+
 	void Profiler::ui::OnGUI()
 	{
 		if (!g_bShowProfiler)
@@ -529,7 +593,7 @@ namespace vast
 			return;
 		}
 
-		ImGui::Text("Frame: %.3f ms (CPU: %.3f ms, GPU: %.3f ms)", s_FrameStats.tAvg, s_CpuStats.tAvg, s_GpuStats.tAvg);
+		ImGui::Text("Frame: %.3f ms (CPU: %.3f ms, GPU: %.3f ms, Stalls: %.3f ms)", s_FrameStats.tAvg, s_CpuStats.tAvg, s_GpuStats.tAvg, s_TotalStallStats.tAvg);
 
 		if (ImGui::BeginTabBar("##ProfilerTabBar"))
 		{
@@ -562,6 +626,16 @@ namespace vast
 				DrawNestedProfilesTable(s_GpuProfiles, s_GpuProfileCount, s_GpuStats);
 				ImGui::EndTabItem();
 			}
+
+			if (ImGui::BeginTabItem("Stalls"))
+			{
+				ImGui::PushID("Stalls");
+				DrawPlotHistory(s_StallPlot, s_TotalStallStats.tAvg, s_TotalStallStats.tMax);
+				ImGui::PopID();
+				ImGui::Separator();
+				DrawStallsTable();
+				ImGui::EndTabItem();
+			}
 			
 			if (ImGui::BeginTabItem("Settings"))
 			{
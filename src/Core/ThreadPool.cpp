@@ -0,0 +1,132 @@
+#include "vastpch.h"
+#include "Core/ThreadPool.h"
+
+namespace vast
+{
+
+	ThreadPool::ThreadPool(uint32 numWorkers /* = 0 */, uint32 maxCallerThreads /* = 1 */)
+		: m_Workers()
+		, m_MaxCallerThreads(maxCallerThreads)
+		, m_Jobs()
+		, m_FreeCallerThreadIdxs()
+		, m_bIsShuttingDown(false)
+	{
+		if (numWorkers == 0)
+		{
+			const uint32 numHardwareThreads = std::thread::hardware_concurrency();
+			numWorkers = numHardwareThreads > 1 ? numHardwareThreads - 1 : 1;
+		}
+
+		// Note: Indices are taken from the back, so the first caller gets the one right after the workers.
+		for (uint32 i = 0; i < m_MaxCallerThreads; ++i)
+		{
+			m_FreeCallerThreadIdxs.push_back(numWorkers + m_MaxCallerThreads - 1 - i);
+		}
+
+		m_Workers.reserve(numWorkers);
+		for (uint32 i = 0; i < numWorkers; ++i)
+		{
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_bIsShuttingDown = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::ParallelFor(uint32 count, const ParallelForFunc& f)
+	{
+		if (count == 0)
+			return;
+
+		Job job;
+		job.func = &f;
+		job.count = count;
+
+		uint32 callerThreadIdx = UINT32_MAX;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Jobs.push_back(&job);
+			if (!m_FreeCallerThreadIdxs.empty())
+			{
+				callerThreadIdx = m_FreeCallerThreadIdxs.back();
+				m_FreeCallerThreadIdxs.pop_back();
+			}
+		}
+		m_WakeCondition.notify_all();
+
+		if (callerThreadIdx != UINT32_MAX)
+		{
+			RunItems(job, callerThreadIdx);
+		}
+
+		// Note: Workers may still be running items other than the last one we completed, and must
+		// be done with the job before we return and it goes out of scope.
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		if (callerThreadIdx != UINT32_MAX)
+		{
+			m_FreeCallerThreadIdxs.push_back(callerThreadIdx);
+		}
+		m_DoneCondition.wait(lock, [&job, count]() { return job.numCompleted == count && job.numActiveWorkers == 0; });
+		std::erase(m_Jobs, &job);
+	}
+
+	void ThreadPool::WorkerLoop(uint32 threadIdx)
+	{
+		while (true)
+		{
+			Job* job = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_WakeCondition.wait(lock, [this, &job]() { return m_bIsShuttingDown || (job = FindJobWithItemsLeft()) != nullptr; });
+				if (m_bIsShuttingDown)
+					return;
+
+				job->numActiveWorkers++;
+			}
+
+			RunItems(*job, threadIdx);
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				job->numActiveWorkers--;
+			}
+			// Note: Callers of different jobs wait on the same condition.
+			m_DoneCondition.notify_all();
+		}
+	}
+
+	void ThreadPool::RunItems(Job& job, uint32 threadIdx)
+	{
+		while (true)
+		{
+			const uint32 idx = job.nextIdx.fetch_add(1);
+			if (idx >= job.count)
+				break;
+
+			(*job.func)(idx, threadIdx);
+			job.numCompleted.fetch_add(1);
+		}
+	}
+
+	ThreadPool::Job* ThreadPool::FindJobWithItemsLeft() const
+	{
+		for (Job* job : m_Jobs)
+		{
+			if (job->HasItemsLeft())
+				return job;
+		}
+		return nullptr;
+	}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Core/Types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace vast
+{
+
+	// Fixed set of worker threads for CPU-bound work that can be split into independent items
+	// (e.g. shader compilation). Workers sleep while there is no work to do.
+	class ThreadPool
+	{
+	public:
+		using ParallelForFunc = std::function<void(uint32 idx, uint32 threadIdx)>;
+
+		// A value of 0 creates one worker per hardware thread, minus one for the calling thread.
+		// 'maxCallerThreads' is the number of threads that may call ParallelFor at the same time
+		// while running items themselves.
+		ThreadPool(uint32 numWorkers = 0, uint32 maxCallerThreads = 1);
+		~ThreadPool();
+
+		// Calls f(idx, threadIdx) for every idx in [0, count), spreading the calls across the workers
+		// and the calling thread, and returns once all of them have finished. 'threadIdx' is in
+		// [0, GetNumThreads()) and is unique among concurrent calls, so it can be used to index
+		// per-thread state. Calls from different threads run concurrently, with workers taking items
+		// from the oldest call first. Callers beyond 'maxCallerThreads' leave their items to the
+		// workers.
+		void ParallelFor(uint32 count, const ParallelForFunc& f);
+
+		// Number of threads that may run work, including those calling ParallelFor.
+		uint32 GetNumThreads() const { return static_cast<uint32>(m_Workers.size()) + m_MaxCallerThreads; }
+
+	private:
+		// Items of a single ParallelFor call, owned by the calling thread.
+		struct Job
+		{
+			const ParallelForFunc* func = nullptr;
+			uint32 count = 0;
+			uint32 numActiveWorkers = 0;
+			std::atomic<uint32> nextIdx = 0;
+			std::atomic<uint32> numCompleted = 0;
+
+			bool HasItemsLeft() const { return nextIdx < count; }
+		};
+
+		void WorkerLoop(uint32 threadIdx);
+		static void RunItems(Job& job, uint32 threadIdx);
+		Job* FindJobWithItemsLeft() const;
+
+		Vector<std::thread> m_Workers;
+		uint32 m_MaxCallerThreads;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WakeCondition;
+		std::condition_variable m_DoneCondition;
+
+		Vector<Job*> m_Jobs;
+		// Thread indices after those of the workers, for callers to run items with.
+		Vector<uint32> m_FreeCallerThreadIdxs;
+		bool m_bIsShuttingDown;
+	};
+
+}
@@ -9,6 +9,9 @@
 #include "Graphics/API/DX12/DX12_CommandQueue.h"
 #include "Graphics/API/DX12/DX12_Device.h"
 #include "Graphics/API/DX12/DX12_SwapChain.h"
+#include "Graphics/QueueScheduler.h"
+
+#include "Core/Timer.h"
 
 #include "dx12/DirectXTex/DirectXTex/DirectXTex.h"
 
@@ -17,32 +20,82 @@ extern "C" { __declspec(dllexport) extern const char* D3D12SDKPath = ".\\D3D12\\
 
 namespace vast::gfx
 {
-	enum class QueueType
-	{
-		GRAPHICS = 0,
-		// TODO: Async Compute
-		UPLOAD,
-		COUNT,
-	};
-
 	static uint32 s_FrameId = 0;
+	static uint32 s_NumFramesInFlight = 0;
 
 	static Ptr<DX12Device> s_Device = nullptr;
 	static Ptr<DX12SwapChain> m_SwapChain = nullptr;
 	static Ptr<DX12QueryHeap> s_QueryHeap = nullptr;
 	static Ptr<DX12GraphicsCommandList> s_GraphicsCommandList = nullptr;
-	// TODO: Async Compute (Ptr<DX12GraphicsCommandList> m_ComputeCommandList;)
-	static Array<Ptr<DX12UploadCommandList>, NUM_FRAMES_IN_FLIGHT> s_UploadCommandLists = { nullptr };
+	// Note: The compute command list tracks resource states locally, since graphics work using the same
+	// resources may not have been submitted yet when it is recorded (see EndAsyncCompute).
+	static Ptr<DX12GraphicsCommandList> s_ComputeCommandList = nullptr;
+	// Barrier-only command list submitted right before the compute command list.
+	static Ptr<DX12CommandList> s_ComputeBarrierCommandList = nullptr;
+	// Note: The compute command lists can be submitted multiple times per frame, but their allocators
+	// can only be reset on the first submission.
+	static bool s_bHasComputeCommandListBeenReset = false;
+	static bool s_bHasComputeBarrierCommandListBeenReset = false;
+	static Array<Ptr<DX12UploadCommandList>, MAX_FRAMES_IN_FLIGHT> s_UploadCommandLists = { nullptr };
 
 	static Array<Ptr<DX12CommandQueue>, IDX(QueueType::COUNT)> s_CommandQueues = { nullptr };
-	static Array<Array<uint64, NUM_FRAMES_IN_FLIGHT>, IDX(QueueType::COUNT)> s_FrameFenceValues = { {0} };
+	static Array<Array<uint64, MAX_FRAMES_IN_FLIGHT>, IDX(QueueType::COUNT)> s_FrameFenceValues = { {0} };
+	static QueueScheduler s_QueueScheduler;
+
+	// Command lists recorded from worker threads. Each one tracks resource states locally, and the
+	// states are reconciled with the global ones when they are submitted (see SubmitParallelCommandLists).
+	static Array<Ptr<DX12GraphicsCommandList>, NUM_PARALLEL_COMMAND_LISTS> s_ParallelCommandLists = { nullptr };
+	static Array<bool, NUM_PARALLEL_COMMAND_LISTS> s_bIsParallelCommandListRecorded = { false };
+	// Barrier-only command lists, submitted right before each parallel command list but the first one
+	// to transition resources into the states it expects. Like the compute command list, they can be
+	// submitted multiple times per frame, but their allocators can only be reset on the first submission.
+	static Array<Ptr<DX12CommandList>, NUM_PARALLEL_COMMAND_LISTS - 1> s_ParallelBarrierCommandLists = { nullptr };
+	static Array<bool, NUM_PARALLEL_COMMAND_LISTS - 1> s_bHasParallelBarrierCommandListBeenReset = { false };
+	// Parallel or async compute command list bound to the calling thread, if any.
+	static thread_local DX12GraphicsCommandList* t_BoundCommandList = nullptr;
 
 	using RenderPassEndBarrier = std::pair<DX12Texture*, D3D12_RESOURCE_STATES>;
-	static Vector<RenderPassEndBarrier> s_RenderPassEndBarriers;
+	static thread_local Vector<RenderPassEndBarrier> s_RenderPassEndBarriers;
+
+	// Returns the command list that recording calls from the calling thread should go into.
+	static DX12GraphicsCommandList& GetCurrentCommandList()
+	{
+		return t_BoundCommandList ? *t_BoundCommandList : *s_GraphicsCommandList;
+	}
+
+	static StateCacheStats s_LastFrameStateCacheStats = {};
+	static FenceWaitStats s_FenceWaitStats = {};
+	static FenceWaitStats s_LastFrameFenceWaitStats = {};
+
+	// Blocks until the queue reaches the fence value, recording how long it took under 'cause'.
+	static void WaitForFenceValue(QueueType type, uint64 fenceValue, FenceWaitCause cause)
+	{
+		DX12CommandQueue& queue = *s_CommandQueues[IDX(type)];
+		if (queue.IsFenceComplete(fenceValue))
+			return;
+
+		Timer timer;
+		queue.WaitForFenceValue(fenceValue);
+		timer.Update();
+		s_FenceWaitStats.Record(cause, timer.GetElapsedMilliseconds<double>());
+	}
 
 	static Ptr<ResourceHandler<DX12Buffer, Buffer, NUM_BUFFERS>> s_Buffers = nullptr;
 	static Ptr<ResourceHandler<DX12Texture, Texture, NUM_TEXTURES>> s_Textures = nullptr;
 	static Ptr<ResourceHandler<DX12Pipeline, Pipeline, NUM_PIPELINES>> s_Pipelines = nullptr;
+	static Ptr<ResourceHandler<DX12MemoryHeap, MemoryHeap, NUM_MEMORY_HEAPS>> s_MemoryHeaps = nullptr;
+
+	// Pipeline states replaced by a shader reload, released once the frames that may use them are done.
+	static Array<Vector<ID3D12PipelineState*>, MAX_FRAMES_IN_FLIGHT> s_RetiredPipelineStates;
+
+	static void ReleaseRetiredPipelineStates(uint32 frameId)
+	{
+		for (auto& pipelineState : s_RetiredPipelineStates[frameId])
+		{
+			DX12SafeRelease(pipelineState);
+		}
+		s_RetiredPipelineStates[frameId].clear();
+	}
 
 	void Init(WindowHandle windowHandle, const GraphicsParams& params)
 	{
@@ -50,22 +103,37 @@ namespace vast::gfx
 
 		VAST_LOG_TRACE("[gfx] [dx12] Initializing DX12 backend...");
 
+		s_NumFramesInFlight = vast::GetNumFramesInFlight(params.latencyMode);
+		s_FrameId = 0;
+
 		s_Buffers = MakePtr<ResourceHandler<DX12Buffer, Buffer, NUM_BUFFERS>>();
 		s_Textures = MakePtr<ResourceHandler<DX12Texture, Texture, NUM_TEXTURES>>();
 		s_Pipelines = MakePtr<ResourceHandler<DX12Pipeline, Pipeline, NUM_PIPELINES>>();
+		s_MemoryHeaps = MakePtr<ResourceHandler<DX12MemoryHeap, MemoryHeap, NUM_MEMORY_HEAPS>>();
 
 		s_Device = MakePtr<DX12Device>();
 
 		s_CommandQueues[IDX(QueueType::GRAPHICS)] = MakePtr<DX12CommandQueue>(s_Device->GetDevice(), D3D12_COMMAND_LIST_TYPE_DIRECT);
-		// TODO: Async Compute (s_CommandQueues[IDX(QueueType::COMPUTE)] = MakePtr<DX12CommandQueue>(s_Device->GetDevice(), D3D12_COMMAND_LIST_TYPE_COMPUTE);)
+		s_CommandQueues[IDX(QueueType::COMPUTE)] = MakePtr<DX12CommandQueue>(s_Device->GetDevice(), D3D12_COMMAND_LIST_TYPE_COMPUTE);
  		s_CommandQueues[IDX(QueueType::UPLOAD)] = MakePtr<DX12CommandQueue>(s_Device->GetDevice(), D3D12_COMMAND_LIST_TYPE_COPY);
 
 		m_SwapChain = MakePtr<DX12SwapChain>(params.swapChainSize, params.swapChainFormat, params.backBufferFormat, 
 			*s_Device, *s_CommandQueues[IDX(QueueType::GRAPHICS)]->GetQueue(), windowHandle);
 
 		s_GraphicsCommandList = MakePtr<DX12GraphicsCommandList>(*s_Device);
-		// TODO: Async Compute (s_ComputeCommandList = MakePtr<DX12ComputeCommandList>(*s_Device);)
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < NUM_PARALLEL_COMMAND_LISTS; ++i)
+		{
+			s_ParallelCommandLists[i] = MakePtr<DX12GraphicsCommandList>(*s_Device);
+			s_ParallelCommandLists[i]->SetLocalStateTracking(true);
+		}
+		for (auto& cmdList : s_ParallelBarrierCommandLists)
+		{
+			cmdList = MakePtr<DX12CommandList>(*s_Device, D3D12_COMMAND_LIST_TYPE_DIRECT);
+		}
+		s_ComputeCommandList = MakePtr<DX12GraphicsCommandList>(*s_Device, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+		s_ComputeCommandList->SetLocalStateTracking(true);
+		s_ComputeBarrierCommandList = MakePtr<DX12CommandList>(*s_Device, D3D12_COMMAND_LIST_TYPE_COMPUTE);
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			s_UploadCommandLists[i] = MakePtr<DX12UploadCommandList>(*s_Device);
 		}
@@ -78,10 +146,24 @@ namespace vast::gfx
 		VAST_PROFILE_TRACE_FUNCTION;
 
 		WaitForIdle();
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			ReleaseRetiredPipelineStates(i);
+		}
 
 		s_QueryHeap = nullptr;
 		s_GraphicsCommandList = nullptr;
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		s_ComputeCommandList = nullptr;
+		s_ComputeBarrierCommandList = nullptr;
+		for (uint32 i = 0; i < NUM_PARALLEL_COMMAND_LISTS; ++i)
+		{
+			s_ParallelCommandLists[i] = nullptr;
+		}
+		for (auto& cmdList : s_ParallelBarrierCommandLists)
+		{
+			cmdList = nullptr;
+		}
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			s_UploadCommandLists[i] = nullptr;
 		}
@@ -98,64 +180,132 @@ namespace vast::gfx
 		s_Buffers = nullptr;
 		s_Textures = nullptr;
 		s_Pipelines = nullptr;
+		s_MemoryHeaps = nullptr;
 	}
 
 	void BeginFrame()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
+		// Note: Waits are attributed to the frame they block, so last frame's stats are complete here.
+		s_LastFrameFenceWaitStats = s_FenceWaitStats;
+		for (auto& q : s_CommandQueues)
+		{
+			s_LastFrameFenceWaitStats.latency += q->ConsumeWaitLatencyStats();
+		}
+		s_FenceWaitStats = {};
+
 		for (uint32 i = 0; i < IDX(QueueType::COUNT); ++i)
 		{
-			// Wait on fences from NUM_FRAMES_IN_FLIGHT frames ago
-			s_CommandQueues[i]->WaitForFenceValue(s_FrameFenceValues[i][s_FrameId]);
+			// Wait on fences from s_NumFramesInFlight frames ago
+			const QueueType type = static_cast<QueueType>(i);
+			const FenceWaitCause cause = (type == QueueType::UPLOAD) ? FenceWaitCause::UPLOAD : FenceWaitCause::FRAME_PACING;
+			WaitForFenceValue(type, s_FrameFenceValues[i][s_FrameId], cause);
 		}
 
+		// Note: Pipelines created in the background and shader reloads are applied here, before any
+		// commands are recorded for the frame.
+		s_Device->UpdatePipelineCreations();
+		ReleaseRetiredPipelineStates(s_FrameId);
+		s_Device->UpdateShaderReloads(s_RetiredPipelineStates[s_FrameId]);
+
+		s_QueueScheduler.BeginFrame();
+
 		s_UploadCommandLists[s_FrameId]->ResolveProcessedUploads();
 		s_UploadCommandLists[s_FrameId]->Reset(s_FrameId);
+		s_bHasComputeCommandListBeenReset = false;
+		s_bHasComputeBarrierCommandListBeenReset = false;
+		s_bHasParallelBarrierCommandListBeenReset.fill(false);
+
+		// Note: Stats are gathered here so that they include all command lists submitted last frame.
+		s_LastFrameStateCacheStats = s_GraphicsCommandList->GetStateCacheStats();
+		s_GraphicsCommandList->ResetStateCacheStats();
+		for (auto& cmdList : s_ParallelCommandLists)
+		{
+			s_LastFrameStateCacheStats += cmdList->GetStateCacheStats();
+			cmdList->ResetStateCacheStats();
+		}
+		s_LastFrameStateCacheStats += s_ComputeCommandList->GetStateCacheStats();
+		s_ComputeCommandList->ResetStateCacheStats();
 
+		s_Device->GetSRVDescriptorHeap(s_FrameId).Reset();
 		s_GraphicsCommandList->Reset(s_FrameId);
 	}
 
-	void SubmitCommandList(DX12CommandList& cmdList)
+	static uint64 ExecuteCommandLists(QueueType type, ID3D12CommandList* const* cmdLists, uint32 count)
+	{
+		const uint64 fenceValue = s_CommandQueues[IDX(type)]->ExecuteCommandLists(cmdLists, count);
+		s_QueueScheduler.OnExecute(type);
+		s_QueueScheduler.OnSignal(type, fenceValue);
+		return fenceValue;
+	}
+
+	uint64 SubmitCommandList(DX12CommandList& cmdList)
 	{
+		ID3D12CommandList* cmdLists[] = { cmdList.GetCommandList() };
+
 		switch (cmdList.GetCommandType())
 		{
 		case D3D12_COMMAND_LIST_TYPE_DIRECT:
 		{
 			VAST_PROFILE_TRACE_SCOPE("ExecuteCommandList (Graphics)");
-			s_CommandQueues[IDX(QueueType::GRAPHICS)]->ExecuteCommandList(cmdList.GetCommandList());
-			break;
+			return ExecuteCommandLists(QueueType::GRAPHICS, cmdLists, 1);
+		}
+		case D3D12_COMMAND_LIST_TYPE_COMPUTE:
+		{
+			VAST_PROFILE_TRACE_SCOPE("ExecuteCommandList (Compute)");
+			return ExecuteCommandLists(QueueType::COMPUTE, cmdLists, 1);
 		}
-		// TODO: Async Compute (case D3D12_COMMAND_LIST_TYPE_COMPUTE:)
 		case D3D12_COMMAND_LIST_TYPE_COPY:
 		{
 			VAST_PROFILE_TRACE_SCOPE("ExecuteCommandList (Upload)");
-			s_CommandQueues[IDX(QueueType::UPLOAD)]->ExecuteCommandList(cmdList.GetCommandList());
-			break;
+			return ExecuteCommandLists(QueueType::UPLOAD, cmdLists, 1);
 		}
 		default:
 			VAST_ASSERTF(0, "Unsupported context submit type.");
-			break;
+			return 0;
 		}
 	}
 
+	static uint64 SignalQueueFence(QueueType type)
+	{
+		const uint64 fenceValue = s_CommandQueues[IDX(type)]->SignalFence();
+		s_QueueScheduler.OnSignal(type, fenceValue);
+		return fenceValue;
+	}
+
 	void SignalEndOfFrame(QueueType type)
 	{
-		s_FrameFenceValues[IDX(type)][s_FrameId] = s_CommandQueues[IDX(type)]->SignalFence();
+		s_FrameFenceValues[IDX(type)][s_FrameId] = SignalQueueFence(type);
+	}
+
+	// Submits all work recorded so far on the main command list, and reopens it to keep recording.
+	static uint64 FlushGraphicsCommandList()
+	{
+		s_GraphicsCommandList->FlushBarriers();
+		const uint64 fenceValue = SubmitCommandList(*s_GraphicsCommandList);
+		// Note: The allocator is still in use by the GPU, so only the list is reset.
+		s_GraphicsCommandList->Reopen(s_FrameId);
+		return fenceValue;
 	}
 
 	void EndFrame()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
+#ifdef VAST_DEBUG
+		for (uint32 i = 0; i < NUM_PARALLEL_COMMAND_LISTS; ++i)
+		{
+			VAST_ASSERTF(!s_bIsParallelCommandListRecorded[i], "Parallel command list {} was recorded but never submitted.", i);
+		}
+#endif
 
 		DX12Texture& backBuffer = m_SwapChain->GetCurrentBackBuffer();
 		s_GraphicsCommandList->AddBarrier(backBuffer, D3D12_RESOURCE_STATE_PRESENT);
 		s_GraphicsCommandList->FlushBarriers();
 		SubmitCommandList(*s_GraphicsCommandList);
 
-		// TODO: Async Compute. This probably needs to be exposed to the user to submit graphics and compute
-		// command lists in the desired order.
-		// (SubmitCommandList(*s_ComputeCommandList); SignalEndOfFrame(QueueType::COMPUTE);)
+		VAST_ASSERTF(t_BoundCommandList != s_ComputeCommandList.get(), "Async compute recording was never ended.");
+		SignalEndOfFrame(QueueType::COMPUTE);
 
 		s_UploadCommandLists[s_FrameId]->ProcessUploads();
 		SubmitCommandList(*s_UploadCommandLists[s_FrameId]);
@@ -164,7 +314,7 @@ namespace vast::gfx
 		m_SwapChain->Present();
 		SignalEndOfFrame(QueueType::GRAPHICS);
 
-		s_FrameId = (s_FrameId + 1) % NUM_FRAMES_IN_FLIGHT;
+		s_FrameId = (s_FrameId + 1) % s_NumFramesInFlight;
 	}
 
 	uint32 GetFrameId()
@@ -172,13 +322,263 @@ namespace vast::gfx
 		return s_FrameId;
 	}
 
+	void SetNumFramesInFlight(uint32 count)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(count > 0 && count <= MAX_FRAMES_IN_FLIGHT, "Unsupported number of frames in flight.");
+		VAST_LOG_INFO("[gfx] [dx12] Setting number of frames in flight to {}.", count);
+
+		// Note: Frame ids at or above the new count won't be visited again, so all fences are waited
+		// on and any uploads in flight are resolved before restarting the ring.
+		WaitForIdle();
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+		{
+			s_UploadCommandLists[i]->ResolveProcessedUploads();
+			ReleaseRetiredPipelineStates(i);
+		}
+
+		s_NumFramesInFlight = count;
+		s_FrameId = 0;
+	}
+
+	uint32 GetNumFramesInFlight()
+	{
+		return s_NumFramesInFlight;
+	}
+
+	const StateCacheStats& GetLastFrameStateCacheStats()
+	{
+		return s_LastFrameStateCacheStats;
+	}
+
+	const FenceWaitStats& GetLastFrameFenceWaitStats()
+	{
+		return s_LastFrameFenceWaitStats;
+	}
+
+	PipelineCacheStats GetPipelineCacheStats()
+	{
+		VAST_ASSERT(s_Device);
+		return s_Device->GetPipelineCacheStats();
+	}
+
+	void BeginParallelCommandList(uint32 idx)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(idx < NUM_PARALLEL_COMMAND_LISTS, "Parallel command list index out of range.");
+		VAST_ASSERTF(!t_BoundCommandList, "This thread is already recording a parallel command list.");
+		VAST_ASSERTF(!s_bIsParallelCommandListRecorded[idx], "Parallel command list {} was already recorded this frame.", idx);
+
+		// Note: Each list has its own allocator per frame in flight, which is safe to reset here since
+		// the fence for this frame was already waited on in BeginFrame.
+		t_BoundCommandList = s_ParallelCommandLists[idx].get();
+		t_BoundCommandList->Reset(s_FrameId);
+	}
+
+	void EndParallelCommandList(uint32 idx)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(t_BoundCommandList == s_ParallelCommandLists[idx].get(), "Parallel command list {} is not being recorded on this thread.", idx);
+		VAST_ASSERTF(s_RenderPassEndBarriers.empty(), "Render passes cannot span across command lists.");
+
+		t_BoundCommandList->FlushBarriers();
+		t_BoundCommandList = nullptr;
+		s_bIsParallelCommandListRecorded[idx] = true;
+	}
+
+	static DX12CommandList& BeginParallelBarrierCommandList(uint32 idx)
+	{
+		DX12CommandList& cmdList = *s_ParallelBarrierCommandLists[idx];
+		if (!s_bHasParallelBarrierCommandListBeenReset[idx])
+		{
+			cmdList.Reset(s_FrameId);
+			s_bHasParallelBarrierCommandListBeenReset[idx] = true;
+		}
+		else
+		{
+			cmdList.Reopen(s_FrameId);
+		}
+		return cmdList;
+	}
+
+	void SubmitParallelCommandLists(uint32 count)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!t_BoundCommandList, "Parallel command lists must be submitted from the main thread.");
+		VAST_ASSERT(count <= NUM_PARALLEL_COMMAND_LISTS);
+
+		// Lists are submitted in index order, after everything recorded so far in the main command
+		// list. Since the states each list expects to find its resources in are only known now, the
+		// transitions into them are recorded on a globally tracked list that executes right before it:
+		// the main command list for the first one, and a barrier-only list for the rest (see
+		// LocalResourceStates.h).
+		Array<ID3D12CommandList*, NUM_PARALLEL_COMMAND_LISTS * 2> cmdLists = { nullptr };
+		uint32 numCmdLists = 0;
+		cmdLists[numCmdLists++] = s_GraphicsCommandList->GetCommandList();
+
+		Vector<DX12LocalResourceTransition> transitions;
+		for (uint32 i = 0; i < count; ++i)
+		{
+			VAST_ASSERTF(s_bIsParallelCommandListRecorded[i], "Parallel command list {} was not recorded.", i);
+			DX12GraphicsCommandList& cmdList = *s_ParallelCommandLists[i];
+
+			transitions.clear();
+			ResolveLocalResourceStates(cmdList.GetLocalResourceStates(), transitions, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+			if (i == 0 || !transitions.empty())
+			{
+				DX12CommandList& barrierCmdList = (i == 0) ? *s_GraphicsCommandList : BeginParallelBarrierCommandList(i - 1);
+				for (const auto& t : transitions)
+				{
+					barrierCmdList.AddBarrier(*t.resource, t.before, t.after);
+				}
+				barrierCmdList.FlushBarriers();
+
+				if (i > 0)
+				{
+					cmdLists[numCmdLists++] = barrierCmdList.GetCommandList();
+				}
+			}
+
+			cmdLists[numCmdLists++] = cmdList.GetCommandList();
+			s_bIsParallelCommandListRecorded[i] = false;
+		}
+
+		{
+			VAST_PROFILE_TRACE_SCOPE("ExecuteCommandLists (Graphics)");
+			ExecuteCommandLists(QueueType::GRAPHICS, cmdLists.data(), numCmdLists);
+		}
+
+		// Recording on the main command list resumes after the submitted lists. Its allocator is still
+		// in use by the GPU, so only the list is reset.
+		s_GraphicsCommandList->Reopen(s_FrameId);
+	}
+
+	void BeginAsyncCompute()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!t_BoundCommandList, "Async compute must be recorded from the main thread.");
+
+		if (!s_bHasComputeCommandListBeenReset)
+		{
+			s_ComputeCommandList->Reset(s_FrameId);
+			s_bHasComputeCommandListBeenReset = true;
+		}
+		else
+		{
+			s_ComputeCommandList->Reopen(s_FrameId);
+		}
+		t_BoundCommandList = s_ComputeCommandList.get();
+	}
+
+	QueueSyncPoint EndAsyncCompute()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(t_BoundCommandList == s_ComputeCommandList.get(), "Async compute is not being recorded.");
+
+		t_BoundCommandList = nullptr;
+		s_ComputeCommandList->FlushBarriers();
+
+		// The transitions into the states the compute list expects are resolved now, in submission
+		// order, and recorded on globally tracked lists (see LocalResourceStates.h). Transitions from
+		// or into graphics-only states can't be recorded on the compute queue, so they are recorded
+		// on the main command list instead, which is submitted and waited on before the compute work.
+		Vector<DX12LocalResourceTransition> transitions;
+		ResolveLocalResourceStates(s_ComputeCommandList->GetLocalResourceStates(), transitions, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+		bool bNeedsGraphicsTransitions = false;
+		bool bNeedsComputeTransitions = false;
+		for (const auto& t : transitions)
+		{
+			// Note: Waiting on the queue already orders unordered accesses, so no UAV barrier is needed.
+			if (t.before == t.after)
+				continue;
+
+			if ((t.before | t.after) & GRAPHICS_ONLY_RESOURCE_STATES)
+			{
+				s_GraphicsCommandList->AddBarrier(*t.resource, t.before, t.after);
+				bNeedsGraphicsTransitions = true;
+			}
+			else
+			{
+				if (!bNeedsComputeTransitions)
+				{
+					if (!s_bHasComputeBarrierCommandListBeenReset)
+					{
+						s_ComputeBarrierCommandList->Reset(s_FrameId);
+						s_bHasComputeBarrierCommandListBeenReset = true;
+					}
+					else
+					{
+						s_ComputeBarrierCommandList->Reopen(s_FrameId);
+					}
+					bNeedsComputeTransitions = true;
+				}
+				s_ComputeBarrierCommandList->AddBarrier(*t.resource, t.before, t.after);
+			}
+		}
+
+		if (bNeedsGraphicsTransitions)
+		{
+			const uint64 fenceValue = FlushGraphicsCommandList();
+			WaitForSyncPoint(QueueType::COMPUTE, QueueSyncPoint{ QueueType::GRAPHICS, fenceValue });
+		}
+
+		Array<ID3D12CommandList*, 2> cmdLists = { nullptr };
+		uint32 numCmdLists = 0;
+		if (bNeedsComputeTransitions)
+		{
+			s_ComputeBarrierCommandList->FlushBarriers();
+			cmdLists[numCmdLists++] = s_ComputeBarrierCommandList->GetCommandList();
+		}
+		cmdLists[numCmdLists++] = s_ComputeCommandList->GetCommandList();
+
+		VAST_PROFILE_TRACE_SCOPE("ExecuteCommandLists (Compute)");
+		return QueueSyncPoint{ QueueType::COMPUTE, ExecuteCommandLists(QueueType::COMPUTE, cmdLists.data(), numCmdLists) };
+	}
+
+	QueueSyncPoint SignalQueue(QueueType type)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!t_BoundCommandList, "Queues cannot be signaled while recording parallel or async compute work.");
+
+		if (type == QueueType::GRAPHICS)
+		{
+			return QueueSyncPoint{ type, FlushGraphicsCommandList() };
+		}
+		return QueueSyncPoint{ type, SignalQueueFence(type) };
+	}
+
+	void WaitForSyncPoint(QueueType type, QueueSyncPoint syncPoint)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!t_BoundCommandList, "Queue waits cannot be issued while recording parallel or async compute work.");
+		VAST_ASSERTF(type != syncPoint.queue, "A queue cannot wait on itself.");
+
+		if (!s_QueueScheduler.RequestWait(type, syncPoint))
+			return;
+
+		// Work already recorded on the main command list doesn't depend on the sync point, so it is
+		// submitted first to avoid delaying it.
+		if (type == QueueType::GRAPHICS)
+		{
+			FlushGraphicsCommandList();
+		}
+		s_CommandQueues[IDX(type)]->WaitForQueue(*s_CommandQueues[IDX(syncPoint.queue)], syncPoint.value);
+	}
+
+	const QueueScheduler& GetQueueScheduler()
+	{
+		return s_QueueScheduler;
+	}
+
 	void BeginRenderPassToBackBuffer(PipelineHandle h, LoadOp loadOp /* = LoadOp::LOAD */, StoreOp storeOp /* = StoreOp::STORE */)
 	{
 		VAST_ASSERT(s_Pipelines);
-		s_GraphicsCommandList->SetPipeline(&s_Pipelines->LookupResource(h));
+		GetCurrentCommandList().SetPipeline(&s_Pipelines->LookupResource(h));
 
 		DX12Texture& backBuffer = m_SwapChain->GetCurrentBackBuffer();
-		s_GraphicsCommandList->AddBarrier(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+		GetCurrentCommandList().AddBarrier(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
 
 		// Setup backbuffer transitions
 		// Note: No need for an end barrier since we only present once at the end of the frame.
@@ -189,16 +589,16 @@ namespace vast::gfx
 		rpd.rtDesc[0].BeginningAccess.Clear.ClearValue = backBuffer.clearValue;
 		rpd.rtDesc[0].EndingAccess.Type = TranslateToDX12(storeOp);
 
-		s_GraphicsCommandList->FlushBarriers();
-		s_GraphicsCommandList->BeginRenderPass(rpd);
-		s_GraphicsCommandList->SetDefaultViewportAndScissor(m_SwapChain->GetSize());
+		GetCurrentCommandList().FlushBarriers();
+		GetCurrentCommandList().BeginRenderPass(rpd);
+		GetCurrentCommandList().SetDefaultViewportAndScissor(m_SwapChain->GetSize());
 	}
 
 	void BeginRenderPass(PipelineHandle h, const RenderPassDesc desc)
 	{
 		VAST_ASSERT(s_Pipelines);
 		DX12Pipeline& pso = s_Pipelines->LookupResource(h);
-		s_GraphicsCommandList->SetPipeline(&pso);
+		GetCurrentCommandList().SetPipeline(&pso);
 
 #ifdef VAST_DEBUG
 		// Validate user bindings against PSO.
@@ -221,7 +621,7 @@ namespace vast::gfx
 			VAST_ASSERT(desc.rt[i].h.IsValid());
 			DX12Texture& rt = s_Textures->LookupResource(desc.rt[i].h);
 
-			s_GraphicsCommandList->AddBarrier(rt, D3D12_RESOURCE_STATE_RENDER_TARGET);
+			GetCurrentCommandList().AddBarrier(rt, D3D12_RESOURCE_STATE_RENDER_TARGET);
 			if (desc.rt[i].nextUsage != ResourceState::NONE)
 			{
 				s_RenderPassEndBarriers.push_back(std::make_pair(&rt, TranslateToDX12(desc.rt[i].nextUsage)));
@@ -239,7 +639,7 @@ namespace vast::gfx
 		{
 			DX12Texture& ds = s_Textures->LookupResource(desc.ds.h);
 
-			s_GraphicsCommandList->AddBarrier(ds, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+			GetCurrentCommandList().AddBarrier(ds, D3D12_RESOURCE_STATE_DEPTH_WRITE);
 			if (desc.ds.nextUsage != ResourceState::NONE)
 			{
 				s_RenderPassEndBarriers.push_back(std::make_pair(&ds, TranslateToDX12(desc.ds.nextUsage)));
@@ -258,39 +658,58 @@ namespace vast::gfx
 			}
 		}
 
-		s_GraphicsCommandList->FlushBarriers();
-		s_GraphicsCommandList->BeginRenderPass(rpd);
+		GetCurrentCommandList().FlushBarriers();
+		GetCurrentCommandList().BeginRenderPass(rpd);
 
 		// TODO: Figure out something more robust than this.
 		DX12Texture& rt = s_Textures->LookupResource(desc.rt[0].h);
-		s_GraphicsCommandList->SetDefaultViewportAndScissor(uint2(rt.resource->GetDesc().Width, rt.resource->GetDesc().Height));
+		GetCurrentCommandList().SetDefaultViewportAndScissor(uint2(rt.width, rt.height));
 	}
 
 	void EndRenderPass()
 	{
-		s_GraphicsCommandList->EndRenderPass();
+		GetCurrentCommandList().EndRenderPass();
 
 		for (auto i : s_RenderPassEndBarriers)
 		{
-			s_GraphicsCommandList->AddBarrier(*i.first, i.second);
+			GetCurrentCommandList().AddBarrier(*i.first, i.second);
 		}
 		s_RenderPassEndBarriers.clear();
 
-		s_GraphicsCommandList->SetPipeline(nullptr);
+		GetCurrentCommandList().SetPipeline(nullptr);
+	}
+
+	void BindPipeline(PipelineHandle h)
+	{
+		VAST_ASSERT(s_Pipelines);
+		DX12Pipeline& pso = s_Pipelines->LookupResource(h);
+
+#ifdef VAST_DEBUG
+		// Validate that the pipeline renders to the same targets as the one that began the pass.
+		const DX12Pipeline* currPso = GetCurrentCommandList().GetPipeline();
+		VAST_ASSERTF(currPso && !currPso->IsCompute(), "Attempted to bind a pipeline outside of a render pass.");
+		VAST_ASSERTF(!pso.IsCompute(), "Compute pipelines must be bound using BindPipelineForCompute.");
+		VAST_ASSERT(pso.desc.NumRenderTargets == currPso->desc.NumRenderTargets && pso.desc.DSVFormat == currPso->desc.DSVFormat);
+		for (uint32 i = 0; i < pso.desc.NumRenderTargets; ++i)
+		{
+			VAST_ASSERT(pso.desc.RTVFormats[i] == currPso->desc.RTVFormats[i]);
+		}
+#endif
+		GetCurrentCommandList().SetPipeline(&pso);
 	}
 
 	void BindPipelineForCompute(PipelineHandle h)
 	{
 		VAST_ASSERT(s_Pipelines);
 		DX12Pipeline& pso = s_Pipelines->LookupResource(h);
-		s_GraphicsCommandList->SetPipeline(&pso);
+		GetCurrentCommandList().SetPipeline(&pso);
 	}
 
-	void WaitForIdle()
+	void WaitForIdle(FenceWaitCause cause /* = FenceWaitCause::FLUSH */)
 	{
-		for (auto& q : s_CommandQueues)
+		for (uint32 i = 0; i < IDX(QueueType::COUNT); ++i)
 		{
-			q->WaitForIdle();
+			WaitForFenceValue(static_cast<QueueType>(i), s_CommandQueues[i]->GetLastSignaledFenceValue(), cause);
 		}
 	}
 
@@ -298,39 +717,54 @@ namespace vast::gfx
 
 	void AddBarrier(BufferHandle h, ResourceState newState)
 	{
-		s_GraphicsCommandList->AddBarrier(s_Buffers->LookupResource(h), TranslateToDX12(newState));
+		GetCurrentCommandList().AddBarrier(s_Buffers->LookupResource(h), TranslateToDX12(newState));
 	}
 
 	void AddBarrier(TextureHandle h, ResourceState newState)
 	{
-		s_GraphicsCommandList->AddBarrier(s_Textures->LookupResource(h), TranslateToDX12(newState));
+		GetCurrentCommandList().AddBarrier(s_Textures->LookupResource(h), TranslateToDX12(newState));
 	}
 	
+	void AddAliasingBarrier(BufferHandle h)
+	{
+		GetCurrentCommandList().AddAliasingBarrier(s_Buffers->LookupResource(h));
+	}
+
+	void AddAliasingBarrier(TextureHandle h)
+	{
+		GetCurrentCommandList().AddAliasingBarrier(s_Textures->LookupResource(h));
+	}
+
+	void DiscardResource(TextureHandle h)
+	{
+		GetCurrentCommandList().DiscardResource(s_Textures->LookupResource(h));
+	}
+
 	void FlushBarriers()
 	{
-		s_GraphicsCommandList->FlushBarriers();
+		GetCurrentCommandList().FlushBarriers();
 	}
 
 	//
 
 	void BindVertexBuffer(BufferHandle h, uint32 offset /* = 0 */, uint32 stride /* = 0 */)
 	{
-		s_GraphicsCommandList->SetVertexBuffer(s_Buffers->LookupResource(h), offset, stride);
+		GetCurrentCommandList().SetVertexBuffer(s_Buffers->LookupResource(h), offset, stride);
 	}
 
 	void BindIndexBuffer(BufferHandle h, uint32 offset /* = 0 */, IndexBufFormat format /* = IndexBufFormat::R16_UINT */)
 	{
-		s_GraphicsCommandList->SetIndexBuffer(s_Buffers->LookupResource(h), offset, TranslateToDX12(format));
+		GetCurrentCommandList().SetIndexBuffer(s_Buffers->LookupResource(h), offset, TranslateToDX12(format));
 	}
 
 	void BindConstantBuffer(ShaderResourceProxy proxy, BufferHandle h, uint32 offset /* = 0 */)
 	{
-		s_GraphicsCommandList->SetConstantBuffer(s_Buffers->LookupResource(h), offset, proxy.idx);
+		GetCurrentCommandList().SetConstantBuffer(s_Buffers->LookupResource(h), offset, proxy.idx);
 	}
 
 	void SetPushConstants(const void* data, const uint32 size)
 	{
-		s_GraphicsCommandList->SetPushConstants(data, size);
+		GetCurrentCommandList().SetPushConstants(data, size);
 	}
 
 	void CopyToDescriptorTable(const DX12Descriptor& srcDesc)
@@ -339,7 +773,7 @@ namespace vast::gfx
 		// TODO TEMP: We should accumulate all SRV/UAV per shader space and combine them into a single descriptor table.
 		DX12Descriptor blockStart = s_Device->GetSRVDescriptorHeap(s_FrameId).GetUserDescriptorBlockStart(1);
 		s_Device->GetDevice()->CopyDescriptorsSimple(1, blockStart.cpuHandle, srcDesc.cpuHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		s_GraphicsCommandList->SetDescriptorTable(blockStart.gpuHandle);
+		GetCurrentCommandList().SetDescriptorTable(blockStart.gpuHandle);
 	}
 
 	void BindSRV(BufferHandle h)
@@ -364,12 +798,12 @@ namespace vast::gfx
 	void SetScissorRect(int4 rect)
 	{
 		const D3D12_RECT r = { (LONG)rect.x, (LONG)rect.y, (LONG)rect.z, (LONG)rect.w };
-		s_GraphicsCommandList->SetScissorRect(r);
+		GetCurrentCommandList().SetScissorRect(r);
 	}
 
 	void SetBlendFactor(float4 blend)
 	{
-		s_GraphicsCommandList->GetCommandList()->OMSetBlendFactor((float*)&blend);;
+		GetCurrentCommandList().GetCommandList()->OMSetBlendFactor((float*)&blend);;
 	}
 	
 	//
@@ -378,27 +812,27 @@ namespace vast::gfx
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		s_GraphicsCommandList->GetCommandList()->DrawInstanced(vtxCountPerInstance, instCount, vtxStartLocation, instStartLocation);
+		GetCurrentCommandList().GetCommandList()->DrawInstanced(vtxCountPerInstance, instCount, vtxStartLocation, instStartLocation);
 	}
 
 	void DrawIndexedInstanced(uint32 idxCountPerInst, uint32 instCount, uint32 startIdxLocation, uint32 baseVtxLocation, uint32 startInstLocation)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		s_GraphicsCommandList->GetCommandList()->DrawIndexedInstanced(idxCountPerInst, instCount, startIdxLocation, baseVtxLocation, startInstLocation);
+		GetCurrentCommandList().GetCommandList()->DrawIndexedInstanced(idxCountPerInst, instCount, startIdxLocation, baseVtxLocation, startInstLocation);
 	}
 
 	// TODO: Expose topology and index buffer and we can get rid of this.
 	void DrawFullscreenTriangle()
 	{
-		s_GraphicsCommandList->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-		s_GraphicsCommandList->GetCommandList()->IASetIndexBuffer(nullptr);
+		GetCurrentCommandList().SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+		GetCurrentCommandList().ClearIndexBuffer();
 		DrawInstanced(3, 1);
 	}
 
 	void Dispatch(uint3 threadGroupCount)
 	{
-		s_GraphicsCommandList->Dispatch(threadGroupCount);
+		GetCurrentCommandList().Dispatch(threadGroupCount);
 	}
 
 	//
@@ -445,6 +879,39 @@ namespace vast::gfx
 		tex.SetName(name);
 	}
 
+	void CreateMemoryHeap(MemoryHeapHandle h, uint64 size, MemoryHeapType type)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		DX12MemoryHeap& heap = s_MemoryHeaps->AcquireResource(h);
+		s_Device->CreateMemoryHeap(size, type, heap);
+	}
+
+	bool SupportsMixedMemoryHeaps()
+	{
+		return s_Device->SupportsMixedMemoryHeaps();
+	}
+
+	void CreatePlacedBuffer(BufferHandle h, const BufferDesc& desc, MemoryHeapHandle heapHandle, uint64 heapOffset, const std::string& name /* = "" */)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		DX12MemoryHeap& heap = s_MemoryHeaps->LookupResource(heapHandle);
+		DX12Buffer& buf = s_Buffers->AcquireResource(h);
+		s_Device->CreateBuffer(desc, buf, &heap, heapOffset);
+		buf.SetName(name);
+	}
+
+	void CreatePlacedTexture(TextureHandle h, const TextureDesc& desc, MemoryHeapHandle heapHandle, uint64 heapOffset, const std::string& name /* = "" */)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		DX12MemoryHeap& heap = s_MemoryHeaps->LookupResource(heapHandle);
+		DX12Texture& tex = s_Textures->AcquireResource(h);
+		s_Device->CreateTexture(desc, tex, &heap, heapOffset);
+		tex.SetName(name);
+	}
+
 	void CreatePipeline(PipelineHandle h, const PipelineDesc& desc)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
@@ -461,6 +928,34 @@ namespace vast::gfx
 		s_Device->CreateComputePipeline(desc, pso);
 	}
 
+	void CreatePipelineAsync(PipelineHandle h, const PipelineDesc& desc)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		DX12Pipeline& pso = s_Pipelines->AcquireResource(h);
+		s_Device->CreateGraphicsPipelineAsync(desc, pso);
+	}
+
+	void CreatePipelineAsync(PipelineHandle h, const ShaderDesc& desc)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		DX12Pipeline& pso = s_Pipelines->AcquireResource(h);
+		s_Device->CreateComputePipelineAsync(desc, pso);
+	}
+
+	void WaitForPipelineCreation(PipelineHandle h)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		s_Device->WaitForPipelineCreation(h);
+	}
+
+	void PrecompileShaders(const Vector<ShaderDesc>& descs)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		s_Device->PrecompileShaders(descs);
+	}
+
 	void UpdateBuffer(BufferHandle h, const void* srcMem, size_t srcSize)
 	{
 		VAST_ASSERT(srcMem && srcSize);
@@ -482,7 +977,7 @@ namespace vast::gfx
 		}
 		case ResourceUsage::UPLOAD:
 		{
-			const auto dstSize = buf.resource->GetDesc().Width;
+			const auto dstSize = buf.size;
 			VAST_ASSERT(srcSize > 0 && srcSize <= dstSize);
 			uint8* dstMem = buf.data;
 			memcpy(dstMem, srcMem, srcSize);
@@ -545,12 +1040,39 @@ namespace vast::gfx
 		s_UploadCommandLists[s_FrameId]->UploadTexture(std::move(upload));
 	}
 
-	void ReloadShaders(PipelineHandle h)
+	void ReloadShaders(const Vector<PipelineHandle>& handles, const Vector<PipelineHandle>& livePipelines)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		DX12Pipeline& pso = s_Pipelines->LookupResource(h);
-		s_Device->ReloadShaders(pso);
+		auto LookupReadyPipelines = [](const Vector<PipelineHandle>& pipelineHandles)
+		{
+			Vector<DX12Pipeline*> pipelines;
+			pipelines.reserve(pipelineHandles.size());
+			for (const auto& h : pipelineHandles)
+			{
+				DX12Pipeline& pso = s_Pipelines->LookupResource(h);
+				// Note: Pipelines that failed to be created have no shaders to reload.
+				if (pso.hasFailed)
+					continue;
+				VAST_ASSERTF(pso.isReady, "Shaders reloaded before the pipeline finished being created.");
+				pipelines.push_back(&pso);
+			}
+			return pipelines;
+		};
+		s_Device->ReloadShaders(LookupReadyPipelines(handles), LookupReadyPipelines(livePipelines));
+	}
+
+	bool IsReloadingShaders()
+	{
+		VAST_ASSERT(s_Device);
+		return s_Device->IsReloadingShaders();
+	}
+
+	bool PollShaderFileChanges()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERT(s_Device);
+		return s_Device->PollShaderFileChanges();
 	}
 
 	void DestroyBuffer(BufferHandle h)
@@ -580,15 +1102,31 @@ namespace vast::gfx
 		pso.Reset();
 	}
 
-	ShaderResourceProxy LookupShaderResource(PipelineHandle h, const std::string& shaderResourceName)
+	void DestroyMemoryHeap(MemoryHeapHandle h)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		DX12MemoryHeap& heap = s_MemoryHeaps->ReleaseResource(h);
+		s_Device->DestroyMemoryHeap(heap);
+		heap.Reset();
+	}
+
+	ResourceAllocationInfo GetAllocationInfo(const BufferDesc& desc)
+	{
+		return s_Device->GetAllocationInfo(desc);
+	}
+
+	ResourceAllocationInfo GetAllocationInfo(const TextureDesc& desc)
+	{
+		return s_Device->GetAllocationInfo(desc);
+	}
+
+	ShaderResourceProxy LookupShaderResource(PipelineHandle h, ShaderResourceKey key)
 	{
 		VAST_ASSERT(h.IsValid());
 		DX12Pipeline& pso = s_Pipelines->LookupResource(h);
-		if (pso.resourceProxyTable.IsRegistered(shaderResourceName))
-		{
-			return pso.resourceProxyTable.LookupShaderResource(shaderResourceName);
-		}
-		return ShaderResourceProxy{ kInvalidShaderResourceProxy };
+		VAST_ASSERTF(pso.isReady, "Shader resources looked up before the pipeline finished being created.");
+		return pso.resourceProxyTable.LookupShaderResource(key);
 	}
 
 	const uint8* GetBufferData(BufferHandle h)
@@ -610,6 +1148,18 @@ namespace vast::gfx
 		return s_Textures->LookupResource(h).isReady;
 	}
 
+	bool GetIsReady(PipelineHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		return s_Pipelines->LookupResource(h).isReady;
+	}
+
+	bool GetHasFailed(PipelineHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		return s_Pipelines->LookupResource(h).hasFailed;
+	}
+
 	TexFormat GetTextureFormat(TextureHandle h)
 	{
 		VAST_ASSERT(h.IsValid());
@@ -13,9 +13,10 @@ namespace vast
 		, m_CommandList(nullptr)
 		, m_ResourceBarrierQueue({})
 		, m_NumQueuedBarriers(0)
+		, m_bLocalStateTracking(false)
 		, m_CurrentSRVDescriptorHeap(nullptr)
 	{
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			DX12Check(m_Device.GetDevice()->CreateCommandAllocator(m_CommandType, IID_PPV_ARGS(&m_CommandAllocators[i])));
 		}
@@ -27,7 +28,7 @@ namespace vast
 	{
 		DX12SafeRelease(m_CommandList);
 
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			DX12SafeRelease(m_CommandAllocators[i]);
 		}
@@ -48,7 +49,15 @@ namespace vast
 		VAST_PROFILE_TRACE_FUNCTION;
 
 		m_CommandAllocators[frameId]->Reset();
+		Reopen(frameId);
+	}
+
+	void DX12CommandList::Reopen(uint32 frameId)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
 		m_CommandList->Reset(m_CommandAllocators[frameId], nullptr);
+		m_LocalResourceStates.clear();
 		
 		if (m_CommandType != D3D12_COMMAND_LIST_TYPE_COPY)
 		{
@@ -56,6 +65,12 @@ namespace vast
 		}
 	}
 
+	void DX12CommandList::SetLocalStateTracking(bool bEnabled)
+	{
+		VAST_ASSERTF(m_LocalResourceStates.empty(), "Cannot change state tracking mode while recording.");
+		m_bLocalStateTracking = bEnabled;
+	}
+
 	void DX12CommandList::AddBarrier(DX12Resource& resource, D3D12_RESOURCE_STATES newState)
 	{
 		if (m_NumQueuedBarriers >= MAX_QUEUED_BARRIERS)
@@ -63,9 +78,47 @@ namespace vast
 			FlushBarriers();
 		}
 
-		D3D12_RESOURCE_STATES oldState = resource.state;
+		if (m_bLocalStateTracking)
+		{
+			auto it = std::find_if(m_LocalResourceStates.begin(), m_LocalResourceStates.end(), 
+				[&resource](const DX12LocalResourceState& s) { return s.resource == &resource; });
+
+			if (it == m_LocalResourceStates.end())
+			{
+				// First use of the resource in this command list. The state it is in before execution
+				// depends on previously submitted command lists, so the transition is resolved on submit.
+				m_LocalResourceStates.push_back({ &resource, newState, newState });
+				return;
+			}
+
+			AddTransitionBarrier(resource, it->currentState, newState);
+			it->currentState = newState;
+		}
+		else
+		{
+			AddTransitionBarrier(resource, resource.state, newState);
+			resource.state = newState;
+		}
+	}
+
+	void DX12CommandList::AddBarrier(DX12Resource& resource, D3D12_RESOURCE_STATES oldState, D3D12_RESOURCE_STATES newState)
+	{
+		if (m_NumQueuedBarriers >= MAX_QUEUED_BARRIERS)
+		{
+			FlushBarriers();
+		}
 
-		// TODO: Compute exceptions
+		AddTransitionBarrier(resource, oldState, newState);
+	}
+
+	void DX12CommandList::AddTransitionBarrier(DX12Resource& resource, D3D12_RESOURCE_STATES oldState, D3D12_RESOURCE_STATES newState)
+	{
+#ifdef VAST_DEBUG
+		if (m_CommandType == D3D12_COMMAND_LIST_TYPE_COMPUTE)
+		{
+			VAST_ASSERTF(((oldState | newState) & GRAPHICS_ONLY_RESOURCE_STATES) == 0, "Invalid resource transition on a compute command list.");
+		}
+#endif
 
 		if (oldState != newState)
 		{
@@ -78,8 +131,6 @@ namespace vast
 			desc.Transition.StateAfter = newState;
 			desc.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
 
-			resource.state = newState;
-
 #if VAST_ENABLE_LOGGING_RESOURCE_BARRIERS
 			// TODO: Vertex Buffer state will print as Constant Buffer since they share the state after cross translation.
 			VAST_LOG_TRACE("[barrier] Added new barrier transition for resource '{}' ({} -> {})",
@@ -105,6 +156,22 @@ namespace vast
 		}
 	}
 
+	void DX12CommandList::AddAliasingBarrier(DX12Resource& resource)
+	{
+		if (m_NumQueuedBarriers >= MAX_QUEUED_BARRIERS)
+		{
+			FlushBarriers();
+		}
+
+		D3D12_RESOURCE_BARRIER& desc = m_ResourceBarrierQueue[m_NumQueuedBarriers++];
+
+		desc.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+		desc.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		// Note: A null 'before' resource means any placed resource in the heap may have been active.
+		desc.Aliasing.pResourceBefore = nullptr;
+		desc.Aliasing.pResourceAfter = resource.resource;
+	}
+
 	void DX12CommandList::FlushBarriers()
 	{
 		if (m_NumQueuedBarriers == 0)
@@ -125,6 +192,13 @@ namespace vast
 		m_NumQueuedBarriers = 0;
 	}
 
+	void DX12CommandList::DiscardResource(DX12Resource& resource)
+	{
+		// Note: Any pending transitions into the state the resource is discarded in must land first.
+		FlushBarriers();
+		m_CommandList->DiscardResource(resource.resource, nullptr);
+	}
+
 	void DX12CommandList::CopyResource(const DX12Resource& dst, const DX12Resource& src)
 	{
 		m_CommandList->CopyResource(dst.resource, src.resource);
@@ -158,8 +232,9 @@ namespace vast
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
+		// Note: The heap is shared by all command lists recorded during the frame, so it is reset once
+		// at the beginning of the frame rather than here.
 		m_CurrentSRVDescriptorHeap = &m_Device.GetSRVDescriptorHeap(frameId);
-		m_CurrentSRVDescriptorHeap->Reset();
 
 		ID3D12DescriptorHeap* heapsToBind[]
 		{
@@ -194,16 +269,56 @@ namespace vast
 
 	//
 
-	DX12GraphicsCommandList::DX12GraphicsCommandList(DX12Device& device)
-		: DX12CommandList(device, D3D12_COMMAND_LIST_TYPE_DIRECT)
+	DX12GraphicsCommandList::DX12GraphicsCommandList(DX12Device& device, D3D12_COMMAND_LIST_TYPE commandListType /* = D3D12_COMMAND_LIST_TYPE_DIRECT */)
+		: DX12CommandList(device, commandListType)
 		, m_CurrentPipeline(nullptr)
+		, m_StateCacheStats({})
 	{
+		InvalidateStateCache();
 	}
 
 	DX12GraphicsCommandList::~DX12GraphicsCommandList()
 	{
 	}
 
+	void DX12GraphicsCommandList::Reopen(uint32 frameId)
+	{
+		DX12CommandList::Reopen(frameId);
+		InvalidateStateCache();
+	}
+
+	void DX12GraphicsCommandList::InvalidateStateCache()
+	{
+		m_CurrentPipeline = nullptr;
+		m_CurrentPipelineState = nullptr;
+		m_CurrentGraphicsRootSignature = nullptr;
+		m_CurrentComputeRootSignature = nullptr;
+		m_CurrentTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+		m_CurrentViewport = {};
+		m_CurrentScissorRect = {};
+		m_CurrentVertexBufferView = {};
+		m_CurrentIndexBufferView = {};
+		m_GraphicsRootArguments.fill(0);
+		m_ComputeRootArguments.fill(0);
+		m_bIsViewportSet = false;
+		m_bIsScissorRectSet = false;
+		m_bIsIndexBufferSet = false;
+	}
+
+	bool DX12GraphicsCommandList::UpdateRootArgument(uint32 slotIndex, uint64 value)
+	{
+		VAST_ASSERT(slotIndex < MAX_ROOT_PARAMETERS);
+		uint64& currValue = m_CurrentPipeline->IsCompute() ? m_ComputeRootArguments[slotIndex] : m_GraphicsRootArguments[slotIndex];
+		if (currValue == value)
+		{
+			m_StateCacheStats.rootArgument.numElided++;
+			return false;
+		}
+		currValue = value;
+		m_StateCacheStats.rootArgument.numSet++;
+		return true;
+	}
+
 	void DX12GraphicsCommandList::BeginRenderPass(const DX12RenderPassData& rpd)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
@@ -228,46 +343,121 @@ namespace vast
 		if (pipeline)
 		{
 			VAST_PROFILE_TRACE_FUNCTION;
+			VAST_ASSERTF(pipeline->isReady, "Pipeline used before it finished being created.");
 
-			m_CommandList->SetPipelineState(pipeline->pipelineState);
+			if (pipeline->pipelineState != m_CurrentPipelineState)
+			{
+				m_CommandList->SetPipelineState(pipeline->pipelineState);
+				m_CurrentPipelineState = pipeline->pipelineState;
+				m_StateCacheStats.pipeline.numSet++;
+			}
+			else
+			{
+				m_StateCacheStats.pipeline.numElided++;
+			}
+
+			// Note: Changing the root signature invalidates all root arguments for that bind point.
 			if (pipeline->IsCompute())
 			{
-				m_CommandList->SetComputeRootSignature(pipeline->rootSignature);
+				if (pipeline->rootSignature != m_CurrentComputeRootSignature)
+				{
+					m_CommandList->SetComputeRootSignature(pipeline->rootSignature);
+					m_CurrentComputeRootSignature = pipeline->rootSignature;
+					m_ComputeRootArguments.fill(0);
+					m_StateCacheStats.rootSignature.numSet++;
+				}
+				else
+				{
+					m_StateCacheStats.rootSignature.numElided++;
+				}
 			}
 			else
 			{
-				m_CommandList->SetGraphicsRootSignature(pipeline->rootSignature);
+				if (pipeline->rootSignature != m_CurrentGraphicsRootSignature)
+				{
+					m_CommandList->SetGraphicsRootSignature(pipeline->rootSignature);
+					m_CurrentGraphicsRootSignature = pipeline->rootSignature;
+					m_GraphicsRootArguments.fill(0);
+					m_StateCacheStats.rootSignature.numSet++;
+				}
+				else
+				{
+					m_StateCacheStats.rootSignature.numElided++;
+				}
 			}
 		}
 		m_CurrentPipeline = pipeline;
 	}
 
+	void DX12GraphicsCommandList::SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY topology)
+	{
+		if (topology == m_CurrentTopology)
+		{
+			m_StateCacheStats.topology.numElided++;
+			return;
+		}
+
+		m_CommandList->IASetPrimitiveTopology(topology);
+		m_CurrentTopology = topology;
+		m_StateCacheStats.topology.numSet++;
+	}
+
 	void DX12GraphicsCommandList::SetVertexBuffer(const DX12Buffer& buf, uint32 offset, uint32 stride)
 	{
 		VAST_ASSERTF(m_CurrentPipeline, "Attempted to bind vertex shader before setting a render pipeline.");
 
-		auto rscDesc = buf.resource->GetDesc();
-
 		D3D12_VERTEX_BUFFER_VIEW vbv = {};
 		vbv.BufferLocation	= buf.gpuAddress + offset;
-		vbv.SizeInBytes		= static_cast<uint32>(rscDesc.Width) - offset;
+		vbv.SizeInBytes		= static_cast<uint32>(buf.size) - offset;
 		vbv.StrideInBytes	= (stride != 0) ? stride : buf.stride;
 
+		if (vbv.BufferLocation == m_CurrentVertexBufferView.BufferLocation && vbv.SizeInBytes == m_CurrentVertexBufferView.SizeInBytes && 
+			vbv.StrideInBytes == m_CurrentVertexBufferView.StrideInBytes)
+		{
+			m_StateCacheStats.vertexBuffer.numElided++;
+			return;
+		}
+
 		m_CommandList->IASetVertexBuffers(0, 1, &vbv); // TODO: Support setting multiple vertex buffers.
+		m_CurrentVertexBufferView = vbv;
+		m_StateCacheStats.vertexBuffer.numSet++;
 	}
 
 	void DX12GraphicsCommandList::SetIndexBuffer(const DX12Buffer& buf, uint32 offset, DXGI_FORMAT format)
 	{
 		VAST_ASSERTF(m_CurrentPipeline, "Attempted to bind index shader before setting a render pipeline.");
 
-		auto rscDesc = buf.resource->GetDesc();
-
+		// Note: Buffers are always created with an unknown format, so the format must be provided.
 		D3D12_INDEX_BUFFER_VIEW ibv = {};
 		ibv.BufferLocation	= buf.gpuAddress + offset;
-		ibv.SizeInBytes		= static_cast<uint32>(rscDesc.Width) - offset;
-		ibv.Format			= (format != DXGI_FORMAT_UNKNOWN) ? format : rscDesc.Format;
+		ibv.SizeInBytes		= static_cast<uint32>(buf.size) - offset;
+		ibv.Format			= format;
+
+		if (m_bIsIndexBufferSet && ibv.BufferLocation == m_CurrentIndexBufferView.BufferLocation && 
+			ibv.SizeInBytes == m_CurrentIndexBufferView.SizeInBytes && ibv.Format == m_CurrentIndexBufferView.Format)
+		{
+			m_StateCacheStats.indexBuffer.numElided++;
+			return;
+		}
 
 		m_CommandList->IASetIndexBuffer(&ibv);
+		m_CurrentIndexBufferView = ibv;
+		m_bIsIndexBufferSet = true;
+		m_StateCacheStats.indexBuffer.numSet++;
+	}
+
+	void DX12GraphicsCommandList::ClearIndexBuffer()
+	{
+		if (m_bIsIndexBufferSet && m_CurrentIndexBufferView.BufferLocation == 0)
+		{
+			m_StateCacheStats.indexBuffer.numElided++;
+			return;
+		}
+
+		m_CommandList->IASetIndexBuffer(nullptr);
+		m_CurrentIndexBufferView = {};
+		m_bIsIndexBufferSet = true;
+		m_StateCacheStats.indexBuffer.numSet++;
 	}
 
 	void DX12GraphicsCommandList::SetConstantBuffer(const DX12Buffer& buf, uint32 offset, uint32 slotIndex)
@@ -275,13 +465,17 @@ namespace vast
 		VAST_PROFILE_TRACE_FUNCTION;
 		VAST_ASSERTF(m_CurrentPipeline, "Attempted to bind constant buffer before setting a render pipeline."); // TODO: What about global/per frame resources
 
+		const D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = buf.gpuAddress + offset;
+		if (!UpdateRootArgument(slotIndex, gpuAddress))
+			return;
+
 		if (m_CurrentPipeline->IsCompute())
 		{
-			m_CommandList->SetComputeRootConstantBufferView(slotIndex, buf.gpuAddress + offset);
+			m_CommandList->SetComputeRootConstantBufferView(slotIndex, gpuAddress);
 		}
 		else
 		{
-			m_CommandList->SetGraphicsRootConstantBufferView(slotIndex, buf.gpuAddress + offset);
+			m_CommandList->SetGraphicsRootConstantBufferView(slotIndex, gpuAddress);
 		}
 	}
 
@@ -290,6 +484,9 @@ namespace vast
 		VAST_PROFILE_TRACE_FUNCTION;
 		VAST_ASSERTF(m_CurrentPipeline, "Attempted to bind descriptor table before setting a render pipeline."); // TODO: What about global/per frame resources
 
+		if (!UpdateRootArgument(m_CurrentPipeline->descriptorTableIndex, gpuHandle.ptr))
+			return;
+
 		if (m_CurrentPipeline->IsCompute())
 		{
 			m_CommandList->SetComputeRootDescriptorTable(m_CurrentPipeline->descriptorTableIndex, gpuHandle);
@@ -306,6 +503,7 @@ namespace vast
 		VAST_ASSERTF(m_CurrentPipeline, "Attempted to bind push constant before setting a render pipeline.");
 		VAST_ASSERTF(m_CurrentPipeline->pushConstantIndex != UINT8_MAX, "Currently set pipeline does not expect push constant.");
 		// TODO: Support offset parameter.
+		// Note: Push constants are not cached since they are expected to change on every draw.
 		if (m_CurrentPipeline->IsCompute())
 		{
 			m_CommandList->SetComputeRoot32BitConstants(m_CurrentPipeline->pushConstantIndex, size / sizeof(uint32), data, 0);
@@ -332,15 +530,38 @@ namespace vast
 		scissor.bottom = windowSize.y;
 		scissor.right = windowSize.x;
 
+		SetViewport(viewport);
+		SetScissorRect(scissor);
+		SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST); // TODO: This shouldn't be here!
+	}
+
+	void DX12GraphicsCommandList::SetViewport(const D3D12_VIEWPORT& viewport)
+	{
+		if (m_bIsViewportSet && memcmp(&viewport, &m_CurrentViewport, sizeof(D3D12_VIEWPORT)) == 0)
+		{
+			m_StateCacheStats.viewport.numElided++;
+			return;
+		}
+
 		m_CommandList->RSSetViewports(1, &viewport);
-		m_CommandList->RSSetScissorRects(1, &scissor);
-		m_CommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST); // TODO: This shouldn't be here!
+		m_CurrentViewport = viewport;
+		m_bIsViewportSet = true;
+		m_StateCacheStats.viewport.numSet++;
 	}
 
 	void DX12GraphicsCommandList::SetScissorRect(const D3D12_RECT& rect)
 	{
 		// TODO: Support setting multiple rects
+		if (m_bIsScissorRectSet && memcmp(&rect, &m_CurrentScissorRect, sizeof(D3D12_RECT)) == 0)
+		{
+			m_StateCacheStats.scissorRect.numElided++;
+			return;
+		}
+
 		m_CommandList->RSSetScissorRects(1, &rect);
+		m_CurrentScissorRect = rect;
+		m_bIsScissorRectSet = true;
+		m_StateCacheStats.scissorRect.numSet++;
 	}
 
 	void DX12GraphicsCommandList::Dispatch(uint3 threadGroupCount)
@@ -381,14 +602,14 @@ namespace vast
 
 	void DX12UploadCommandList::UploadBuffer(Ptr<BufferUpload> upload)
 	{
-		const auto heapSize = m_BufferUploadHeap->resource->GetDesc().Width;
+		const auto heapSize = m_BufferUploadHeap->size;
 		VAST_ASSERTF(upload->size <= heapSize, "Not enough memory in the BufferUploadHeap to upload {} MB (max: {} MB)", B_TO_MB(upload->size), B_TO_MB(heapSize));
 		m_BufferUploads.push_back(std::move(upload));
 	}
 	
 	void DX12UploadCommandList::UploadTexture(Ptr<TextureUpload> upload)
 	{
-		const auto heapSize = m_TextureUploadHeap->resource->GetDesc().Width;
+		const auto heapSize = m_TextureUploadHeap->size;
 		VAST_ASSERTF(upload->size <= heapSize, "Not enough memory in the TextureUploadHeap to upload {} MB (max: {} MB)", B_TO_MB(upload->size), B_TO_MB(heapSize));
 		m_TextureUploads.push_back(std::move(upload));
 	}
@@ -405,7 +626,7 @@ namespace vast
 		{
 			BufferUpload& currentUpload = *m_BufferUploads[numBuffersProcessed];
 
-			if ((bufferUploadHeapOffset + currentUpload.size) > m_BufferUploadHeap->resource->GetDesc().Width)
+			if ((bufferUploadHeapOffset + currentUpload.size) > m_BufferUploadHeap->size)
 			{
 				break;
 			}
@@ -425,7 +646,7 @@ namespace vast
 		{
 			TextureUpload& currentUpload = *m_TextureUploads[numTexturesProcessed];
 
-			if ((textureUploadHeapOffset + currentUpload.size) > m_TextureUploadHeap->resource->GetDesc().Width)
+			if ((textureUploadHeapOffset + currentUpload.size) > m_TextureUploadHeap->size)
 			{
 				break;
 			}
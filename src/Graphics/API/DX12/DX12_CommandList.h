@@ -1,16 +1,29 @@
 #pragma once
 
 #include "Graphics/API/DX12/DX12_Common.h"
+#include "Graphics/LocalResourceStates.h"
 
 namespace vast
 {
 	constexpr uint32 MAX_QUEUED_BARRIERS = 16;
 	constexpr uint32 MAX_TEXTURE_SUBRESOURCE_COUNT = 128;
+	constexpr uint32 MAX_ROOT_PARAMETERS = 64;
+
+	// Compute queues can't transition resources from or to states that only apply to the graphics
+	// pipeline. These transitions must happen on the graphics queue instead.
+	constexpr D3D12_RESOURCE_STATES GRAPHICS_ONLY_RESOURCE_STATES = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE |
+		D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_DEPTH_WRITE | D3D12_RESOURCE_STATE_DEPTH_READ |
+		D3D12_RESOURCE_STATE_INDEX_BUFFER | D3D12_RESOURCE_STATE_STREAM_OUT | D3D12_RESOURCE_STATE_RESOLVE_DEST |
+		D3D12_RESOURCE_STATE_RESOLVE_SOURCE;
 
 	class DX12Device;
 	class DX12QueryHeap;
 	class DX12RenderPassDescriptorHeap;
 
+	// State of a resource as seen by a command list that tracks states locally.
+	using DX12LocalResourceState = LocalResourceState<DX12Resource, D3D12_RESOURCE_STATES>;
+	using DX12LocalResourceTransition = LocalResourceTransition<DX12Resource, D3D12_RESOURCE_STATES>;
+
 	class DX12CommandList
 	{
 	public:
@@ -21,8 +34,27 @@ namespace vast
 		ID3D12GraphicsCommandList* GetCommandList() const;
 
 		void Reset(uint32 frameId);
+		// Resets the command list for recording without resetting its allocator, so that it can be
+		// reopened right after being submitted within the same frame.
+		virtual void Reopen(uint32 frameId);
+
+		// When enabled, barriers are resolved against a state local to this command list instead of
+		// the global resource state, which makes it safe to record several command lists in parallel.
+		// The transition into the first state of each resource is left for the submitter to resolve
+		// (see GetLocalResourceStates).
+		void SetLocalStateTracking(bool bEnabled);
+		const Vector<DX12LocalResourceState>& GetLocalResourceStates() const { return m_LocalResourceStates; }
+
 		void AddBarrier(DX12Resource& resource, D3D12_RESOURCE_STATES newState);
+		// Records a transition between the given states, regardless of the state tracking mode (e.g.
+		// a transition resolved for a command list that tracks states locally).
+		void AddBarrier(DX12Resource& resource, D3D12_RESOURCE_STATES oldState, D3D12_RESOURCE_STATES newState);
+		// Activates a placed resource whose memory may have been used by another resource in the same heap.
+		void AddAliasingBarrier(DX12Resource& resource);
 		void FlushBarriers();
+		// Marks the contents of a resource as undefined. Render and depth targets activated by an
+		// aliasing barrier must be discarded (or fully cleared) before any other use.
+		void DiscardResource(DX12Resource& resource);
 
 		void CopyResource(const DX12Resource& dst, const DX12Resource& src);
 		void CopyBufferRegion(DX12Resource& dst, uint64 dstOffset, DX12Resource& src, uint64 srcOffset, uint64 numBytes);
@@ -34,15 +66,19 @@ namespace vast
 
 	protected:
 		void BindDescriptorHeaps(uint32 frameId);
+		void AddTransitionBarrier(DX12Resource& resource, D3D12_RESOURCE_STATES oldState, D3D12_RESOURCE_STATES newState);
 
 		DX12Device& m_Device;
 		D3D12_COMMAND_LIST_TYPE m_CommandType;
 
-		Array<ID3D12CommandAllocator*, NUM_FRAMES_IN_FLIGHT> m_CommandAllocators;
+		Array<ID3D12CommandAllocator*, MAX_FRAMES_IN_FLIGHT> m_CommandAllocators;
 		ID3D12GraphicsCommandList4* m_CommandList;
 		Array<D3D12_RESOURCE_BARRIER, MAX_QUEUED_BARRIERS> m_ResourceBarrierQueue;
 		uint32 m_NumQueuedBarriers;
 
+		bool m_bLocalStateTracking;
+		Vector<DX12LocalResourceState> m_LocalResourceStates;
+
 		DX12RenderPassDescriptorHeap* m_CurrentSRVDescriptorHeap;
 	};
 
@@ -56,27 +92,60 @@ namespace vast
 	class DX12GraphicsCommandList final : public DX12CommandList
 	{
 	public:
-		DX12GraphicsCommandList(DX12Device& device);
+		// Note: Compute command lists share the same interface, restricted to compute work.
+		DX12GraphicsCommandList(DX12Device& device, D3D12_COMMAND_LIST_TYPE commandListType = D3D12_COMMAND_LIST_TYPE_DIRECT);
 		~DX12GraphicsCommandList();
 
+		void Reopen(uint32 frameId) override;
+
 		void BeginRenderPass(const DX12RenderPassData& rpd);
 		void EndRenderPass();
 
+		// Note: All state setters below skip the call to the command list if the state is already set.
 		void SetPipeline(DX12Pipeline* pipeline);
+		void SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY topology);
 		void SetVertexBuffer(const DX12Buffer& buf, uint32 offset, uint32 stride);
 		void SetIndexBuffer(const DX12Buffer& buf, uint32 offset, DXGI_FORMAT format);
+		void ClearIndexBuffer();
 		void SetConstantBuffer(const DX12Buffer& buf, uint32 offset, uint32 slotIndex);
 		void SetDescriptorTable(const D3D12_GPU_DESCRIPTOR_HANDLE& gpuHandle);
 		void SetPushConstants(const void* data, const uint32 size);
 		void SetDefaultViewportAndScissor(uint2 windowSize);
+		void SetViewport(const D3D12_VIEWPORT& viewport);
 		void SetScissorRect(const D3D12_RECT& rect);
 		void Dispatch(uint3 threadGroupCount);
 
+		DX12Pipeline* GetPipeline() const { return m_CurrentPipeline; }
+
+		const StateCacheStats& GetStateCacheStats() const { return m_StateCacheStats; }
+		void ResetStateCacheStats() { m_StateCacheStats = {}; }
+
 	private:
+		// Must be called whenever the underlying command list loses its state (i.e. on reset).
+		void InvalidateStateCache();
+		// Returns true if the root argument changed and needs to be set.
+		bool UpdateRootArgument(uint32 slotIndex, uint64 value);
+
 		DX12Pipeline* m_CurrentPipeline;
-	};
 
-	// TODO: Async Compute (DX12ComputeCommandList)
+		// State cache
+		ID3D12PipelineState* m_CurrentPipelineState;
+		ID3D12RootSignature* m_CurrentGraphicsRootSignature;
+		ID3D12RootSignature* m_CurrentComputeRootSignature;
+		D3D_PRIMITIVE_TOPOLOGY m_CurrentTopology;
+		D3D12_VIEWPORT m_CurrentViewport;
+		D3D12_RECT m_CurrentScissorRect;
+		D3D12_VERTEX_BUFFER_VIEW m_CurrentVertexBufferView;
+		D3D12_INDEX_BUFFER_VIEW m_CurrentIndexBufferView;
+		// Root arguments are tracked per bind point, as either a GPU address or a descriptor handle.
+		Array<uint64, MAX_ROOT_PARAMETERS> m_GraphicsRootArguments;
+		Array<uint64, MAX_ROOT_PARAMETERS> m_ComputeRootArguments;
+		bool m_bIsViewportSet;
+		bool m_bIsScissorRectSet;
+		bool m_bIsIndexBufferSet;
+
+		StateCacheStats m_StateCacheStats;
+	};
 
 	struct BufferUpload
 	{
@@ -1,8 +1,35 @@
 #include "vastpch.h"
 #include "Graphics/API/DX12/DX12_CommandQueue.h"
 
+#include <chrono>
+
 namespace vast
 {
+	// Bounds for the time spent polling a fence before blocking. The window grows when waits end
+	// shortly after blocking, and shrinks when they are long enough that spinning only burns CPU.
+	static constexpr uint32 kMinSpinWindowUs = 5;
+	static constexpr uint32 kMaxSpinWindowUs = 200;
+	static constexpr uint32 kInitialSpinWindowUs = 50;
+
+	// Each thread blocks on its own event, so concurrent waiters never contend on a shared one.
+	struct FenceWaitEvent
+	{
+		FenceWaitEvent() : handle(CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS))
+		{
+			VAST_ASSERTF(handle, "Failed to create fence event.");
+		}
+		~FenceWaitEvent() { CloseHandle(handle); }
+
+		HANDLE handle;
+	};
+	static thread_local FenceWaitEvent t_FenceWaitEvent;
+
+	static uint64 GetElapsedMicroseconds(std::chrono::steady_clock::time_point tBegin)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tBegin).count();
+	}
+
+	//
 
 	DX12CommandQueue::DX12CommandQueue(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE commandType /*= D3D12_COMMAND_LIST_TYPE_DIRECT*/)
 		: m_CommandType(commandType)
@@ -10,7 +37,12 @@ namespace vast
 		, m_Fence(nullptr)
 		, m_NextFenceValue(1)
 		, m_LastCompletedFenceValue(0)
-		, m_FenceEventHandle(0)
+		, m_SpinWindowUs(kInitialSpinWindowUs)
+		, m_NumSpinWaits(0)
+		, m_NumBlockingWaits(0)
+		, m_SpinTimeUs(0)
+		, m_BlockTimeUs(0)
+		, m_MaxBlockTimeUs(0)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
@@ -24,17 +56,12 @@ namespace vast
 		DX12Check(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_Fence)));
 
 		m_Fence->Signal(m_LastCompletedFenceValue);
-
-		m_FenceEventHandle = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
-		VAST_ASSERTF(m_FenceEventHandle != INVALID_HANDLE_VALUE, "Failed to create fence event.");
 	}
 
 	DX12CommandQueue::~DX12CommandQueue()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		CloseHandle(m_FenceEventHandle);
-
 		DX12SafeRelease(m_Fence);
 		DX12SafeRelease(m_Queue);
 	}
@@ -56,20 +83,64 @@ namespace vast
 			return;
 		}
 
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		const auto tBegin = std::chrono::steady_clock::now();
+		const uint64 spinWindowUs = m_SpinWindowUs.load(std::memory_order_relaxed);
+
+		// Note: Fences often complete within microseconds of the wait, in which case waking up from a
+		// kernel wait would take longer than the remaining GPU work.
+		uint64 spinTimeUs = 0;
+		while ((spinTimeUs = GetElapsedMicroseconds(tBegin)) < spinWindowUs)
 		{
-			VAST_PROFILE_TRACE_FUNCTION;
+			if (PollCurrentFenceValue() >= fenceValue)
+			{
+				m_NumSpinWaits.fetch_add(1, std::memory_order_relaxed);
+				m_SpinTimeUs.fetch_add(spinTimeUs, std::memory_order_relaxed);
+				return;
+			}
+			YieldProcessor();
+		}
 
-			std::lock_guard<std::mutex> lockGuard(m_EventMutex);
+		DX12Check(m_Fence->SetEventOnCompletion(fenceValue, t_FenceWaitEvent.handle));
+		WaitForSingleObjectEx(t_FenceWaitEvent.handle, INFINITE, false);
+		UpdateLastCompletedFenceValue(fenceValue);
 
-			m_Fence->SetEventOnCompletion(fenceValue, m_FenceEventHandle);
-			WaitForSingleObjectEx(m_FenceEventHandle, INFINITE, false);
-			m_LastCompletedFenceValue = fenceValue;
+		const uint64 blockTimeUs = GetElapsedMicroseconds(tBegin) - spinTimeUs;
+		m_NumBlockingWaits.fetch_add(1, std::memory_order_relaxed);
+		m_SpinTimeUs.fetch_add(spinTimeUs, std::memory_order_relaxed);
+		m_BlockTimeUs.fetch_add(blockTimeUs, std::memory_order_relaxed);
+		uint64 maxBlockTimeUs = m_MaxBlockTimeUs.load(std::memory_order_relaxed);
+		while (blockTimeUs > maxBlockTimeUs && !m_MaxBlockTimeUs.compare_exchange_weak(maxBlockTimeUs, blockTimeUs, std::memory_order_relaxed));
+
+		UpdateSpinWindow(blockTimeUs);
+	}
+
+	void DX12CommandQueue::UpdateSpinWindow(uint64 blockTimeUs)
+	{
+		uint32 spinWindowUs = m_SpinWindowUs.load(std::memory_order_relaxed);
+		if (blockTimeUs < kMaxSpinWindowUs)
+		{
+			// A slightly longer spin would have caught this wait.
+			spinWindowUs = (std::min)(kMaxSpinWindowUs, (std::max)(spinWindowUs * 2, static_cast<uint32>(blockTimeUs)));
+		}
+		else
+		{
+			spinWindowUs = (std::max)(kMinSpinWindowUs, spinWindowUs / 2);
 		}
+		// Note: Concurrent updates may overwrite each other, which is fine for a heuristic.
+		m_SpinWindowUs.store(spinWindowUs, std::memory_order_relaxed);
+	}
+
+	void DX12CommandQueue::UpdateLastCompletedFenceValue(uint64 fenceValue)
+	{
+		uint64 lastCompleted = m_LastCompletedFenceValue.load();
+		while (fenceValue > lastCompleted && !m_LastCompletedFenceValue.compare_exchange_weak(lastCompleted, fenceValue));
 	}
 
 	void DX12CommandQueue::WaitForIdle()
 	{
-		WaitForFenceValue(m_NextFenceValue - 1);
+		WaitForFenceValue(GetLastSignaledFenceValue());
 	}
 
 	void DX12CommandQueue::Flush()
@@ -79,7 +150,7 @@ namespace vast
 
 	uint64 DX12CommandQueue::PollCurrentFenceValue()
 	{
-		m_LastCompletedFenceValue = (std::max)(m_LastCompletedFenceValue, m_Fence->GetCompletedValue());
+		UpdateLastCompletedFenceValue(m_Fence->GetCompletedValue());
 		return m_LastCompletedFenceValue;
 	}
 
@@ -101,6 +172,24 @@ namespace vast
 		return SignalFence();
 	}
 
+	uint64 DX12CommandQueue::ExecuteCommandLists(ID3D12CommandList* const* commandLists, uint32 count)
+	{
+		VAST_ASSERT(commandLists && count);
+		for (uint32 i = 0; i < count; ++i)
+		{
+			DX12Check(static_cast<ID3D12GraphicsCommandList*>(commandLists[i])->Close());
+		}
+		m_Queue->ExecuteCommandLists(count, commandLists);
+
+		return SignalFence();
+	}
+
+	void DX12CommandQueue::WaitForQueue(const DX12CommandQueue& other, uint64 fenceValue)
+	{
+		VAST_ASSERT(&other != this);
+		DX12Check(m_Queue->Wait(other.m_Fence, fenceValue));
+	}
+
 	uint64 DX12CommandQueue::GetTimestampFrequency()
 	{
 		VAST_ASSERT(m_CommandType == D3D12_COMMAND_LIST_TYPE_DIRECT || m_CommandType == D3D12_COMMAND_LIST_TYPE_COMPUTE);
@@ -109,4 +198,15 @@ namespace vast
 		return gpuFrequency;
 	}
 
+	FenceWaitLatencyStats DX12CommandQueue::ConsumeWaitLatencyStats()
+	{
+		FenceWaitLatencyStats stats;
+		stats.numSpinWaits = m_NumSpinWaits.exchange(0, std::memory_order_relaxed);
+		stats.numBlockingWaits = m_NumBlockingWaits.exchange(0, std::memory_order_relaxed);
+		stats.spinTimeUs = m_SpinTimeUs.exchange(0, std::memory_order_relaxed);
+		stats.blockTimeUs = m_BlockTimeUs.exchange(0, std::memory_order_relaxed);
+		stats.maxBlockTimeUs = m_MaxBlockTimeUs.exchange(0, std::memory_order_relaxed);
+		return stats;
+	}
+
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Graphics/API/DX12/DX12_Common.h"
 
+#include <atomic>
+
 namespace vast
 {
 	class DX12CommandQueue
@@ -11,27 +13,47 @@ namespace vast
 		~DX12CommandQueue();
 
 		bool IsFenceComplete(uint64 fenceValue);
+		// Polls the fence for an adaptive spin window before falling back to a kernel wait. Safe to
+		// call concurrently from multiple threads.
 		void WaitForFenceValue(uint64 fenceValue);
 		void WaitForIdle();
 		void Flush();
 
 		uint64 PollCurrentFenceValue();
+		uint64 GetLastSignaledFenceValue() const { return m_NextFenceValue - 1; }
 		uint64 SignalFence();
 		uint64 ExecuteCommandList(ID3D12CommandList* commandList);
+		// Submits all lists in a single batch, in the given order.
+		uint64 ExecuteCommandLists(ID3D12CommandList* const* commandLists, uint32 count);
+		// GPU-side wait. Work submitted to this queue after the call won't start until the fence of
+		// the other queue reaches the given value.
+		void WaitForQueue(const DX12CommandQueue& other, uint64 fenceValue);
 
 		uint64 GetTimestampFrequency();
 
+		// Returns stats for waits since the last call.
+		FenceWaitLatencyStats ConsumeWaitLatencyStats();
+		uint32 GetSpinWindowMicroseconds() const { return m_SpinWindowUs.load(std::memory_order_relaxed); }
+
 		ID3D12CommandQueue* GetQueue() { return m_Queue; }
 
 	private:
+		void UpdateLastCompletedFenceValue(uint64 fenceValue);
+		void UpdateSpinWindow(uint64 blockTimeUs);
+
 		D3D12_COMMAND_LIST_TYPE m_CommandType;
 		ID3D12CommandQueue* m_Queue;
 		ID3D12Fence* m_Fence;
 		uint64 m_NextFenceValue;
-		uint64 m_LastCompletedFenceValue;
-		HANDLE m_FenceEventHandle;
+		std::atomic<uint64> m_LastCompletedFenceValue;
 		std::mutex m_FenceMutex;
-		std::mutex m_EventMutex;
+
+		std::atomic<uint32> m_SpinWindowUs;
+		std::atomic<uint32> m_NumSpinWaits;
+		std::atomic<uint32> m_NumBlockingWaits;
+		std::atomic<uint64> m_SpinTimeUs;
+		std::atomic<uint64> m_BlockTimeUs;
+		std::atomic<uint64> m_MaxBlockTimeUs;
 	};
 
 }
\ No newline at end of file
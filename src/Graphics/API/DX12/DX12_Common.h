@@ -3,6 +3,7 @@
 #include "Graphics/GraphicsTypes.h"
 #include "Graphics/Resources.h"
 #include "Graphics/ShaderResourceProxy.h"
+#include "Graphics/ShaderReflection.h"
 
 #include "dx12/DirectXAgilitySDK/include/d3d12.h"
 #include <dxgi1_6.h>
@@ -13,7 +14,6 @@ namespace D3D12MA
 }
 
 struct IDxcBlob;
-struct ID3D12ShaderReflection;
 
 namespace vast
 {
@@ -88,6 +88,8 @@ namespace vast
 		BufferHandle h;
 
 		uint8* data = nullptr;
+		// Note: Size is cached on creation to avoid querying the resource desc when binding.
+		uint64 size = 0;
 		uint32 stride = 0;
 		ResourceUsage usage = ResourceUsage::DEFAULT;
 		DX12Descriptor cbv = {};
@@ -97,6 +99,7 @@ namespace vast
 		void Reset() override
 		{
 			data = nullptr;
+			size = 0;
 			stride = 0;
 			usage = ResourceUsage::DEFAULT;
 			cbv = {};
@@ -115,9 +118,14 @@ namespace vast
 		DX12Descriptor srv = {};
 		Vector<DX12Descriptor> uav = {};
 		D3D12_CLEAR_VALUE clearValue = {};
+		// Note: Dimensions are cached on creation to avoid querying the resource desc when binding.
+		uint32 width = 0;
+		uint32 height = 0;
 
 		void Reset() override
 		{
+			width = 0;
+			height = 0;
 			rtv = {};
 			dsv = {};
 			srv = {};
@@ -127,11 +135,27 @@ namespace vast
 		}
 	};
 
+	struct DX12MemoryHeap
+	{
+		MemoryHeapHandle h;
+
+		D3D12MA::Allocation* allocation = nullptr;
+		uint64 size = 0;
+		MemoryHeapType type = MemoryHeapType::MIXED;
+
+		void Reset()
+		{
+			allocation = nullptr;
+			size = 0;
+			type = MemoryHeapType::MIXED;
+		}
+	};
+
 	struct DX12Shader
 	{
-		std::string key; // TODO: This is redundant, and could just store a key instead of a full ref on the Pipeline.
+		ShaderKey key = 0; // TODO: This is redundant, and could just store a key instead of a full ref on the Pipeline.
 		IDxcBlob* blob = nullptr;
-		ID3D12ShaderReflection* reflection = nullptr;
+		ShaderReflection reflection;
 	};
 
 	struct DX12Pipeline
@@ -151,10 +175,18 @@ namespace vast
 		uint8 pushConstantIndex = UINT8_MAX;
 		uint8 descriptorTableIndex = UINT8_MAX;
 
+		// Pipelines created in the background aren't ready until they are handed over at the start of
+		// a frame.
+		bool isReady = false;
+		// Set if creating the pipeline in the background failed due to a shader compile error.
+		bool hasFailed = false;
+
 		bool IsCompute() const { return cs != nullptr; }
 
 		void Reset()
 		{
+			isReady = false;
+			hasFailed = false;
 			desc = {};
 			resourceProxyTable.Reset();
 			pushConstantIndex = UINT8_MAX;
@@ -423,6 +455,18 @@ namespace vast
 		}
 	}
 
+	constexpr D3D12_HEAP_FLAGS TranslateToDX12(const MemoryHeapType& v)
+	{
+		switch (v)
+		{
+		case MemoryHeapType::BUFFERS:				return D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		case MemoryHeapType::RT_DS_TEXTURES:		return D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		case MemoryHeapType::NON_RT_DS_TEXTURES:	return D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		case MemoryHeapType::MIXED:					return D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+		default: VAST_ASSERTF(0, "MemoryHeapType not supported on this platform."); return D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+		}
+	}
+
 	constexpr ResourceState TranslateFromDX12(const D3D12_RESOURCE_STATES& v)
 	{
 		switch (v)
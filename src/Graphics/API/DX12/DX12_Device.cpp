@@ -1,6 +1,7 @@
 #include "vastpch.h"
 #include "Graphics/API/DX12/DX12_Device.h"
 #include "Graphics/API/DX12/DX12_ShaderManager.h"
+#include "Graphics/API/DX12/DX12_PipelineLibrary.h"
 #include "Graphics/API/DX12/DX12_CommandList.h"
 #include "Graphics/API/DX12/DX12_CommandQueue.h"
 
@@ -11,8 +12,79 @@
 #include <dxgidebug.h>
 #endif
 
+#include <algorithm>
+#include <future>
+
+#ifdef VAST_DEBUG
+static const char* PIPELINE_LIBRARY_DIR = "../bin/Debug/";
+#else
+static const char* PIPELINE_LIBRARY_DIR = "../bin/Release/";
+#endif
+
 namespace vast
 {
+	// Persistently cache compiled pipeline states across runs.
+	Arg g_DisablePipelineCache("DisablePipelineCache", false);
+	// Share a single root signature between all pipelines whose shaders fit it, so that switching
+	// pipelines never rebinds the root signature.
+	Arg g_UseGlobalRootSignature("UseGlobalRootSignature", false);
+
+	static constexpr uint32 NO_SHADER_RELOAD = UINT32_MAX;
+
+	// Pipeline state recreated in the background for a pipeline with shaders being reloaded.
+	struct DX12PipelineReload
+	{
+		DX12Pipeline* pipeline = nullptr;
+		PipelineHandle h;
+		bool bIsCompute = false;
+		// Per stage (vs, ps, cs), the current shader and the index of its reload if it has one.
+		// Note: Shaders are referenced, since the pipeline could be destroyed while the reload is in progress.
+		Array<Ref<DX12Shader>, 3> shaders = {};
+		Array<uint32, 3> shaderReloadIdx = { NO_SHADER_RELOAD, NO_SHADER_RELOAD, NO_SHADER_RELOAD };
+		// Note: Copied for the same reason.
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
+		ID3D12RootSignature* rootSignature = nullptr;
+
+		D3D12_INPUT_ELEMENT_DESC* inputElementDescs = nullptr;
+		ID3D12PipelineState* pipelineState = nullptr;
+	};
+
+	struct DX12ShaderReloadJob
+	{
+		Vector<DX12ShaderReload> shaderReloads;
+		Vector<DX12PipelineReload> pipelineReloads;
+		std::future<void> future;
+
+		~DX12ShaderReloadJob()
+		{
+			if (future.valid())
+			{
+				future.wait();
+			}
+
+			// Release anything that wasn't handed over when applying the reload.
+			for (auto& reload : pipelineReloads)
+			{
+				DX12SafeRelease(reload.pipelineState);
+				DX12SafeRelease(reload.rootSignature);
+				delete[] reload.inputElementDescs;
+			}
+			for (auto& reload : shaderReloads)
+			{
+				DX12SafeRelease(reload.compiled.blob);
+			}
+		}
+	};
+
+	// Pipeline created in the background, handed over to the pipeline it was requested for once done.
+	struct DX12PipelineCreation
+	{
+		DX12Pipeline* pipeline = nullptr;
+		PipelineHandle h;
+		DX12Pipeline created;
+		std::future<void> future;
+	};
+
 	constexpr D3D_FEATURE_LEVEL GetMinFeatureLevel()
 	{
 		return D3D_FEATURE_LEVEL_11_0;
@@ -48,7 +120,15 @@ namespace vast
 		: m_DXGIFactory(nullptr)
 		, m_Device(nullptr)
 		, m_Allocator(nullptr)
+		, m_ResourceHeapTier(D3D12_RESOURCE_HEAP_TIER_1)
 		, m_ShaderManager(nullptr)
+		, m_ShaderReloadJob(nullptr)
+		, m_PipelineCreations({})
+		, m_PipelineLibrary(nullptr)
+		, m_RootSignatureIndices()
+		, m_RootSignatures({})
+		, m_RootSignatureMutex()
+		, m_GlobalRootSignatureBlob(nullptr)
 		, m_RTVStagingDescriptorHeap(nullptr)
 		, m_DSVStagingDescriptorHeap(nullptr)
 		, m_CBVSRVUAVStagingDescriptorHeap(nullptr)
@@ -82,6 +162,14 @@ namespace vast
 		DX12Check(D3D12CreateDevice(adapter, GetMaxFeatureLevel(adapter), IID_PPV_ARGS(&m_Device)));
 		m_Device->SetName(L"Main GFX Device");
 
+		D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+		DX12Check(m_Device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)));
+		m_ResourceHeapTier = options.ResourceHeapTier;
+		if (!SupportsMixedMemoryHeaps())
+		{
+			VAST_LOG_WARNING("[gfx] [dx12] Device only supports Resource Heap Tier 1, placed buffers, render/depth targets and other textures need separate memory heaps.");
+		}
+
 		VAST_PROFILE_TRACE_BEGIN("Create Memory Allocator");
 		VAST_LOG_TRACE("[gfx] [dx12] Creating memory allocator.");
 		D3D12MA::ALLOCATOR_DESC allocatorDesc =
@@ -125,7 +213,7 @@ namespace vast
 		m_DSVStagingDescriptorHeap = MakePtr<DX12StagingDescriptorHeap>(m_Device, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, NUM_DSV_STAGING_DESCRIPTORS);
 		m_CBVSRVUAVStagingDescriptorHeap = MakePtr<DX12StagingDescriptorHeap>(m_Device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, NUM_SRV_STAGING_DESCRIPTORS);
 
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_CBVSRVUAVRenderPassDescriptorHeaps[i] = MakePtr<DX12RenderPassDescriptorHeap>(m_Device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, NUM_RESERVED_DESCRIPTOR_INDICES, NUM_RENDER_PASS_USER_DESCRIPTORS);
 		}
@@ -135,6 +223,29 @@ namespace vast
 		VAST_LOG_TRACE("[gfx] [dx12] Creating shader manager.");
 		m_ShaderManager = MakePtr<DX12ShaderManager>();
 
+		bool bUseGlobalRootSignature = false;
+		g_UseGlobalRootSignature.Get(bUseGlobalRootSignature);
+		if (bUseGlobalRootSignature)
+		{
+			m_GlobalRootSignatureBlob = m_ShaderManager->CreateGlobalRootSignature();
+		}
+
+		bool bDisablePipelineCache = false;
+		g_DisablePipelineCache.Get(bDisablePipelineCache);
+		if (!bDisablePipelineCache)
+		{
+			// Note: Each application gets its own pipeline library, since saving it drops the pipelines
+			// that weren't used during the run, which would otherwise evict those of other applications.
+			const std::string appName = Filesystem::GetExecutableName();
+			const std::string pipelineLibraryPath = std::string(PIPELINE_LIBRARY_DIR) + (appName.empty() ? "" : appName + "_") + "PipelineCache.bin";
+			VAST_LOG_TRACE("[gfx] [dx12] Loading pipeline library '{}'.", pipelineLibraryPath);
+			m_PipelineLibrary = MakePtr<DX12PipelineLibrary>(m_Device, pipelineLibraryPath);
+			if (!m_PipelineLibrary->IsEnabled())
+			{
+				m_PipelineLibrary = nullptr;
+			}
+		}
+
 		VAST_LOG_TRACE("[gfx] [dx12] Creating default samplers.");
 		CreateSamplers();
 	}
@@ -212,14 +323,31 @@ namespace vast
 		m_DSVStagingDescriptorHeap = nullptr;
 		m_CBVSRVUAVStagingDescriptorHeap = nullptr;
 
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_CBVSRVUAVRenderPassDescriptorHeaps[i] = nullptr;
 		}
 		m_SamplerRenderPassDescriptorHeap = nullptr;
 
+		m_ShaderReloadJob = nullptr;
+		for (auto& creation : m_PipelineCreations)
+		{
+			creation->future.wait();
+			DestroyPipeline(creation->created);
+		}
+		m_PipelineCreations.clear();
+		// Note: Saves any pipeline states created during this run.
+		m_PipelineLibrary = nullptr;
 		m_ShaderManager = nullptr;
 
+		for (auto& rootSignature : m_RootSignatures)
+		{
+			DX12SafeRelease(rootSignature);
+		}
+		m_RootSignatures.clear();
+		m_RootSignatureIndices.Clear();
+		DX12SafeRelease(m_GlobalRootSignatureBlob);
+
 		DX12SafeRelease(m_Allocator);
 		DX12SafeRelease(m_DXGIFactory);
 
@@ -244,7 +372,7 @@ namespace vast
 
 	void DX12Device::CopyDescriptorToReservedTable(DX12Descriptor srvHandle, uint32 heapIndex)
 	{
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			DX12Descriptor dstDesc = m_CBVSRVUAVRenderPassDescriptorHeaps[i]->GetReservedDescriptor(heapIndex);
 			m_Device->CopyDescriptorsSimple(1, dstDesc.cpuHandle, srvHandle.cpuHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
@@ -303,23 +431,19 @@ namespace vast
 		DX12Descriptor samplerDescriptorBlock = m_SamplerRenderPassDescriptorHeap->GetUserDescriptorBlockStart(static_cast<uint32>(IDX(SamplerState::COUNT)));
 		D3D12_CPU_DESCRIPTOR_HANDLE currentSamplerDescriptor = samplerDescriptorBlock.cpuHandle;
 
-		VAST_ASSERT(m_Device && m_ShaderManager);
+		// Note: Shaders refer to samplers by their index in this table (see GetEngineShaderDefines).
+		VAST_ASSERT(m_Device);
 		for (uint32 i = 0; i < IDX(SamplerState::COUNT); ++i)
 		{
 			m_Device->CreateSampler(&samplerDescs[i], currentSamplerDescriptor);
 			currentSamplerDescriptor.ptr += m_SamplerRenderPassDescriptorHeap->GetDescriptorSize();
-
-			size_t bufSize = strlen(g_SamplerNames[i]);
-			std::wstring samplerName(bufSize, L'\0');
-			MultiByteToWideChar(CP_UTF8, 0, g_SamplerNames[i], -1, &samplerName[0], static_cast<int>(bufSize));
-
-			m_ShaderManager->AddGlobalShaderDefine(samplerName + L"=" + std::to_wstring(i));
 		}
 	}
 
-	void DX12Device::CreateBuffer(const BufferDesc& desc, DX12Buffer& outBuf)
+	void DX12Device::CreateBuffer(const BufferDesc& desc, DX12Buffer& outBuf, const DX12MemoryHeap* heap /* = nullptr */, uint64 heapOffset /* = 0 */)
 	{
 		// TODO: Assert wrongful call
+		VAST_ASSERTF(!heap || desc.usage == ResourceUsage::DEFAULT, "Placed buffers are only supported for default usage.");
 
 		outBuf.usage = desc.usage;
 		outBuf.stride = desc.stride;
@@ -354,11 +478,21 @@ namespace vast
 			rscDesc.Width = static_cast<UINT64>(AlignU32(static_cast<uint32>(rscDesc.Width), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT));
 		}
 
-		// TODO: Do we need dynamic * NUM_FRAMES_IN_FLIGHT buffers?
-		//rscDesc.Width *= NUM_FRAMES_IN_FLIGHT;
+		// TODO: Do we need dynamic * MAX_FRAMES_IN_FLIGHT buffers?
+		//rscDesc.Width *= MAX_FRAMES_IN_FLIGHT;
 
-		m_Allocator->CreateResource(&allocDesc, &rscDesc, outBuf.state, nullptr, &outBuf.allocation, IID_PPV_ARGS(&outBuf.resource));
+		if (heap)
+		{
+			VAST_ASSERT(heap->allocation);
+			VAST_ASSERTF(heap->type == MemoryHeapType::BUFFERS || heap->type == MemoryHeapType::MIXED, "Memory heap can't hold buffers.");
+			DX12Check(m_Allocator->CreateAliasingResource(heap->allocation, heapOffset, &rscDesc, outBuf.state, nullptr, IID_PPV_ARGS(&outBuf.resource)));
+		}
+		else
+		{
+			m_Allocator->CreateResource(&allocDesc, &rscDesc, outBuf.state, nullptr, &outBuf.allocation, IID_PPV_ARGS(&outBuf.resource));
+		}
 		outBuf.gpuAddress = outBuf.resource->GetGPUVirtualAddress();
+		outBuf.size = rscDesc.Width;
 
 		if (hasCBV)
 		{
@@ -432,7 +566,7 @@ namespace vast
 		return mipCount;
 	}
 
-	void DX12Device::CreateTexture(const TextureDesc& desc, DX12Texture& outTex)
+	void DX12Device::CreateTexture(const TextureDesc& desc, DX12Texture& outTex, const DX12MemoryHeap* heap /* = nullptr */, uint64 heapOffset /* = 0 */)
 	{
 		VAST_ASSERTF(desc.width > 0 && desc.height > 0 && desc.depthOrArraySize > 0, "Invalid texture size.");
 		VAST_ASSERTF(desc.mipCount <= MipLevelCount(desc.width, desc.height, desc.depthOrArraySize), "Invalid mip count.");
@@ -500,11 +634,23 @@ namespace vast
 
 		outTex.state = rscState;
 
-		D3D12MA::ALLOCATION_DESC allocationDesc = {};
-		allocationDesc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
-		// TODO: For texture readback we need to treat the resource as a Buffer... or just use a Buffer.
-		m_Allocator->CreateResource(&allocationDesc, &rscDesc, rscState,
-			(!hasRTV && !hasDSV) ? nullptr : &outTex.clearValue, &outTex.allocation, IID_PPV_ARGS(&outTex.resource));
+		const D3D12_CLEAR_VALUE* clearValue = (!hasRTV && !hasDSV) ? nullptr : &outTex.clearValue;
+		if (heap)
+		{
+			VAST_ASSERT(heap->allocation);
+			VAST_ASSERTF(heap->type == ((hasRTV || hasDSV) ? MemoryHeapType::RT_DS_TEXTURES : MemoryHeapType::NON_RT_DS_TEXTURES) || heap->type == MemoryHeapType::MIXED, "Memory heap can't hold this kind of texture.");
+			DX12Check(m_Allocator->CreateAliasingResource(heap->allocation, heapOffset, &rscDesc, rscState, clearValue, IID_PPV_ARGS(&outTex.resource)));
+		}
+		else
+		{
+			D3D12MA::ALLOCATION_DESC allocationDesc = {};
+			allocationDesc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+			// TODO: For texture readback we need to treat the resource as a Buffer... or just use a Buffer.
+			m_Allocator->CreateResource(&allocationDesc, &rscDesc, rscState, clearValue, &outTex.allocation, IID_PPV_ARGS(&outTex.resource));
+		}
+
+		outTex.width = static_cast<uint32>(rscDesc.Width);
+		outTex.height = rscDesc.Height;
 
 		// TODO: Should TextureDesc be more explicit in whether a texture is a cubemap or not?
 		bool bIsCubemap = (desc.type == TexType::TEXTURE_2D) && (desc.depthOrArraySize == 6);
@@ -634,48 +780,118 @@ namespace vast
 		}
 	}
 
-	void DX12Device::CreateGraphicsPipeline(const PipelineDesc& desc, DX12Pipeline& outPipeline)
+	// Identifies a pipeline state in the pipeline library. The pipeline key doesn't account for the
+	// contents of the shaders, so their bytecode and the root signature generated from their
+	// reflection are hashed too.
+	static uint64 MakePipelineLibraryKey(PipelineKey pipelineKey, ID3DBlob* rootSignatureBlob, std::initializer_list<D3D12_SHADER_BYTECODE> shaders)
+	{
+		Hasher hasher;
+		hasher.Add(pipelineKey);
+		hasher.AddBytes(rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize());
+		for (const auto& shader : shaders)
+		{
+			hasher.AddBytes(shader.pShaderBytecode, shader.BytecodeLength);
+		}
+		return hasher.Get();
+	}
+
+	ID3D12RootSignature* DX12Device::AcquireRootSignature(ID3DBlob* rootSignatureBlob)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		// Note: Most pipelines share the same layout (e.g. bindless with push constants), and sharing
+		// the root signature object also lets command lists skip setting it when switching between them.
+		const uint64 key = HashBytes(rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize());
+
+		std::lock_guard<std::mutex> lock(m_RootSignatureMutex);
+		ID3D12RootSignature* rootSignature = nullptr;
+		if (const uint32* idx = m_RootSignatureIndices.Find(key))
+		{
+			rootSignature = m_RootSignatures[*idx];
+		}
+		else
+		{
+			DX12Check(m_Device->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature)));
+			m_RootSignatureIndices.Insert(key, static_cast<uint32>(m_RootSignatures.size()));
+			m_RootSignatures.push_back(rootSignature);
+			VAST_LOG_TRACE("[gfx] [dx12] Created root signature ({} unique).", m_RootSignatures.size());
+		}
+
+		rootSignature->AddRef();
+		return rootSignature;
+	}
+
+	ID3DBlob* DX12Device::CreatePipelineRootSignature(DX12Pipeline& pipeline)
+	{
+		if (m_GlobalRootSignatureBlob)
+		{
+			if (m_ShaderManager->MapToGlobalRootSignature(pipeline))
+			{
+				m_GlobalRootSignatureBlob->AddRef();
+				return m_GlobalRootSignatureBlob;
+			}
+			VAST_LOG_WARNING("[gfx] [dx12] Pipeline doesn't fit the global root signature, falling back to its own.");
+		}
+		return m_ShaderManager->CreateRootSignatureFromReflection(pipeline);
+	}
+
+	D3D12_INPUT_ELEMENT_DESC* DX12Device::CreateInputLayoutFromReflection(const ShaderReflection& reflection, uint32& outNumElements) const
+	{
+		// Note: Semantic names point into the reflection data, so the layout is only valid for as long
+		// as the shader it was created from.
+		const auto& params = reflection.inputParameters;
+		D3D12_INPUT_ELEMENT_DESC* inputElementDescs = new D3D12_INPUT_ELEMENT_DESC[params.size()]{};
+		for (uint32 i = 0; i < params.size(); ++i)
+		{
+			D3D12_INPUT_ELEMENT_DESC& element = inputElementDescs[i];
+
+			element.SemanticName = params[i].semanticName.c_str();
+			element.SemanticIndex = params[i].semanticIndex;
+			element.Format = ConvertToDXGIFormat(static_cast<D3D_REGISTER_COMPONENT_TYPE>(params[i].componentType), params[i].mask);
+			element.InputSlot = 0;
+			element.AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+			// TODO: There doesn't seem to be a good way to automate instanced data.
+			element.InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+			element.InstanceDataStepRate = (element.InputSlotClass == D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA) ? 1 : 0;
+		}
+		outNumElements = static_cast<uint32>(params.size());
+		return inputElementDescs;
+	}
+
+	bool DX12Device::CreateGraphicsPipeline(const PipelineDesc& desc, DX12Pipeline& outPipeline, bool bWaitForShaderFixes /* = true */)
 	{
 		D3D12_GRAPHICS_PIPELINE_STATE_DESC psDesc = {};
 
+		// Compile all stages in parallel up front.
+		Vector<ShaderDesc> stages;
+		if (desc.vs.type != ShaderType::UNKNOWN) stages.push_back(desc.vs);
+		if (desc.ps.type != ShaderType::UNKNOWN) stages.push_back(desc.ps);
+		Vector<Ref<DX12Shader>> shaders = bWaitForShaderFixes ? m_ShaderManager->LoadShaders(stages) : m_ShaderManager->TryLoadShaders(stages);
+		if (std::find(shaders.begin(), shaders.end(), nullptr) != shaders.end())
+			return false;
+
+		uint32 stageIdx = 0;
 		if (desc.vs.type != ShaderType::UNKNOWN)
 		{
 			VAST_ASSERT(desc.vs.type == ShaderType::VERTEX);
-			outPipeline.vs = m_ShaderManager->LoadShader(desc.vs);
+			outPipeline.vs = shaders[stageIdx++];
 			psDesc.VS.pShaderBytecode = outPipeline.vs->blob->GetBufferPointer();
 			psDesc.VS.BytecodeLength = outPipeline.vs->blob->GetBufferSize();
 
-			// Retrieve Input Layout from reflection
-			auto paramsDesc = m_ShaderManager->GetInputParametersFromReflection(outPipeline.vs->reflection);
-			D3D12_INPUT_ELEMENT_DESC* inputElementDescs = new D3D12_INPUT_ELEMENT_DESC[paramsDesc.size()]{};
-			for (uint32 i = 0; i < paramsDesc.size(); ++i)
-			{
-				D3D12_INPUT_ELEMENT_DESC& element = inputElementDescs[i];
-
-				element.SemanticName = paramsDesc[i].SemanticName;
-				element.SemanticIndex = paramsDesc[i].SemanticIndex;
-				element.Format = ConvertToDXGIFormat(paramsDesc[i].ComponentType, paramsDesc[i].Mask);
-				element.InputSlot = 0;
-				element.AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
-				// TODO: There doesn't seem to be a good way to automate instanced data.
-				element.InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
-				element.InstanceDataStepRate = (element.InputSlotClass == D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA) ? 1 : 0;
-			}
-			psDesc.InputLayout.pInputElementDescs = inputElementDescs;
-			psDesc.InputLayout.NumElements = static_cast<uint32>(paramsDesc.size());
+			psDesc.InputLayout.pInputElementDescs = CreateInputLayoutFromReflection(outPipeline.vs->reflection, psDesc.InputLayout.NumElements);
 		}
 
 		if (desc.ps.type != ShaderType::UNKNOWN)
 		{
 			VAST_ASSERT(desc.ps.type == ShaderType::PIXEL);
-			outPipeline.ps = m_ShaderManager->LoadShader(desc.ps);
+			outPipeline.ps = shaders[stageIdx++];
 			psDesc.PS.pShaderBytecode = outPipeline.ps->blob->GetBufferPointer();
 			psDesc.PS.BytecodeLength = outPipeline.ps->blob->GetBufferSize();
 		}
 
-		// Create root signature from reflection
-		ID3DBlob* rootSignatureBlob = m_ShaderManager->CreateRootSignatureFromReflection(outPipeline);
-		DX12Check(m_Device->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&psDesc.pRootSignature)));
+		ID3DBlob* rootSignatureBlob = CreatePipelineRootSignature(outPipeline);
+		psDesc.pRootSignature = AcquireRootSignature(rootSignatureBlob);
+		const uint64 pipelineLibraryKey = MakePipelineLibraryKey(MakePipelineKey(desc), rootSignatureBlob, { psDesc.VS, psDesc.PS });
 		DX12SafeRelease(rootSignatureBlob);
 		outPipeline.rootSignature = psDesc.pRootSignature;
 
@@ -743,22 +959,37 @@ namespace vast
 
 		{
 			VAST_PROFILE_TRACE_SCOPE("CreateGraphicsPipelineState (DX12)");
-			DX12Check(m_Device->CreateGraphicsPipelineState(&psDesc, IID_PPV_ARGS(&outPipeline.pipelineState)));
+			if (m_PipelineLibrary)
+			{
+				outPipeline.pipelineState = m_PipelineLibrary->CreateGraphicsPipelineState(pipelineLibraryKey, psDesc);
+			}
+			else
+			{
+				DX12Check(m_Device->CreateGraphicsPipelineState(&psDesc, IID_PPV_ARGS(&outPipeline.pipelineState)));
+			}
 		}
 		outPipeline.desc = psDesc;
+		outPipeline.isReady = true;
+		outPipeline.hasFailed = false;
+		return true;
 	}
 
-	void DX12Device::CreateComputePipeline(const ShaderDesc& desc, DX12Pipeline& outPipeline)
+	bool DX12Device::CreateComputePipeline(const ShaderDesc& desc, DX12Pipeline& outPipeline, bool bWaitForShaderFixes /* = true */)
 	{
 		D3D12_COMPUTE_PIPELINE_STATE_DESC psDesc = {};
 
 		VAST_ASSERT(desc.type == ShaderType::COMPUTE);
-		outPipeline.cs = m_ShaderManager->LoadShader(desc);
+		Ref<DX12Shader> cs = bWaitForShaderFixes ? m_ShaderManager->LoadShader(desc) : m_ShaderManager->TryLoadShaders({ desc })[0];
+		if (cs == nullptr)
+			return false;
+
+		outPipeline.cs = cs;
 		psDesc.CS.pShaderBytecode = outPipeline.cs->blob->GetBufferPointer();
 		psDesc.CS.BytecodeLength = outPipeline.cs->blob->GetBufferSize();
 
-		ID3DBlob* rootSignatureBlob = m_ShaderManager->CreateRootSignatureFromReflection(outPipeline);
-		DX12Check(m_Device->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&psDesc.pRootSignature)));
+		ID3DBlob* rootSignatureBlob = CreatePipelineRootSignature(outPipeline);
+		psDesc.pRootSignature = AcquireRootSignature(rootSignatureBlob);
+		const uint64 pipelineLibraryKey = MakePipelineLibraryKey(MakePipelineKey(desc), rootSignatureBlob, { psDesc.CS });
 		DX12SafeRelease(rootSignatureBlob);
 		outPipeline.rootSignature = psDesc.pRootSignature;
 
@@ -766,56 +997,341 @@ namespace vast
 
 		{
 			VAST_PROFILE_TRACE_SCOPE("CreateComputePipelineState (DX12)");
-			DX12Check(m_Device->CreateComputePipelineState(&psDesc, IID_PPV_ARGS(&outPipeline.pipelineState)));
+			if (m_PipelineLibrary)
+			{
+				outPipeline.pipelineState = m_PipelineLibrary->CreateComputePipelineState(pipelineLibraryKey, psDesc);
+			}
+			else
+			{
+				DX12Check(m_Device->CreateComputePipelineState(&psDesc, IID_PPV_ARGS(&outPipeline.pipelineState)));
+			}
 		}
+		outPipeline.isReady = true;
+		outPipeline.hasFailed = false;
+		return true;
 	}
 
-	void DX12Device::ReloadShaders(DX12Pipeline& pipeline)
+	void DX12Device::CreateGraphicsPipelineAsync(const PipelineDesc& desc, DX12Pipeline& outPipeline)
 	{
-		if (pipeline.IsCompute())
-		{
-			VAST_ASSERT(pipeline.cs != nullptr);
+		VAST_PROFILE_TRACE_FUNCTION;
 
-			if (!m_ShaderManager->ReloadShader(pipeline.cs))
+		auto creation = MakePtr<DX12PipelineCreation>();
+		creation->pipeline = &outPipeline;
+		creation->h = outPipeline.h;
+		outPipeline.hasFailed = false;
+		// Note: The desc is copied, since the caller's copy may not outlive the creation.
+		creation->future = std::async(std::launch::async, [this, desc, &created = creation->created]()
 			{
-				return;
-			}
+				VAST_PROFILE_TRACE_SCOPE("Create Graphics Pipeline (Async)");
+				// Note: Nobody can fix a shader compile error while waiting on a background thread.
+				CreateGraphicsPipeline(desc, created, false);
+			});
+		m_PipelineCreations.push_back(std::move(creation));
+	}
 
-			D3D12_COMPUTE_PIPELINE_STATE_DESC psDesc = {};
-			psDesc.CS.pShaderBytecode = pipeline.cs->blob->GetBufferPointer();
-			psDesc.CS.BytecodeLength = pipeline.cs->blob->GetBufferSize();
+	void DX12Device::CreateComputePipelineAsync(const ShaderDesc& desc, DX12Pipeline& outPipeline)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
 
-			psDesc.pRootSignature = pipeline.rootSignature;
-			psDesc.NodeMask = 0;
+		auto creation = MakePtr<DX12PipelineCreation>();
+		creation->pipeline = &outPipeline;
+		creation->h = outPipeline.h;
+		outPipeline.hasFailed = false;
+		creation->future = std::async(std::launch::async, [this, desc, &created = creation->created]()
+			{
+				VAST_PROFILE_TRACE_SCOPE("Create Compute Pipeline (Async)");
+				// Note: Nobody can fix a shader compile error while waiting on a background thread.
+				CreateComputePipeline(desc, created, false);
+			});
+		m_PipelineCreations.push_back(std::move(creation));
+	}
 
-			DX12SafeRelease(pipeline.pipelineState);
-			DX12Check(m_Device->CreateComputePipelineState(&psDesc, IID_PPV_ARGS(&pipeline.pipelineState)));
+	bool DX12Device::HandOverPipelineCreation(DX12PipelineCreation& creation)
+	{
+		// Note: The pipeline may have been destroyed, and its slot reused, while being created.
+		DX12Pipeline& pipeline = *creation.pipeline;
+		if (pipeline.h != creation.h)
+		{
+			DestroyPipeline(creation.created);
+			return false;
 		}
-		else
+
+		// Note: Failed pipelines stay not ready, so that callers keep using their fallback. Creating
+		// them again retries.
+		if (!creation.created.isReady)
 		{
-			if (pipeline.vs != nullptr)
+			VAST_LOG_ERROR("[gfx] [dx12] Failed to create pipeline in the background due to a shader compile error.");
+			pipeline.hasFailed = true;
+			return false;
+		}
+
+		pipeline = std::move(creation.created);
+		pipeline.h = creation.h;
+		return true;
+	}
+
+	void DX12Device::UpdatePipelineCreations()
+	{
+		if (m_PipelineCreations.empty())
+			return;
+
+		VAST_PROFILE_TRACE_FUNCTION;
+		uint32 numCreatedPipelines = 0;
+		std::erase_if(m_PipelineCreations, [&](const Ptr<DX12PipelineCreation>& creation)
 			{
-				if (!m_ShaderManager->ReloadShader(pipeline.vs))
+				if (creation->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+					return false;
+
+				if (HandOverPipelineCreation(*creation))
 				{
-					return;
+					numCreatedPipelines++;
+				}
+				return true;
+			});
+
+		if (numCreatedPipelines > 0)
+		{
+			VAST_LOG_TRACE("[gfx] [dx12] Finished creating {} pipelines in the background ({} in progress).", numCreatedPipelines, m_PipelineCreations.size());
+		}
+	}
+
+	void DX12Device::WaitForPipelineCreation(PipelineHandle h)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		auto it = std::find_if(m_PipelineCreations.begin(), m_PipelineCreations.end(), [h](const Ptr<DX12PipelineCreation>& creation) { return creation->h == h; });
+		if (it == m_PipelineCreations.end())
+			return;
+
+		(*it)->future.wait();
+		HandOverPipelineCreation(**it);
+		m_PipelineCreations.erase(it);
+	}
+
+	void DX12Device::PrecompileShaders(const Vector<ShaderDesc>& descs)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		m_ShaderManager->LoadShaders(descs);
+	}
+
+	void DX12Device::ReloadShaders(const Vector<DX12Pipeline*>& pipelines, const Vector<DX12Pipeline*>& livePipelines)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!IsReloadingShaders(), "A shader reload is already in progress.");
+
+		// Shaders may be shared by multiple pipelines, but only need to be compiled once.
+		Vector<Ref<DX12Shader>> shaders;
+		for (const auto pipeline : pipelines)
+		{
+			for (const auto& shader : { pipeline->vs, pipeline->ps, pipeline->cs })
+			{
+				if (shader != nullptr && std::find(shaders.begin(), shaders.end(), shader) == shaders.end())
+				{
+					shaders.push_back(shader);
 				}
-				pipeline.desc.VS.pShaderBytecode = pipeline.vs->blob->GetBufferPointer();
-				pipeline.desc.VS.BytecodeLength = pipeline.vs->blob->GetBufferSize();
 			}
+		}
+
+		auto job = MakePtr<DX12ShaderReloadJob>();
+		job->shaderReloads = m_ShaderManager->PrepareShaderReloads(shaders);
+		if (job->shaderReloads.empty())
+			return;
+
+		auto FindShaderReloadIdx = [&](const Ref<DX12Shader>& shader)
+		{
+			for (uint32 i = 0; i < job->shaderReloads.size(); ++i)
+			{
+				if (job->shaderReloads[i].shader == shader)
+					return i;
+			}
+			return NO_SHADER_RELOAD;
+		};
+
+		// Note: Reloaded shaders are no longer considered out of date, so any pipeline still using the
+		// old version of one would keep it until its files change again.
+		for (const auto pipeline : livePipelines)
+		{
+			DX12PipelineReload reload;
+			bool bHasShaderReloads = false;
+			const Ref<DX12Shader> stages[] = { pipeline->vs, pipeline->ps, pipeline->cs };
+			for (uint32 i = 0; i < NELEM(stages); ++i)
+			{
+				reload.shaders[i] = stages[i];
+				reload.shaderReloadIdx[i] = stages[i] ? FindShaderReloadIdx(stages[i]) : NO_SHADER_RELOAD;
+				bHasShaderReloads |= (reload.shaderReloadIdx[i] != NO_SHADER_RELOAD);
+			}
+			if (!bHasShaderReloads)
+				continue;
+
+			reload.pipeline = pipeline;
+			reload.h = pipeline->h;
+			reload.bIsCompute = pipeline->IsCompute();
+			reload.desc = pipeline->desc;
+			reload.desc.InputLayout = {};
+			reload.rootSignature = pipeline->rootSignature;
+			reload.rootSignature->AddRef();
+			job->pipelineReloads.push_back(reload);
+		}
 
-			if (pipeline.ps != nullptr)
+		m_ShaderReloadJob = std::move(job);
+		m_ShaderReloadJob->future = std::async(std::launch::async, [this, &job = *m_ShaderReloadJob]()
 			{
-				if (!m_ShaderManager->ReloadShader(pipeline.ps))
+				VAST_PROFILE_TRACE_SCOPE("Shader Reload");
+				m_ShaderManager->CompileShaderReloads(job.shaderReloads);
+				for (uint32 i = 0; i < job.pipelineReloads.size(); ++i)
 				{
-					return;
+					CreateReloadedPipelineState(job, i);
 				}
-				pipeline.desc.PS.pShaderBytecode = pipeline.ps->blob->GetBufferPointer();
-				pipeline.desc.PS.BytecodeLength = pipeline.ps->blob->GetBufferSize();
+			});
+	}
+
+	void DX12Device::CreateReloadedPipelineState(DX12ShaderReloadJob& job, uint32 pipelineReloadIdx)
+	{
+		DX12PipelineReload& reload = job.pipelineReloads[pipelineReloadIdx];
+
+		// Pipelines are only recreated once all of their changed shaders compiled successfully.
+		// Note: Reloaded pipeline states are not added to the pipeline library, since they are likely
+		// to be short-lived iterations on a shader that would only bloat it.
+		DX12Shader* shaders[3] = {};
+		for (uint32 i = 0; i < NELEM(shaders); ++i)
+		{
+			shaders[i] = reload.shaders[i].get();
+			if (reload.shaderReloadIdx[i] != NO_SHADER_RELOAD)
+			{
+				DX12ShaderReload& shaderReload = job.shaderReloads[reload.shaderReloadIdx[i]];
+				if (!shaderReload.bSucceeded)
+					return;
+				shaders[i] = &shaderReload.compiled;
 			}
+		}
+
+		if (reload.bIsCompute)
+		{
+			D3D12_COMPUTE_PIPELINE_STATE_DESC psDesc = {};
+			psDesc.CS.pShaderBytecode = shaders[2]->blob->GetBufferPointer();
+			psDesc.CS.BytecodeLength = shaders[2]->blob->GetBufferSize();
+			psDesc.pRootSignature = reload.rootSignature;
+			psDesc.NodeMask = 0;
 
-			DX12SafeRelease(pipeline.pipelineState);
-			DX12Check(m_Device->CreateGraphicsPipelineState(&pipeline.desc, IID_PPV_ARGS(&pipeline.pipelineState)));
+			DX12Check(m_Device->CreateComputePipelineState(&psDesc, IID_PPV_ARGS(&reload.pipelineState)));
 		}
+		else
+		{
+			D3D12_GRAPHICS_PIPELINE_STATE_DESC psDesc = reload.desc;
+			if (shaders[0] != nullptr)
+			{
+				psDesc.VS.pShaderBytecode = shaders[0]->blob->GetBufferPointer();
+				psDesc.VS.BytecodeLength = shaders[0]->blob->GetBufferSize();
+				// Note: The input layout is recreated from the new reflection, which replaces the one the
+				// current layout refers to.
+				reload.inputElementDescs = CreateInputLayoutFromReflection(shaders[0]->reflection, psDesc.InputLayout.NumElements);
+				psDesc.InputLayout.pInputElementDescs = reload.inputElementDescs;
+			}
+
+			if (shaders[1] != nullptr)
+			{
+				psDesc.PS.pShaderBytecode = shaders[1]->blob->GetBufferPointer();
+				psDesc.PS.BytecodeLength = shaders[1]->blob->GetBufferSize();
+			}
+			psDesc.pRootSignature = reload.rootSignature;
+
+			DX12Check(m_Device->CreateGraphicsPipelineState(&psDesc, IID_PPV_ARGS(&reload.pipelineState)));
+			reload.desc = psDesc;
+		}
+	}
+
+	void DX12Device::UpdateShaderReloads(Vector<ID3D12PipelineState*>& outRetiredPipelineStates)
+	{
+		if (!m_ShaderReloadJob || m_ShaderReloadJob->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+
+		// Note: Applying a reload modifies loaded shaders in place, so it waits for any pipelines being
+		// created in the background, which may be using them.
+		if (!m_PipelineCreations.empty())
+			return;
+
+		VAST_PROFILE_TRACE_FUNCTION;
+		DX12ShaderReloadJob& job = *m_ShaderReloadJob;
+		m_ShaderManager->ApplyShaderReloads(job.shaderReloads);
+
+		uint32 numRecreatedPipelines = 0;
+		for (auto& reload : job.pipelineReloads)
+		{
+			// Note: The pipeline may have been destroyed, and its slot reused, while reloading.
+			DX12Pipeline& pipeline = *reload.pipeline;
+			if (!reload.pipelineState || pipeline.h != reload.h)
+				continue;
+
+			outRetiredPipelineStates.push_back(pipeline.pipelineState);
+			numRecreatedPipelines++;
+			pipeline.pipelineState = reload.pipelineState;
+			reload.pipelineState = nullptr;
+
+			if (!reload.bIsCompute)
+			{
+				delete[] pipeline.desc.InputLayout.pInputElementDescs;
+				pipeline.desc = reload.desc;
+				reload.inputElementDescs = nullptr;
+			}
+		}
+
+		VAST_LOG_INFO("[gfx] [dx12] Applied shader reload ({} shaders, {} pipelines).", job.shaderReloads.size(), numRecreatedPipelines);
+		m_ShaderReloadJob = nullptr;
+	}
+
+	bool DX12Device::PollShaderFileChanges()
+	{
+		return m_ShaderManager->UpdateOutOfDateShaders();
+	}
+
+	PipelineCacheStats DX12Device::GetPipelineCacheStats() const
+	{
+		return m_PipelineLibrary ? m_PipelineLibrary->GetStats() : PipelineCacheStats{};
+	}
+
+	void DX12Device::CreateMemoryHeap(uint64 size, MemoryHeapType type, DX12MemoryHeap& outHeap)
+	{
+		VAST_ASSERTF(size > 0, "Invalid memory heap size.");
+		VAST_ASSERTF(type != MemoryHeapType::MIXED || SupportsMixedMemoryHeaps(), "Device doesn't support mixed memory heaps.");
+
+		D3D12MA::ALLOCATION_DESC allocDesc = {};
+		allocDesc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+		allocDesc.ExtraHeapFlags = TranslateToDX12(type);
+		allocDesc.Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED;
+
+		D3D12_RESOURCE_ALLOCATION_INFO allocInfo = {};
+		allocInfo.SizeInBytes = AlignU64(size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+		allocInfo.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+		DX12Check(m_Allocator->AllocateMemory(&allocDesc, &allocInfo, &outHeap.allocation));
+		outHeap.size = allocInfo.SizeInBytes;
+		outHeap.type = type;
+	}
+
+	static D3D12_RESOURCE_DESC GetPlacedResourceDesc(const TextureDesc& desc)
+	{
+		// Note: Only the flags affect the memory requirements, we don't need to resolve typeless formats.
+		D3D12_RESOURCE_DESC rscDesc = TranslateToDX12(desc);
+		if ((desc.viewFlags & TexViewFlags::RTV) == TexViewFlags::RTV)
+			rscDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+		if ((desc.viewFlags & TexViewFlags::DSV) == TexViewFlags::DSV)
+			rscDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+		if ((desc.viewFlags & TexViewFlags::UAV) == TexViewFlags::UAV)
+			rscDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+		return rscDesc;
+	}
+
+	ResourceAllocationInfo DX12Device::GetAllocationInfo(const BufferDesc& desc) const
+	{
+		D3D12_RESOURCE_DESC rscDesc = TranslateToDX12(desc);
+		D3D12_RESOURCE_ALLOCATION_INFO allocInfo = m_Device->GetResourceAllocationInfo(0, 1, &rscDesc);
+		return ResourceAllocationInfo{ allocInfo.SizeInBytes, allocInfo.Alignment };
+	}
+
+	ResourceAllocationInfo DX12Device::GetAllocationInfo(const TextureDesc& desc) const
+	{
+		D3D12_RESOURCE_DESC rscDesc = GetPlacedResourceDesc(desc);
+		D3D12_RESOURCE_ALLOCATION_INFO allocInfo = m_Device->GetResourceAllocationInfo(0, 1, &rscDesc);
+		return ResourceAllocationInfo{ allocInfo.SizeInBytes, allocInfo.Alignment };
 	}
 
 	void DX12Device::DestroyBuffer(DX12Buffer& buf)
@@ -876,6 +1392,11 @@ namespace vast
 		DX12SafeRelease(tex.allocation);
 	}
 
+	void DX12Device::DestroyMemoryHeap(DX12MemoryHeap& heap)
+	{
+		DX12SafeRelease(heap.allocation);
+	}
+
 	void DX12Device::DestroyPipeline(DX12Pipeline& pipeline)
 	{
 		pipeline.vs = nullptr;
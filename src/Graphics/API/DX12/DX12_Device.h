@@ -2,6 +2,9 @@
 
 #include "Graphics/API/DX12/DX12_Common.h"
 #include "Graphics/API/DX12/DX12_Descriptors.h"
+#include "Core/FlatHashMap.h"
+
+#include <mutex>
 
 struct IDXGIFactory7;
 
@@ -13,6 +16,9 @@ namespace D3D12MA
 namespace vast
 {
 	class DX12ShaderManager;
+	class DX12PipelineLibrary;
+	struct DX12ShaderReloadJob;
+	struct DX12PipelineCreation;
 
 	class DX12Device
 	{
@@ -22,16 +28,52 @@ namespace vast
 
 		ID3D12Device5* GetDevice() const { return m_Device; };
 
-		void CreateBuffer(const BufferDesc& desc, DX12Buffer& outBuf);
-		void CreateTexture(const TextureDesc& desc, DX12Texture& outTex);
-		void CreateGraphicsPipeline(const PipelineDesc& desc, DX12Pipeline& outPipeline);
-		void CreateComputePipeline(const ShaderDesc& desc, DX12Pipeline& outPipeline);
-
-		void ReloadShaders(DX12Pipeline& pipeline);
+		// Passing a heap creates a placed resource at the given offset, which may alias the memory of
+		// other resources placed in the same heap.
+		void CreateBuffer(const BufferDesc& desc, DX12Buffer& outBuf, const DX12MemoryHeap* heap = nullptr, uint64 heapOffset = 0);
+		void CreateTexture(const TextureDesc& desc, DX12Texture& outTex, const DX12MemoryHeap* heap = nullptr, uint64 heapOffset = 0);
+		void CreateMemoryHeap(uint64 size, MemoryHeapType type, DX12MemoryHeap& outHeap);
+		// Resource Heap Tier 2 devices can place buffers and all kinds of textures in the same heap.
+		bool SupportsMixedMemoryHeaps() const { return m_ResourceHeapTier >= D3D12_RESOURCE_HEAP_TIER_2; }
+		// Shader compile errors block until fixed, unless 'bWaitForShaderFixes' is false, in which case
+		// false is returned, leaving the pipeline untouched.
+		bool CreateGraphicsPipeline(const PipelineDesc& desc, DX12Pipeline& outPipeline, bool bWaitForShaderFixes = true);
+		bool CreateComputePipeline(const ShaderDesc& desc, DX12Pipeline& outPipeline, bool bWaitForShaderFixes = true);
+		// Same as above, but shaders are loaded and the pipeline state created on a background thread.
+		// The pipeline isn't ready until handed over by UpdatePipelineCreations. If its shaders fail to
+		// compile, it never becomes ready and is marked as failed instead.
+		void CreateGraphicsPipelineAsync(const PipelineDesc& desc, DX12Pipeline& outPipeline);
+		void CreateComputePipelineAsync(const ShaderDesc& desc, DX12Pipeline& outPipeline);
+		// Hands over the pipelines that finished being created in the background. Pipelines destroyed
+		// in the meantime are discarded.
+		void UpdatePipelineCreations();
+		// Blocks until the given pipeline, if being created in the background, is handed over. Other
+		// pipelines being created aren't waited for.
+		void WaitForPipelineCreation(PipelineHandle h);
+
+		// Compiles the given shaders in parallel ahead of the pipelines that use them being created.
+		void PrecompileShaders(const Vector<ShaderDesc>& descs);
+		// Starts recompiling, on a background thread, the shaders used by the given pipelines whose
+		// files changed since they were last compiled, along with the pipeline states of those whose
+		// changed shaders all compile successfully. Since shaders can be shared, every pipeline in
+		// 'livePipelines' using a recompiled shader is recreated as well. Pipelines keep using their
+		// current shaders until the reload is applied by UpdateShaderReloads.
+		void ReloadShaders(const Vector<DX12Pipeline*>& pipelines, const Vector<DX12Pipeline*>& livePipelines);
+		bool IsReloadingShaders() const { return m_ShaderReloadJob != nullptr; }
+		// Must be called at the start of a frame. If the reload in progress has finished, swaps the new
+		// shaders and pipeline states in, and returns the replaced pipeline states, which may still be
+		// in use by frames in flight.
+		void UpdateShaderReloads(Vector<ID3D12PipelineState*>& outRetiredPipelineStates);
+		bool PollShaderFileChanges();
+		PipelineCacheStats GetPipelineCacheStats() const;
 
 		void DestroyBuffer(DX12Buffer& buf);
 		void DestroyTexture(DX12Texture& tex);
 		void DestroyPipeline(DX12Pipeline& pipeline);
+		void DestroyMemoryHeap(DX12MemoryHeap& heap);
+
+		ResourceAllocationInfo GetAllocationInfo(const BufferDesc& desc) const;
+		ResourceAllocationInfo GetAllocationInfo(const TextureDesc& desc) const;
 
 		IDXGISwapChain1* CreateSwapChain(ID3D12CommandQueue* graphicsQueue, WindowHandle windowHandle, uint32 bufferCount, uint2 size, DXGI_FORMAT format);
 		DX12Descriptor CreateBackBufferRTV(ID3D12Resource* backBuffer, DXGI_FORMAT format);
@@ -44,19 +86,43 @@ namespace vast
 
 		void CopyDescriptorToReservedTable(DX12Descriptor srvHandle, uint32 heapIndex);
 		void CreateSamplers();
+		// Returns a new reference to the root signature for the given serialized description, shared
+		// with any other pipeline created with an identical one.
+		ID3D12RootSignature* AcquireRootSignature(ID3DBlob* rootSignatureBlob);
+		// Returns the global root signature if enabled and the pipeline's shaders fit it, or else one
+		// created from their reflection.
+		ID3DBlob* CreatePipelineRootSignature(DX12Pipeline& pipeline);
+		D3D12_INPUT_ELEMENT_DESC* CreateInputLayoutFromReflection(const ShaderReflection& reflection, uint32& outNumElements) const;
+		// Thread-safe, called from the shader reload thread.
+		void CreateReloadedPipelineState(DX12ShaderReloadJob& job, uint32 pipelineReloadIdx);
+		// Returns true if the pipeline was handed over, or false if it failed to be created or was
+		// destroyed while being created.
+		bool HandOverPipelineCreation(DX12PipelineCreation& creation);
 
 	private:
 		IDXGIFactory7* m_DXGIFactory;
 		ID3D12Device5* m_Device;
 		D3D12MA::Allocator* m_Allocator;
+		D3D12_RESOURCE_HEAP_TIER m_ResourceHeapTier;
 		Ptr<DX12ShaderManager> m_ShaderManager;
+		Ptr<DX12ShaderReloadJob> m_ShaderReloadJob;
+		Vector<Ptr<DX12PipelineCreation>> m_PipelineCreations;
+		Ptr<DX12PipelineLibrary> m_PipelineLibrary;
+
+		// Root signatures by hash of their serialized description. The cache keeps a reference to
+		// each of them, so they live for as long as the device does.
+		FlatHashMap<uint32> m_RootSignatureIndices;
+		Vector<ID3D12RootSignature*> m_RootSignatures;
+		std::mutex m_RootSignatureMutex;
+		// Only set when using the global root signature.
+		ID3DBlob* m_GlobalRootSignatureBlob;
 
 		Ptr<DX12StagingDescriptorHeap> m_RTVStagingDescriptorHeap;
 		Ptr<DX12StagingDescriptorHeap> m_DSVStagingDescriptorHeap;
 		Ptr<DX12StagingDescriptorHeap> m_CBVSRVUAVStagingDescriptorHeap;
 
 		FreeList<NUM_RESERVED_DESCRIPTOR_INDICES> m_DescriptorIndexFreeList;
-		Array<Ptr<DX12RenderPassDescriptorHeap>, NUM_FRAMES_IN_FLIGHT> m_CBVSRVUAVRenderPassDescriptorHeaps;
+		Array<Ptr<DX12RenderPassDescriptorHeap>, MAX_FRAMES_IN_FLIGHT> m_CBVSRVUAVRenderPassDescriptorHeaps;
 		Ptr<DX12RenderPassDescriptorHeap> m_SamplerRenderPassDescriptorHeap;
 	};
 }
\ No newline at end of file
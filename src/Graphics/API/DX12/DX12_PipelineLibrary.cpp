@@ -0,0 +1,218 @@
+#include "vastpch.h"
+#include "Graphics/API/DX12/DX12_PipelineLibrary.h"
+
+#include "Core/Filesystem.h"
+#include "Core/Hash.h"
+
+namespace vast
+{
+	static constexpr uint32 PIPELINE_LIBRARY_MAGIC = 0x43505356; // 'VSPC'
+	// Note: Bump when the file layout or the pipeline key computation changes.
+	static constexpr uint32 PIPELINE_LIBRARY_VERSION = 1;
+
+	struct PipelineLibraryFileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint64 librarySize;
+		uint64 libraryHash;
+	};
+
+	static std::wstring GetPipelineStateName(uint64 key)
+	{
+		return std::to_wstring(key);
+	}
+
+	DX12PipelineLibrary::DX12PipelineLibrary(ID3D12Device5* device, const std::string& filePath)
+		: m_Device(device)
+		, m_Library(nullptr)
+		, m_SaveLibrary(nullptr)
+		, m_FilePath(filePath)
+		, m_FileData({})
+		, m_Mutex()
+		, m_Stats({})
+		, m_bIsDirty(false)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERT(m_Device);
+
+		LoadFromFile();
+
+		if (!m_Library)
+		{
+			m_FileData.clear();
+			if (FAILED(m_Device->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_Library))))
+			{
+				VAST_LOG_WARNING("[gfx] [dx12] Pipeline libraries are not supported by the driver.");
+				m_Library = nullptr;
+			}
+		}
+
+		if (m_Library && FAILED(m_Device->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_SaveLibrary))))
+		{
+			VAST_LOG_WARNING("[gfx] [dx12] Failed to create pipeline library to save, pipeline cache is disabled.");
+			DX12SafeRelease(m_Library);
+			m_SaveLibrary = nullptr;
+		}
+	}
+
+	DX12PipelineLibrary::~DX12PipelineLibrary()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		if (m_Library)
+		{
+			Save();
+			const PipelineCacheStats stats = GetStats();
+			VAST_LOG_INFO("[gfx] [dx12] Pipeline cache: {} hits, {} misses, {} stores ({} KB loaded, {} KB saved).",
+				stats.numHits, stats.numMisses, stats.numStores, stats.loadedBytes / 1024, stats.savedBytes / 1024);
+		}
+		DX12SafeRelease(m_SaveLibrary);
+		DX12SafeRelease(m_Library);
+	}
+
+	void DX12PipelineLibrary::LoadFromFile()
+	{
+		Vector<uint8> data;
+		if (!Filesystem::ReadFile(m_FilePath, data))
+			return;
+
+		PipelineLibraryFileHeader header = {};
+		bool bIsValid = data.size() >= sizeof(header);
+		if (bIsValid)
+		{
+			memcpy(&header, data.data(), sizeof(header));
+			bIsValid = header.magic == PIPELINE_LIBRARY_MAGIC
+				&& header.version == PIPELINE_LIBRARY_VERSION
+				&& header.librarySize == data.size() - sizeof(header)
+				&& HashBytes(data.data() + sizeof(header), header.librarySize) == header.libraryHash;
+		}
+
+		if (!bIsValid)
+		{
+			VAST_LOG_WARNING("[gfx] [dx12] Discarding invalid pipeline cache '{}'.", m_FilePath);
+			return;
+		}
+
+		m_FileData.assign(data.begin() + sizeof(header), data.end());
+		const HRESULT hr = m_Device->CreatePipelineLibrary(m_FileData.data(), m_FileData.size(), IID_PPV_ARGS(&m_Library));
+		if (FAILED(hr))
+		{
+			// Note: Libraries are only valid for the driver and adapter they were created with.
+			if (hr == D3D12_ERROR_DRIVER_VERSION_MISMATCH || hr == D3D12_ERROR_ADAPTER_NOT_FOUND)
+			{
+				VAST_LOG_INFO("[gfx] [dx12] Pipeline cache '{}' was created by a different driver or adapter, discarding.", m_FilePath);
+			}
+			else
+			{
+				VAST_LOG_WARNING("[gfx] [dx12] Failed to load pipeline cache '{}', discarding.", m_FilePath);
+			}
+			m_Library = nullptr;
+			return;
+		}
+
+		m_Stats.loadedBytes = m_FileData.size();
+		VAST_LOG_INFO("[gfx] [dx12] Loaded pipeline cache '{}' ({} KB).", m_FilePath, m_Stats.loadedBytes / 1024);
+	}
+
+	ID3D12PipelineState* DX12PipelineLibrary::CreateGraphicsPipelineState(uint64 key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+	{
+		VAST_ASSERT(m_Library);
+		ID3D12PipelineState* pipelineState = nullptr;
+		const std::wstring name = GetPipelineStateName(key);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			// Note: Fails if there's no pipeline state with this name, or if its description differs.
+			if (SUCCEEDED(m_Library->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(&pipelineState))))
+			{
+				// Note: Fails if the name is already in use, e.g. by an identical pipeline state.
+				m_SaveLibrary->StorePipeline(name.c_str(), pipelineState);
+				m_Stats.numHits++;
+				return pipelineState;
+			}
+			m_Stats.numMisses++;
+		}
+
+		// Note: Compiling is the expensive part, so it happens outside of the lock.
+		DX12Check(m_Device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState)));
+		StorePipelineState(name, pipelineState);
+		return pipelineState;
+	}
+
+	ID3D12PipelineState* DX12PipelineLibrary::CreateComputePipelineState(uint64 key, const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc)
+	{
+		VAST_ASSERT(m_Library);
+		ID3D12PipelineState* pipelineState = nullptr;
+		const std::wstring name = GetPipelineStateName(key);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (SUCCEEDED(m_Library->LoadComputePipeline(name.c_str(), &desc, IID_PPV_ARGS(&pipelineState))))
+			{
+				m_SaveLibrary->StorePipeline(name.c_str(), pipelineState);
+				m_Stats.numHits++;
+				return pipelineState;
+			}
+			m_Stats.numMisses++;
+		}
+
+		DX12Check(m_Device->CreateComputePipelineState(&desc, IID_PPV_ARGS(&pipelineState)));
+		StorePipelineState(name, pipelineState);
+		return pipelineState;
+	}
+
+	void DX12PipelineLibrary::StorePipelineState(const std::wstring& name, ID3D12PipelineState* pipelineState)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		// Note: Fails if the name is already in use, e.g. by an identical pipeline state stored by
+		// another thread since we last checked.
+		if (SUCCEEDED(m_Library->StorePipeline(name.c_str(), pipelineState)))
+		{
+			m_SaveLibrary->StorePipeline(name.c_str(), pipelineState);
+			m_Stats.numStores++;
+			m_bIsDirty = true;
+		}
+	}
+
+	bool DX12PipelineLibrary::Save()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_Library || !m_bIsDirty)
+			return false;
+
+		// Note: Entries in the loaded library that weren't used this run are dropped.
+		const size_t librarySize = m_SaveLibrary->GetSerializedSize();
+		Vector<uint8> data(sizeof(PipelineLibraryFileHeader) + librarySize);
+		uint8* library = data.data() + sizeof(PipelineLibraryFileHeader);
+		if (FAILED(m_SaveLibrary->Serialize(library, librarySize)))
+		{
+			VAST_LOG_WARNING("[gfx] [dx12] Failed to serialize pipeline cache.");
+			return false;
+		}
+
+		PipelineLibraryFileHeader header = {};
+		header.magic = PIPELINE_LIBRARY_MAGIC;
+		header.version = PIPELINE_LIBRARY_VERSION;
+		header.librarySize = librarySize;
+		header.libraryHash = HashBytes(library, librarySize);
+		memcpy(data.data(), &header, sizeof(header));
+
+		if (!Filesystem::WriteFile(m_FilePath, data.data(), data.size()))
+		{
+			VAST_LOG_WARNING("[gfx] [dx12] Failed to write pipeline cache '{}'.", m_FilePath);
+			return false;
+		}
+
+		m_Stats.savedBytes = librarySize;
+		m_bIsDirty = false;
+		return true;
+	}
+
+	PipelineCacheStats DX12PipelineLibrary::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Stats;
+	}
+
+}
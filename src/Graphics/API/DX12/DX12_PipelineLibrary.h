@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Graphics/API/DX12/DX12_Common.h"
+
+#include <mutex>
+
+// ==================================== DX12 PIPELINE LIBRARY =====================================
+//
+// Persistent on-disk cache of pipeline state objects, backed by an ID3D12PipelineLibrary. The
+// library is loaded at startup, and pipelines found in it are created from the driver's already
+// compiled representation instead of being compiled again. Pipelines that aren't found are
+// compiled as usual and added to the library, which is saved back to disk on destruction.
+//
+// Entries are named after a key that must hash everything that can affect the pipeline state: its
+// description, and the shader bytecode and root signature it is created with. Changes to any of
+// these produce a different key, so stale entries are never returned. Libraries saved by a
+// different driver version or adapter are rejected by the runtime, and replaced by an empty one.
+//
+// Since stale entries can't be removed from a library, the saved library is a separate one that
+// only receives the pipeline states loaded or stored during this run. This keeps the file from
+// growing with every shader or pipeline change.
+//
+// The file is prefixed with a header that is validated on load (format version, size and a hash
+// of the library data), so that truncated or corrupted files are never handed to the driver.
+//
+// Pipeline states can be created concurrently from multiple threads.
+//
+// ================================================================================================
+
+namespace vast
+{
+
+	class DX12PipelineLibrary
+	{
+	public:
+		DX12PipelineLibrary(ID3D12Device5* device, const std::string& filePath);
+		~DX12PipelineLibrary();
+
+		// Returns false if pipeline libraries aren't supported by the driver, in which case the
+		// library can't be used.
+		bool IsEnabled() const { return m_Library != nullptr; }
+
+		// Loads the pipeline state from the library if found, or creates it and adds it to the library
+		// otherwise.
+		ID3D12PipelineState* CreateGraphicsPipelineState(uint64 key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+		ID3D12PipelineState* CreateComputePipelineState(uint64 key, const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc);
+
+		// Returns false if there are no new pipeline states to save, or if writing the file failed.
+		bool Save();
+
+		PipelineCacheStats GetStats();
+
+	private:
+		void LoadFromFile();
+		void StorePipelineState(const std::wstring& name, ID3D12PipelineState* pipelineState);
+
+		ID3D12Device5* m_Device;
+		// Library loaded from disk, plus the pipeline states stored this run.
+		ID3D12PipelineLibrary* m_Library;
+		// Pipeline states loaded or stored this run, which is what gets saved.
+		ID3D12PipelineLibrary* m_SaveLibrary;
+		std::string m_FilePath;
+		// Note: The library reads from this memory for as long as it is alive.
+		Vector<uint8> m_FileData;
+		std::mutex m_Mutex;
+
+		PipelineCacheStats m_Stats;
+		bool m_bIsDirty;
+	};
+
+}
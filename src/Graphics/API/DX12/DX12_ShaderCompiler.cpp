@@ -1,29 +1,146 @@
 #include "vastpch.h"
 #include "Graphics/API/DX12/DX12_ShaderCompiler.h"
+#include "Graphics/ShaderFileCache.h"
+#include "Graphics/ShaderReflection.h"
 
 #include "dx12/DirectXShaderCompiler/inc/dxcapi.h"
+#if VAST_GFX_DX12_SUPPORTED
+#include "Graphics/API/DX12/DX12_Common.h"
 #include "dx12/DirectXAgilitySDK/include/d3d12shader.h"
+#else
+#define DX12Check(hr) VAST_ASSERT(SUCCEEDED(hr))
+
+namespace vast
+{
+	template <typename T>
+	inline void DX12SafeRelease(T& p)
+	{
+		if (p)
+		{
+			p->Release();
+			p = nullptr;
+		}
+	}
+}
+#endif
+
+#include <atomic>
+#include <filesystem>
 
 namespace vast
 {
+	Vector<std::wstring> GetEngineShaderDefines()
+	{
+		Vector<std::wstring> defines;
+		defines.push_back(L"PushConstantRegister=b" + std::to_wstring(PUSH_CONSTANT_REGISTER_INDEX));
+
+		// Samplers are referenced by their index in the sampler descriptor table.
+		for (uint32 i = 0; i < IDX(SamplerState::COUNT); ++i)
+		{
+			const std::string samplerName = g_SamplerNames[i];
+			defines.push_back(std::wstring(samplerName.begin(), samplerName.end()) + L"=" + std::to_wstring(i));
+		}
+		return defines;
+	}
+
+	//
+
+	// Serves includes from the shader file cache instead of reading them from disk on every compile.
+	// The compiler asks for each candidate path an include could resolve to, and tries the next one
+	// if loading fails.
+	class DX12ShaderIncludeHandler : public IDxcIncludeHandler
+	{
+	public:
+		DX12ShaderIncludeHandler(IDxcUtils* dxcUtils, ShaderFileCache& fileCache)
+			: m_DxcUtils(dxcUtils)
+			, m_FileCache(fileCache)
+			, m_LoadedFiles({})
+			, m_RefCount(1)
+		{
+		}
+
+		// Note: Include blobs point into the contents of the files they were loaded from, so files
+		// are kept alive until the next compile starts.
+		void ReleaseLoadedFiles() { m_LoadedFiles.clear(); }
+
+		HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override
+		{
+			VAST_ASSERT(ppIncludeSource);
+			*ppIncludeSource = nullptr;
+
+			Ref<const ShaderFile> file = m_FileCache.GetFile(std::filesystem::path(pFilename).string());
+			if (!file)
+				return E_FAIL;
+
+			static const uint8 s_EmptyFile = 0;
+			const void* data = file->contents.empty() ? &s_EmptyFile : file->contents.data();
+			IDxcBlobEncoding* blob = nullptr;
+			const HRESULT hr = m_DxcUtils->CreateBlobFromPinned(data, static_cast<uint32>(file->contents.size()), DXC_CP_ACP, &blob);
+			if (FAILED(hr))
+				return hr;
+
+			m_LoadedFiles.push_back(std::move(file));
+			*ppIncludeSource = blob;
+			return S_OK;
+		}
 
-	DX12ShaderCompiler::DX12ShaderCompiler()
-		: m_DxcUtils(nullptr)
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+		{
+			if (!ppvObject)
+				return E_POINTER;
+
+			if (riid == __uuidof(IDxcIncludeHandler) || riid == __uuidof(IUnknown))
+			{
+				*ppvObject = static_cast<IDxcIncludeHandler*>(this);
+				AddRef();
+				return S_OK;
+			}
+			*ppvObject = nullptr;
+			return E_NOINTERFACE;
+		}
+
+		ULONG STDMETHODCALLTYPE AddRef() override
+		{
+			return ++m_RefCount;
+		}
+
+		ULONG STDMETHODCALLTYPE Release() override
+		{
+			const ULONG refCount = --m_RefCount;
+			if (refCount == 0)
+			{
+				delete this;
+			}
+			return refCount;
+		}
+
+	private:
+		IDxcUtils* m_DxcUtils;
+		ShaderFileCache& m_FileCache;
+		Vector<Ref<const ShaderFile>> m_LoadedFiles;
+		std::atomic<ULONG> m_RefCount;
+	};
+
+	//
+
+	DX12ShaderCompiler::DX12ShaderCompiler(ShaderFileCache& fileCache)
+		: m_FileCache(fileCache)
+		, m_DxcUtils(nullptr)
 		, m_DxcCompiler(nullptr)
-		, m_DxcIncludeHandler(nullptr)
+		, m_IncludeHandler(nullptr)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
 		DX12Check(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&m_DxcUtils)));
 		DX12Check(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&m_DxcCompiler)));
-		DX12Check(m_DxcUtils->CreateDefaultIncludeHandler(&m_DxcIncludeHandler));
+		m_IncludeHandler = new DX12ShaderIncludeHandler(m_DxcUtils, m_FileCache);
 	}
 
 	DX12ShaderCompiler::~DX12ShaderCompiler()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		DX12SafeRelease(m_DxcIncludeHandler);
+		DX12SafeRelease(m_IncludeHandler);
 		DX12SafeRelease(m_DxcCompiler);
 		DX12SafeRelease(m_DxcUtils);
 	}
@@ -33,11 +150,14 @@ namespace vast
 		VAST_PROFILE_TRACE_FUNCTION;
 		VAST_ASSERT(m_DxcUtils);
 
-		// Load shader source file
-		IDxcBlobEncoding* sourceBlobEncoding = nullptr;
-		DX12Check(m_DxcUtils->LoadFile(fullPath.c_str(), nullptr, &sourceBlobEncoding));
-		VAST_ASSERTF(sourceBlobEncoding && sourceBlobEncoding->GetBufferSize(), "Cannot find specified shader path.");
+		Ref<const ShaderFile> file = m_FileCache.GetFile(std::filesystem::path(fullPath).string());
+		VAST_ASSERTF(file && !file->contents.empty(), "Cannot find specified shader path.");
+		if (!file || file->contents.empty())
+			return nullptr;
 
+		// Note: The source is copied into the blob, since the caller owns it.
+		IDxcBlobEncoding* sourceBlobEncoding = nullptr;
+		DX12Check(m_DxcUtils->CreateBlob(file->contents.data(), static_cast<uint32>(file->contents.size()), DXC_CP_ACP, &sourceBlobEncoding));
 		return sourceBlobEncoding;
 	}
 
@@ -57,22 +177,12 @@ namespace vast
 		}
 	}
 
-	IDxcResult* DX12ShaderCompiler::CompileShader(IDxcBlobEncoding* sourceBlobEncoding, const ShaderCompilerArguments& sca)
+	Vector<std::wstring> DX12ShaderCompiler::GetArguments(const ShaderCompilerArguments& sca) const
 	{
-		VAST_PROFILE_TRACE_FUNCTION;
-		VAST_ASSERT(sourceBlobEncoding);
-
-		const DxcBuffer sourceBuffer
+		Vector<std::wstring> args
 		{
-			.Ptr = sourceBlobEncoding->GetBufferPointer(),
-			.Size = sourceBlobEncoding->GetBufferSize(),
-			.Encoding = DXC_CP_ACP
-		};
-
-		Vector<LPCWSTR> args
-		{
-			sca.shaderName.c_str(),
-			L"-E", sca.shaderEntryPoint.c_str(),
+			sca.shaderName,
+			L"-E", sca.shaderEntryPoint,
 			L"-T", ToShaderTarget(sca.shaderType),
 #ifdef VAST_DEBUG
 			DXC_ARG_DEBUG,
@@ -88,19 +198,57 @@ namespace vast
 		for (const auto& arg : sca.includeDirectories)
 		{
 			args.push_back(L"-I");
-			args.push_back(arg.c_str());
+			args.push_back(arg);
 		}
 		
 		for (const auto& arg : sca.additionalDefines)
 		{
 			args.push_back(L"-D");
+			args.push_back(arg);
+		}
+
+		return args;
+	}
+
+	std::string DX12ShaderCompiler::GetVersionString() const
+	{
+		VAST_ASSERT(m_DxcCompiler);
+
+		uint32 major = 0, minor = 0;
+		IDxcVersionInfo* versionInfo = nullptr;
+		if (SUCCEEDED(m_DxcCompiler->QueryInterface(IID_PPV_ARGS(&versionInfo))))
+		{
+			versionInfo->GetVersion(&major, &minor);
+			DX12SafeRelease(versionInfo);
+		}
+		return "dxc " + std::to_string(major) + "." + std::to_string(minor);
+	}
+
+	IDxcResult* DX12ShaderCompiler::CompileShader(IDxcBlobEncoding* sourceBlobEncoding, const ShaderCompilerArguments& sca)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERT(sourceBlobEncoding);
+
+		const DxcBuffer sourceBuffer
+		{
+			.Ptr = sourceBlobEncoding->GetBufferPointer(),
+			.Size = sourceBlobEncoding->GetBufferSize(),
+			.Encoding = DXC_CP_ACP
+		};
+
+		const Vector<std::wstring> argStrings = GetArguments(sca);
+		Vector<LPCWSTR> args;
+		args.reserve(argStrings.size());
+		for (const auto& arg : argStrings)
+		{
 			args.push_back(arg.c_str());
 		}
 
 		// Compile shader
 		IDxcResult* compiledShader = nullptr;
-		VAST_ASSERT(m_DxcCompiler && m_DxcIncludeHandler);
-		DX12Check(m_DxcCompiler->Compile(&sourceBuffer, args.data(), static_cast<uint32>(args.size()), m_DxcIncludeHandler, IID_PPV_ARGS(&compiledShader)));
+		VAST_ASSERT(m_DxcCompiler && m_IncludeHandler);
+		m_IncludeHandler->ReleaseLoadedFiles();
+		DX12Check(m_DxcCompiler->Compile(&sourceBuffer, args.data(), static_cast<uint32>(args.size()), m_IncludeHandler, IID_PPV_ARGS(&compiledShader)));
 
 		// Log compilation errors
 		IDxcBlobUtf8* errors = nullptr;
@@ -124,26 +272,107 @@ namespace vast
 		return compiledShader;
 	}
 
-	ID3D12ShaderReflection* DX12ShaderCompiler::ExtractShaderReflection(IDxcResult* compiledShader)
+	IDxcBlob* DX12ShaderCompiler::ExtractShaderReflectionBlob(IDxcResult* compiledShader)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
-		VAST_ASSERT(compiledShader && m_DxcUtils);
+		VAST_ASSERT(compiledShader);
 
 		IDxcBlob* reflectionBlob = nullptr;
 		DX12Check(compiledShader->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&reflectionBlob), nullptr));
+		return reflectionBlob;
+	}
+
+	IDxcBlob* DX12ShaderCompiler::CreateBlob(const void* data, size_t size)
+	{
+		VAST_ASSERT(m_DxcUtils && data && size);
+
+		// Note: The blob keeps its own copy of the data.
+		IDxcBlobEncoding* blob = nullptr;
+		DX12Check(m_DxcUtils->CreateBlob(data, static_cast<uint32>(size), DXC_CP_ACP, &blob));
+		return blob;
+	}
+
+	IDxcBlob* DX12ShaderCompiler::CreateBlobFromPinned(const void* data, size_t size)
+	{
+		VAST_ASSERT(m_DxcUtils && data && size);
+
+		IDxcBlobEncoding* blob = nullptr;
+		DX12Check(m_DxcUtils->CreateBlobFromPinned(data, static_cast<uint32>(size), DXC_CP_ACP, &blob));
+		return blob;
+	}
+
+#if VAST_GFX_DX12_SUPPORTED
+	static ShaderResourceType TranslateShaderInputType(D3D_SHADER_INPUT_TYPE type)
+	{
+		switch (type)
+		{
+		case D3D_SIT_CBUFFER:			return ShaderResourceType::CONSTANT_BUFFER;
+		case D3D_SIT_STRUCTURED:
+		case D3D_SIT_TEXTURE:			return ShaderResourceType::SRV;
+		case D3D_SIT_UAV_RWSTRUCTURED:
+		case D3D_SIT_UAV_RWTYPED:		return ShaderResourceType::UAV;
+		case D3D_SIT_SAMPLER:			return ShaderResourceType::SAMPLER;
+		default:						return ShaderResourceType::UNKNOWN;
+		}
+	}
+
+	bool DX12ShaderCompiler::ReflectShader(const void* data, size_t size, ShaderReflection& outReflection)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERT(m_DxcUtils && data && size);
 
 		const DxcBuffer reflectionBuffer
 		{
-			.Ptr = reflectionBlob->GetBufferPointer(),
-			.Size = reflectionBlob->GetBufferSize(),
+			.Ptr = data,
+			.Size = size,
 			.Encoding = DXC_CP_ACP
 		};
 
-		ID3D12ShaderReflection* shaderReflection = nullptr;
-		m_DxcUtils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&shaderReflection));
-		DX12SafeRelease(reflectionBlob);
-		return shaderReflection;
+		ID3D12ShaderReflection* reflection = nullptr;
+		if (FAILED(m_DxcUtils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&reflection))))
+			return false;
+
+		D3D12_SHADER_DESC shaderDesc = {};
+		reflection->GetDesc(&shaderDesc);
+
+		outReflection = {};
+		outReflection.inputParameters.reserve(shaderDesc.InputParameters);
+		for (uint32 i = 0; i < shaderDesc.InputParameters; ++i)
+		{
+			D3D12_SIGNATURE_PARAMETER_DESC paramDesc = {};
+			DX12Check(reflection->GetInputParameterDesc(i, &paramDesc));
+
+			ShaderInputParameter& param = outReflection.inputParameters.emplace_back();
+			param.semanticName = paramDesc.SemanticName;
+			param.semanticIndex = paramDesc.SemanticIndex;
+			param.componentType = static_cast<uint32>(paramDesc.ComponentType);
+			param.mask = paramDesc.Mask;
+		}
+
+		outReflection.resources.reserve(shaderDesc.BoundResources);
+		for (uint32 i = 0; i < shaderDesc.BoundResources; ++i)
+		{
+			D3D12_SHADER_INPUT_BIND_DESC sibDesc = {};
+			DX12Check(reflection->GetResourceBindingDesc(i, &sibDesc));
+
+			ShaderResourceBinding& resource = outReflection.resources.emplace_back();
+			resource.name = sibDesc.Name;
+			resource.type = TranslateShaderInputType(sibDesc.Type);
+			resource.bindPoint = sibDesc.BindPoint;
+			resource.space = sibDesc.Space;
+			if (resource.type == ShaderResourceType::CONSTANT_BUFFER)
+			{
+				// Note: Constant buffers are indexed separately from bound resources, so look it up by name.
+				D3D12_SHADER_BUFFER_DESC cbDesc = {};
+				DX12Check(reflection->GetConstantBufferByName(sibDesc.Name)->GetDesc(&cbDesc));
+				resource.size = cbDesc.Size;
+			}
+		}
+
+		DX12SafeRelease(reflection);
+		return true;
 	}
+#endif
 
 	IDxcBlob* DX12ShaderCompiler::ExtractShaderOutput(IDxcResult* compiledShader)
 	{
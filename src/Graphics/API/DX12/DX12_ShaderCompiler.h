@@ -1,6 +1,8 @@
 #pragma once
 
-#include "Graphics/API/DX12/DX12_Common.h"
+// Note: Doesn't depend on D3D12 other than for reflection, so that shaders can also be compiled
+// offline on platforms without it (see the shadercompiler project).
+#include "Graphics/GraphicsTypes.h"
 
 struct IDxcUtils;
 struct IDxcCompiler3;
@@ -8,10 +10,21 @@ struct IDxcIncludeHandler;
 struct IDxcBlob;
 struct IDxcBlobEncoding;
 struct IDxcResult;
-struct ID3D12ShaderReflection;
 
 namespace vast
 {
+	struct ShaderReflection;
+	class ShaderFileCache;
+	class DX12ShaderIncludeHandler;
+
+	// Note: Root 32 Bit constants are identified on shaders by using a reserved binding point b999.
+	// This is because DXC shader reflection has no way to tell apart a CBV from a Root 32 Bit Constant.
+	// TODO: We could also identify push constants by giving a descriptive name to the buffer itself, in case in the future more than one binding point is needed.
+	constexpr uint32 PUSH_CONSTANT_REGISTER_INDEX = 999;
+
+	// Defines every engine shader is compiled with (reserved registers, sampler indices).
+	Vector<std::wstring> GetEngineShaderDefines();
+
 	struct ShaderCompilerArguments
 	{
 		ShaderType shaderType;
@@ -24,19 +37,36 @@ namespace vast
 	class DX12ShaderCompiler
 	{
 	public:
-		DX12ShaderCompiler();
+		// Source and include files are read through the given file cache, which can be shared by
+		// compilers on different threads and must outlive them.
+		DX12ShaderCompiler(ShaderFileCache& fileCache);
 		~DX12ShaderCompiler();
 
 		IDxcBlobEncoding* LoadShader(const std::wstring& fullPath);
 		IDxcResult* CompileShader(IDxcBlobEncoding* sourceBlobEncoding, const ShaderCompilerArguments& sca);
-		ID3D12ShaderReflection* ExtractShaderReflection(IDxcResult* compiledShader);
+		IDxcBlob* ExtractShaderReflectionBlob(IDxcResult* compiledShader);
 		IDxcBlob* ExtractShaderOutput(IDxcResult* compiledShader);
 		IDxcBlob* ExtractShaderPDB(IDxcResult* compiledShader);
 
+		// Recreate compiler outputs from previously extracted data (e.g. loaded from the shader cache).
+		IDxcBlob* CreateBlob(const void* data, size_t size);
+		// Doesn't copy the data, which must outlive the blob (e.g. a memory-mapped shader archive).
+		IDxcBlob* CreateBlobFromPinned(const void* data, size_t size);
+#if VAST_GFX_DX12_SUPPORTED
+		// Extracts the reflection the engine uses from the compiler's reflection data (see
+		// ExtractShaderReflectionBlob). Returns false if the data can't be reflected.
+		bool ReflectShader(const void* data, size_t size, ShaderReflection& outReflection);
+#endif
+
+		// Full list of arguments CompileShader passes to the compiler.
+		Vector<std::wstring> GetArguments(const ShaderCompilerArguments& sca) const;
+		std::string GetVersionString() const;
+
 	private:
+		ShaderFileCache& m_FileCache;
 		IDxcUtils* m_DxcUtils;
 		IDxcCompiler3* m_DxcCompiler;
-		IDxcIncludeHandler* m_DxcIncludeHandler;
+		DX12ShaderIncludeHandler* m_IncludeHandler;
 	};
 
 }
\ No newline at end of file
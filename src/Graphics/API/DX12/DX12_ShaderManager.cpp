@@ -1,34 +1,98 @@
 #include "vastpch.h"
 #include "Graphics/API/DX12/DX12_ShaderManager.h"
 #include "Graphics/API/DX12/DX12_ShaderCompiler.h"
+#include "Graphics/ShaderArchive.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/ShaderFileCache.h"
+#include "Graphics/ShaderPermutation.h"
+#include "Core/ThreadPool.h"
+
+#include <filesystem>
 
 // TODO: DX12ShaderManager shouldn't have to include this or be aware of compiler specific arguments, should be moved down to DX12ShaderCompiler.
 #include "dx12/DirectXShaderCompiler/inc/dxcapi.h"
 
 #ifdef VAST_DEBUG
-static const wchar_t* SHADER_OUTPUT_PATH = L"../bin/Debug/Shaders/";
+static const char* SHADER_CACHE_PATH = "../bin/Debug/ShaderCache/";
+static const char* SHADER_MANIFEST_PATH = "../bin/Debug/ShaderManifest.txt";
 #else
-static const wchar_t* SHADER_OUTPUT_PATH = L"../bin/Release/Shaders/";
+static const char* SHADER_CACHE_PATH = "../bin/Release/ShaderCache/";
+static const char* SHADER_MANIFEST_PATH = "../bin/Release/ShaderManifest.txt";
 #endif
 
-// Note: Root 32 Bit constants are identified on shaders by using a reserved binding point b999.
-// This is because DXC shader reflection has no way to tell apart a CBV from a Root 32 Bit Constant.
-// TODO: We could also identify push constants by giving a descriptive name to the buffer itself, in case in the future more than one binding point is needed.
-static constexpr int PUSH_CONSTANT_REGISTER_INDEX = 999;
-
 namespace vast
 {
 	Arg g_AdditionalShaderIncludeDirectories("AdditionalShaderIncludeDirectories", std::string());
+	Arg g_DisableShaderCache("DisableShaderCache", false);
+	// Number of worker threads used to compile shaders in parallel, 0 to use all hardware threads.
+	Arg g_ShaderCompileThreads("ShaderCompileThreads", 0u);
+	// Path to an archive of precompiled shaders generated by the shadercompiler tool.
+	Arg g_ShaderArchive("ShaderArchive", std::string());
+	// Record the shaders used in each run, and precompile them at startup on the next one.
+	Arg g_DisableShaderManifest("DisableShaderManifest", false);
+
+	// Threads loading shaders at the same time that also compile some of them, besides the workers.
+	static constexpr uint32 MAX_CONCURRENT_SHADER_LOADS = 4;
+
+#ifdef VAST_DEBUG
+	// Shader keys are 64-bit hashes, so a collision is extremely unlikely, but would otherwise go
+	// unnoticed and silently use one shader in place of another.
+	static void CheckShaderKeyCollision(const ShaderDesc& desc, const ShaderDesc& loadedDesc)
+	{
+		auto IsSameName = [](const std::string& a, const std::string& b)
+		{
+			return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char ca, char cb) { return tolower(static_cast<uint8>(ca)) == tolower(static_cast<uint8>(cb)); });
+		};
+		VAST_ASSERTF(IsSameName(desc.shaderName, loadedDesc.shaderName) && desc.entryPoint == loadedDesc.entryPoint
+			&& desc.permutationDomain == loadedDesc.permutationDomain && desc.permutation == loadedDesc.permutation,
+			"Shader key collision between '{}' ({}) and '{}' ({}).", desc.shaderName, desc.entryPoint, loadedDesc.shaderName, loadedDesc.entryPoint);
+	}
+#endif
 
 	DX12ShaderManager::DX12ShaderManager()
-		: m_ShaderCompiler(nullptr)
-		, m_ShaderKeys({})
+		: m_CompileThreadPool(nullptr)
+		, m_ShaderFileCache(nullptr)
+		, m_ShaderCompilers({})
+		, m_ShaderCache(nullptr)
+		, m_ShaderArchive(nullptr)
+		, m_ShaderManifestPath()
+		, m_CompilerVersion()
+		, m_ShaderIndices()
 		, m_Shaders({})
+		, m_ShaderFileDependents({})
+		, m_ShaderFileWatcher()
 		, m_GlobalShaderDefines({})
 		, m_ShaderIncludeDirectories({})
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
-		m_ShaderCompiler = MakePtr<DX12ShaderCompiler>();
+		uint32 numCompileThreads = 0;
+		g_ShaderCompileThreads.Get(numCompileThreads);
+		// Note: Shaders are loaded concurrently from the main thread, pipelines created in the background
+		// and shader reloads, each of which compiles its own shaders while sharing the workers.
+		m_CompileThreadPool = MakePtr<ThreadPool>(numCompileThreads, MAX_CONCURRENT_SHADER_LOADS);
+		m_ShaderFileCache = MakePtr<ShaderFileCache>();
+		// Note: DXC compiler instances are not safe to share across threads, so each thread that
+		// compiles shaders gets its own.
+		m_ShaderCompilers.resize(m_CompileThreadPool->GetNumThreads());
+		m_CompilerVersion = GetShaderCompiler(0).GetVersionString();
+
+		bool bDisableShaderCache = false;
+		g_DisableShaderCache.Get(bDisableShaderCache);
+		if (!bDisableShaderCache)
+		{
+			m_ShaderCache = MakePtr<ShaderCache>(SHADER_CACHE_PATH);
+		}
+
+		std::string shaderArchivePath;
+		if (g_ShaderArchive.Get(shaderArchivePath))
+		{
+			m_ShaderArchive = MakePtr<ShaderArchive>();
+			if (!m_ShaderArchive->Open(shaderArchivePath))
+			{
+				VAST_LOG_WARNING("[resource] [shader] Failed to open shader archive '{}'. Shaders will be compiled from source.", shaderArchivePath);
+				m_ShaderArchive = nullptr;
+			}
+		}
 
 		const std::string shaderSourcePath = VAST_SHADERS_SOURCE_PATH;
 		m_ShaderIncludeDirectories.push_back(std::wstring(shaderSourcePath.begin(), shaderSourcePath.end()));
@@ -39,21 +103,47 @@ namespace vast
 			m_ShaderIncludeDirectories.push_back(std::wstring(projectShaderSourcePath.begin(), projectShaderSourcePath.end()));
 		}
 
-		AddGlobalShaderDefine(L"PushConstantRegister=b" + std::to_wstring(PUSH_CONSTANT_REGISTER_INDEX));
+		for (const auto& define : GetEngineShaderDefines())
+		{
+			AddGlobalShaderDefine(define);
+		}
+
+		bool bDisableShaderManifest = false;
+		g_DisableShaderManifest.Get(bDisableShaderManifest);
+		if (!bDisableShaderManifest)
+		{
+			m_ShaderManifestPath = SHADER_MANIFEST_PATH;
+			PrecompileShaderManifest();
+		}
 	}
 
 	DX12ShaderManager::~DX12ShaderManager()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
-		for (auto shader : m_Shaders)
+		WriteShaderManifest();
+
+		for (auto& loadedShader : m_Shaders)
 		{
-			DX12SafeRelease(shader.first->blob);
-			DX12SafeRelease(shader.first->reflection);
-			shader.first = nullptr; // TODO: Make sure all shaders are deleted here (pass weak ptr instead of ref?)
+			DX12SafeRelease(loadedShader.shader->blob);
+			loadedShader.shader = nullptr; // TODO: Make sure all shaders are deleted here (pass weak ptr instead of ref?)
 		}
 		m_Shaders.clear();
+		// Note: Shaders loaded from the archive point into its mapped memory, so it must be closed
+		// after they are released.
+		m_ShaderArchive = nullptr;
 
-		m_ShaderCompiler = nullptr;
+		if (m_ShaderCache)
+		{
+			const ShaderCacheStats stats = m_ShaderCache->GetStats();
+			VAST_LOG_INFO("[resource] [shader] Shader cache: {} hits, {} misses ({} rejected), {} stores.", stats.numHits, stats.numMisses, stats.numRejected, stats.numStores);
+			m_ShaderCache = nullptr;
+		}
+		m_CompileThreadPool = nullptr;
+		m_ShaderCompilers.clear();
+
+		const ShaderFileCacheStats fileStats = m_ShaderFileCache->GetStats();
+		VAST_LOG_INFO("[resource] [shader] Shader file cache: {} hits, {} reads.", fileStats.numHits, fileStats.numReads);
+		m_ShaderFileCache = nullptr;
 	}
 
 	void DX12ShaderManager::AddGlobalShaderDefine(const std::wstring& define)
@@ -62,72 +152,350 @@ namespace vast
 	}
 
 	Ref<DX12Shader> DX12ShaderManager::LoadShader(const ShaderDesc& desc)
+	{
+		return LoadShaders({ desc })[0];
+	}
+
+	Vector<Ref<DX12Shader>> DX12ShaderManager::LoadShaders(const Vector<ShaderDesc>& descs)
+	{
+		return LoadShaders(descs, LoadMode::WAIT_FOR_FIXES);
+	}
+
+	Vector<Ref<DX12Shader>> DX12ShaderManager::TryLoadShaders(const Vector<ShaderDesc>& descs)
+	{
+		return LoadShaders(descs, LoadMode::SKIP_FAILED);
+	}
+
+	Vector<Ref<DX12Shader>> DX12ShaderManager::LoadShaders(const Vector<ShaderDesc>& descs, LoadMode mode)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		Ref<DX12Shader> shaderRef;
- 		auto key = MakeShaderKey(desc.shaderName, desc.entryPoint);
-		if (IsShaderRegistered(key))
+		Vector<Ref<DX12Shader>> shaders(descs.size());
+		const bool bIsUsed = (mode != LoadMode::PRECOMPILE);
+
+		// Gather shaders that haven't been loaded yet, once each.
+		// Note: The lock isn't held while compiling, so that loading from one thread doesn't block
+		// others from using the shaders that are already loaded.
+		Vector<LoadedShader> newShaders;
+		FlatHashMap<uint32> newShaderIndices;
+		std::unique_lock<std::mutex> lock(m_ShadersMutex);
+		for (uint32 i = 0; i < descs.size(); ++i)
 		{
-			shaderRef = m_Shaders[m_ShaderKeys[key]].first;
+			const ShaderDesc& desc = descs[i];
+			const ShaderKey key = MakeShaderKey(desc);
+			if (const uint32* idx = m_ShaderIndices.Find(key))
+			{
+				VAST_DEBUG_ONLY(CheckShaderKeyCollision(desc, m_Shaders[*idx].desc));
+				shaders[i] = m_Shaders[*idx].shader;
+				m_Shaders[*idx].bIsUsed |= bIsUsed;
+			}
+			else if (const uint32* newIdx = newShaderIndices.Find(key))
+			{
+				VAST_DEBUG_ONLY(CheckShaderKeyCollision(desc, newShaders[*newIdx].desc));
+				shaders[i] = newShaders[*newIdx].shader;
+			}
+			else
+			{
+				shaders[i] = MakeRef<DX12Shader>();
+				shaders[i]->key = key;
+				newShaderIndices.Insert(key, static_cast<uint32>(newShaders.size()));
+				newShaders.push_back({ shaders[i], desc, {}, false, bIsUsed });
+			}
 		}
-		else
+		lock.unlock();
+
+		Vector<uint8> results(newShaders.size(), 0);
+		m_CompileThreadPool->ParallelFor(static_cast<uint32>(newShaders.size()), [&](uint32 i, uint32 threadIdx)
+			{
+				const ShaderDesc& desc = newShaders[i].desc;
+				newShaders[i].files = GetShaderFiles(desc);
+				if (LoadShaderFromArchive(desc, newShaders[i].shader.get(), GetShaderCompiler(threadIdx)))
+				{
+					results[i] = true;
+					return;
+				}
+				VAST_LOG_INFO("[resource] [shader] Compiling new shader '{}' with entry point '{}'", desc.shaderName, desc.entryPoint);
+				results[i] = CompileShader(desc, newShaders[i].shader.get(), GetShaderCompiler(threadIdx));
+			});
+
+		for (uint32 i = 0; i < newShaders.size(); ++i)
 		{
-			shaderRef = MakeRef<DX12Shader>();
-			shaderRef->key = key;
+			LoadedShader& newShader = newShaders[i];
+			const ShaderDesc& desc = newShader.desc;
+
+			bool success = results[i];
+			if (!success && mode != LoadMode::WAIT_FOR_FIXES)
+			{
+				if (mode == LoadMode::PRECOMPILE)
+				{
+					VAST_LOG_WARNING("[resource] [shader] Skipping precompile of shader '{}' with entry point '{}' due to a compile error.", desc.shaderName, desc.entryPoint);
+				}
+				else
+				{
+					VAST_LOG_WARNING("[resource] [shader] Failed to load shader '{}' with entry point '{}' due to a compile error.", desc.shaderName, desc.entryPoint);
+				}
+				// Note: Failed shaders aren't registered, so that loading them again retries the compile.
+				std::replace(shaders.begin(), shaders.end(), newShader.shader, Ref<DX12Shader>());
+				newShader.shader = nullptr;
+				continue;
+			}
 
-			bool success = false;
 			while (!success)
 			{
-				VAST_LOG_INFO("[resource] [shader] Compiling new shader '{}' with entry point '{}'", desc.shaderName, desc.entryPoint);
 				// If we get a shader compile error on startup, allow the user to fix the issue and continue launching the application.
-				success = CompileShader(desc, shaderRef.get());
 				VAST_ASSERTF(success, "Shader Compilation Failed.");
+				VAST_LOG_INFO("[resource] [shader] Compiling new shader '{}' with entry point '{}'", desc.shaderName, desc.entryPoint);
+				newShader.files = GetShaderFiles(desc);
+				// Note: Compilers are only used from within ParallelFor, which keeps this from racing
+				// with a reload compiling in the background.
+				m_CompileThreadPool->ParallelFor(1, [&](uint32, uint32 threadIdx)
+					{
+						success = CompileShader(desc, newShader.shader.get(), GetShaderCompiler(threadIdx));
+					});
 			}
+		}
+
+		lock.lock();
+		for (auto& newShader : newShaders)
+		{
+			if (!newShader.shader)
+				continue;
 
-			m_ShaderKeys[key] = static_cast<uint32>(m_Shaders.size());
-			m_Shaders.push_back({ shaderRef, desc });
+			// Another thread may have loaded the same shader in the meantime, in which case the one it
+			// registered is used instead, so that all pipelines share a single version of each shader.
+			if (const uint32* idx = m_ShaderIndices.Find(newShader.shader->key))
+			{
+				LoadedShader& loadedShader = m_Shaders[*idx];
+				loadedShader.bIsUsed |= newShader.bIsUsed;
+				std::replace(shaders.begin(), shaders.end(), newShader.shader, loadedShader.shader);
+				DX12SafeRelease(newShader.shader->blob);
+				continue;
+			}
+
+			const uint32 shaderIdx = static_cast<uint32>(m_Shaders.size());
+			m_ShaderIndices.Insert(newShader.shader->key, shaderIdx);
+			m_Shaders.push_back({ newShader.shader, newShader.desc, {}, false, newShader.bIsUsed });
+			TrackShaderFiles(shaderIdx, std::move(newShader.files));
 		}
+		lock.unlock();
 
-		VAST_ASSERT(shaderRef);
-		VAST_ASSERT(shaderRef->blob);
-		VAST_ASSERT(shaderRef->reflection);
-		return shaderRef;
+		for (const auto& shaderRef : shaders)
+		{
+			VAST_ASSERT(shaderRef || mode != LoadMode::WAIT_FOR_FIXES);
+			VAST_ASSERT(!shaderRef || shaderRef->blob);
+		}
+		return shaders;
 	}
 
-	bool DX12ShaderManager::ReloadShader(Ref<DX12Shader> shader)
+	void DX12ShaderManager::PrecompileShaderManifest()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
-		VAST_ASSERTF(IsShaderRegistered(shader->key), "Attempted to reload invalid shader.");
 
-		auto desc = m_Shaders[m_ShaderKeys[shader->key]].second;
-		VAST_ASSERT(shader->key.compare(MakeShaderKey(desc.shaderName, desc.entryPoint)) == 0);
-		if (CompileShader(desc, shader.get()))
+		Vector<uint8> data;
+		if (!Filesystem::ReadFile(m_ShaderManifestPath, data))
+			return;
+
+		Vector<ShaderDesc> descs = ParseShaderManifest(std::string(data.begin(), data.end()));
+		// Note: Shaders may have been removed or renamed since the manifest was written.
+		std::erase_if(descs, [](const ShaderDesc& desc) { return !Filesystem::FileExists(desc.filePath + desc.shaderName); });
+
+		VAST_LOG_INFO("[resource] [shader] Precompiling {} shaders from shader manifest '{}'.", descs.size(), m_ShaderManifestPath);
+		LoadShaders(descs, LoadMode::PRECOMPILE);
+	}
+
+	void DX12ShaderManager::WriteShaderManifest() const
+	{
+		if (m_ShaderManifestPath.empty())
+			return;
+
+		Vector<ShaderDesc> descs;
+		for (const auto& loadedShader : m_Shaders)
+		{
+			if (loadedShader.bIsUsed)
+			{
+				descs.push_back(loadedShader.desc);
+			}
+		}
+
+		// Note: Keep the previous manifest if nothing was used, e.g. if the run ended during startup.
+		if (descs.empty())
+			return;
+
+		const std::string data = SerializeShaderManifest(descs);
+		if (!Filesystem::WriteFile(m_ShaderManifestPath, data.data(), data.size()))
 		{
-			VAST_LOG_TRACE("[resource] [shader] Reloaded shader '{}' with entry point '{}'.", desc.shaderName, desc.entryPoint);
-			return true;
+			VAST_LOG_WARNING("[resource] [shader] Failed to write shader manifest '{}'.", m_ShaderManifestPath);
 		}
-		VAST_LOG_WARNING("[resource] [shader] Failed to reload shader '{}' with entry point '{}' due to a compile error.", desc.shaderName, desc.entryPoint);
-		return false;
 	}
 
-	std::string DX12ShaderManager::MakeShaderKey(const std::string& shaderName, const std::string& entryPoint) const
+	Vector<DX12ShaderReload> DX12ShaderManager::PrepareShaderReloads(const Vector<Ref<DX12Shader>>& shaders)
 	{
-		// TODO: This could be a hash.
-		return shaderName + ',' + entryPoint;
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		UpdateOutOfDateShaders();
+
+		// Only shaders affected by a file change are compiled.
+		std::lock_guard<std::mutex> lock(m_ShadersMutex);
+		Vector<DX12ShaderReload> reloads;
+		for (const auto& shader : shaders)
+		{
+			VAST_ASSERTF(IsShaderRegistered(shader->key), "Attempted to reload invalid shader.");
+			const LoadedShader& loadedShader = m_Shaders[*m_ShaderIndices.Find(shader->key)];
+			VAST_ASSERT(shader->key == MakeShaderKey(loadedShader.desc));
+			if (loadedShader.bIsOutOfDate)
+			{
+				DX12ShaderReload reload;
+				reload.shader = shader;
+				reload.desc = loadedShader.desc;
+				reloads.push_back(std::move(reload));
+			}
+		}
+		return reloads;
 	}
 
-	bool DX12ShaderManager::IsShaderRegistered(const std::string key) const
+	void DX12ShaderManager::CompileShaderReloads(Vector<DX12ShaderReload>& reloads)
 	{
-		return (m_ShaderKeys.find(key) != m_ShaderKeys.end());
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		// Note: Reloads hold their own copy of everything they need, since loaded shaders may be
+		// added from another thread in the meantime.
+		m_CompileThreadPool->ParallelFor(static_cast<uint32>(reloads.size()), [&](uint32 i, uint32 threadIdx)
+			{
+				DX12ShaderReload& reload = reloads[i];
+				reload.files = GetShaderFiles(reload.desc);
+				reload.bSucceeded = CompileShader(reload.desc, &reload.compiled, GetShaderCompiler(threadIdx));
+			});
 	}
 
-	bool DX12ShaderManager::CompileShader(const ShaderDesc& desc, DX12Shader* outShader)
+	void DX12ShaderManager::ApplyShaderReloads(Vector<DX12ShaderReload>& reloads)
 	{
-		const std::wstring shaderName(desc.shaderName.begin(), desc.shaderName.end());
-		const std::wstring fullPath = std::wstring(desc.filePath.begin(), desc.filePath.end()) + shaderName;
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		std::lock_guard<std::mutex> lock(m_ShadersMutex);
+		for (auto& reload : reloads)
+		{
+			const ShaderDesc& desc = reload.desc;
+			const uint32 shaderIdx = *m_ShaderIndices.Find(reload.shader->key);
+			// Note: Includes are tracked even if compilation failed, since adding or fixing one may be
+			// what makes the next attempt succeed.
+			TrackShaderFiles(shaderIdx, std::move(reload.files));
+
+			if (reload.bSucceeded)
+			{
+				DX12SafeRelease(reload.shader->blob);
+				reload.shader->blob = reload.compiled.blob;
+				reload.shader->reflection = std::move(reload.compiled.reflection);
+				reload.compiled.blob = nullptr;
+				m_Shaders[shaderIdx].bIsOutOfDate = false;
+				VAST_LOG_TRACE("[resource] [shader] Reloaded shader '{}' with entry point '{}'.", desc.shaderName, desc.entryPoint);
+			}
+			else
+			{
+				VAST_LOG_WARNING("[resource] [shader] Failed to reload shader '{}' with entry point '{}' due to a compile error.", desc.shaderName, desc.entryPoint);
+			}
+		}
+	}
+
+	bool DX12ShaderManager::LoadShaderFromArchive(const ShaderDesc& desc, DX12Shader* outShader, DX12ShaderCompiler& compiler)
+	{
+		ShaderArchiveEntry entry;
+		if (!m_ShaderArchive || !m_ShaderArchive->FindShader(outShader->key, entry))
+			return false;
+
+		if (entry.type != desc.type || entry.reflectionSize == 0)
+		{
+			VAST_LOG_WARNING("[resource] [shader] Shader '{}' with entry point '{}' doesn't match its shader archive entry.", desc.shaderName, desc.entryPoint);
+			return false;
+		}
+
+		// Note: Archives store the compiler's reflection data, since they can be built on platforms
+		// without the graphics API to reflect it.
+		if (!compiler.ReflectShader(entry.reflection, entry.reflectionSize, outShader->reflection))
+		{
+			VAST_LOG_WARNING("[resource] [shader] Failed to reflect shader '{}' with entry point '{}' from shader archive.", desc.shaderName, desc.entryPoint);
+			return false;
+		}
 
-		IDxcBlobEncoding* sourceBlobEncoding = m_ShaderCompiler->LoadShader(fullPath);
+		VAST_ASSERT(!outShader->blob);
+		outShader->blob = compiler.CreateBlobFromPinned(entry.bytecode, entry.bytecodeSize);
+		VAST_LOG_TRACE("[resource] [shader] Loaded shader '{}' with entry point '{}' from shader archive.", desc.shaderName, desc.entryPoint);
+		return true;
+	}
+
+	DX12ShaderCompiler& DX12ShaderManager::GetShaderCompiler(uint32 threadIdx)
+	{
+		// Note: Each slot is only ever accessed from the thread that owns the index during a
+		// ParallelFor, so compilers can be created lazily without synchronization.
+		VAST_ASSERT(threadIdx < m_ShaderCompilers.size());
+		if (!m_ShaderCompilers[threadIdx])
+		{
+			m_ShaderCompilers[threadIdx] = MakePtr<DX12ShaderCompiler>(*m_ShaderFileCache);
+		}
+		return *m_ShaderCompilers[threadIdx];
+	}
+
+	bool DX12ShaderManager::IsShaderRegistered(ShaderKey key) const
+	{
+		return m_ShaderIndices.Contains(key);
+	}
+
+	Vector<std::string> DX12ShaderManager::GetShaderFiles(const ShaderDesc& desc) const
+	{
+		const std::string sourcePath = std::filesystem::path(desc.filePath + desc.shaderName).lexically_normal().string();
+		Vector<std::string> files = CollectShaderIncludes(sourcePath, m_ShaderIncludeDirectories, *m_ShaderFileCache);
+		files.insert(files.begin(), sourcePath);
+		return files;
+	}
+
+	void DX12ShaderManager::TrackShaderFiles(uint32 shaderIdx, Vector<std::string>&& files)
+	{
+		LoadedShader& loadedShader = m_Shaders[shaderIdx];
+		for (const auto& file : loadedShader.files)
+		{
+			auto& dependents = m_ShaderFileDependents[file];
+			dependents.erase(std::remove(dependents.begin(), dependents.end(), shaderIdx), dependents.end());
+		}
+
+		for (const auto& file : files)
+		{
+			m_ShaderFileDependents[file].push_back(shaderIdx);
+			m_ShaderFileWatcher.AddFile(file);
+		}
+		loadedShader.files = std::move(files);
+	}
+
+	bool DX12ShaderManager::UpdateOutOfDateShaders()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		std::lock_guard<std::mutex> lock(m_ShadersMutex);
+		bool bAnyOutOfDate = false;
+		Vector<std::string> changedFiles;
+		m_ShaderFileWatcher.Poll(changedFiles);
+		for (const auto& file : changedFiles)
+		{
+			auto it = m_ShaderFileDependents.find(file);
+			if (it == m_ShaderFileDependents.end())
+				continue;
+
+			for (uint32 shaderIdx : it->second)
+			{
+				LoadedShader& loadedShader = m_Shaders[shaderIdx];
+				if (!loadedShader.bIsOutOfDate)
+				{
+					VAST_LOG_TRACE("[resource] [shader] Shader '{}' with entry point '{}' is out of date ('{}' changed).", loadedShader.desc.shaderName, loadedShader.desc.entryPoint, file);
+					loadedShader.bIsOutOfDate = true;
+					bAnyOutOfDate = true;
+				}
+			}
+		}
+		return bAnyOutOfDate;
+	}
+
+	bool DX12ShaderManager::CompileShader(const ShaderDesc& desc, DX12Shader* outShader, DX12ShaderCompiler& compiler)
+	{
+		const std::wstring shaderName(desc.shaderName.begin(), desc.shaderName.end());
+		const std::string fullPath = desc.filePath + desc.shaderName;
 
 		ShaderCompilerArguments sca;
 		sca.shaderType = desc.type;
@@ -135,52 +503,62 @@ namespace vast
 		sca.shaderEntryPoint = std::wstring(desc.entryPoint.begin(), desc.entryPoint.end());
 		sca.includeDirectories = m_ShaderIncludeDirectories;
 		sca.additionalDefines = m_GlobalShaderDefines;
+		for (const auto& define : desc.permutationDomain.GetDefines(desc.permutation))
+		{
+			sca.additionalDefines.push_back(std::wstring(define.begin(), define.end()));
+		}
+
+		uint64 cacheKey = 0;
+		const bool bUseCache = m_ShaderCache && m_ShaderCache->IsEnabled()
+			&& ComputeShaderCacheKey(fullPath, m_ShaderIncludeDirectories, *m_ShaderFileCache, compiler.GetArguments(sca), m_CompilerVersion, cacheKey);
+
+		IDxcBlob* shaderBlob = nullptr;
+		ShaderReflection shaderReflection;
+
+		// Note: The cache stores reflection already serialized, so cached shaders don't go through the
+		// compiler's reflection at all.
+		ShaderCacheEntry cacheEntry;
+		if (bUseCache && m_ShaderCache->Load(cacheKey, cacheEntry)
+			&& DeserializeShaderReflection(cacheEntry.reflection.data(), cacheEntry.reflection.size(), shaderReflection))
+		{
+			VAST_LOG_TRACE("[resource] [shader] Loaded shader '{}' with entry point '{}' from cache.", desc.shaderName, desc.entryPoint);
+			shaderBlob = compiler.CreateBlob(cacheEntry.bytecode.data(), cacheEntry.bytecode.size());
+		}
+		else
+		{
+			IDxcBlobEncoding* sourceBlobEncoding = compiler.LoadShader(std::wstring(fullPath.begin(), fullPath.end()));
+			if (!sourceBlobEncoding)
+				return false;
+
+			IDxcResult* compiledShader = compiler.CompileShader(sourceBlobEncoding, sca);
+			DX12SafeRelease(sourceBlobEncoding);
+			if (!compiledShader)
+				return false;
+
+			shaderBlob = compiler.ExtractShaderOutput(compiledShader);
+			IDxcBlob* reflectionBlob = compiler.ExtractShaderReflectionBlob(compiledShader);
+			const bool bReflected = compiler.ReflectShader(reflectionBlob->GetBufferPointer(), reflectionBlob->GetBufferSize(), shaderReflection);
+			DX12SafeRelease(reflectionBlob);
+			DX12SafeRelease(compiledShader);
+
+			if (!bReflected)
+			{
+				VAST_LOG_ERROR("[resource] [shader] Failed to reflect shader '{}' with entry point '{}'.", desc.shaderName, desc.entryPoint);
+				DX12SafeRelease(shaderBlob);
+				return false;
+			}
 
-		IDxcResult* compiledShader = m_ShaderCompiler->CompileShader(sourceBlobEncoding, sca);
-
-		ID3D12ShaderReflection* shaderReflection = m_ShaderCompiler->ExtractShaderReflection(compiledShader);
-
-		// TODO: Support loading shaders from different folders.
-// 		if (!std::filesystem::exists(SHADER_OUTPUT_PATH))
-// 		{
-// 			VAST_VERIFYF(std::filesystem::create_directory(SHADER_OUTPUT_PATH), "Failed to create compiled shaders directory.");
-// 		}
-
-		IDxcBlob* shaderBlob = m_ShaderCompiler->ExtractShaderOutput(compiledShader);
-// 		{
-// 			std::wstring dxilPath = SHADER_OUTPUT_PATH + shaderName;
-// 			dxilPath.erase(dxilPath.end() - 5, dxilPath.end());
-// 			dxilPath.append(L".dxil"); // .bin?
-// 
-// 			FILE* fp = nullptr;
-// 			_wfopen_s(&fp, dxilPath.c_str(), L"wb");
-// 			VAST_ASSERTF(fp, "Cannot find specified path.");
-// 			fwrite(shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(), 1, fp);
-// 			fclose(fp);
-// 		}
-// #ifdef VAST_DEBUG
-// 		IDxcBlob* shaderDebugBlob = m_ShaderCompiler->ExtractShaderPDB(compiledShader);
-// 		{
-// 			std::wstring pdbPath = SHADER_OUTPUT_PATH + shaderName;
-// 			pdbPath.erase(pdbPath.end() - 5, pdbPath.end());
-// 			pdbPath.append(L".pdb");
-// 
-// 			FILE* fp = nullptr;
-// 			_wfopen_s(&fp, pdbPath.c_str(), L"wb");
-// 			VAST_ASSERTF(fp, "Cannot find specified path.");
-// 			fwrite(shaderDebugBlob->GetBufferPointer(), shaderDebugBlob->GetBufferSize(), 1, fp);
-// 			fclose(fp);
-// 		}
-// 		DX12SafeRelease(shaderDebugBlob);
-// #endif
-
-		DX12SafeRelease(sourceBlobEncoding);
-		DX12SafeRelease(compiledShader);
+			if (bUseCache)
+			{
+				const Vector<uint8> serializedReflection = SerializeShaderReflection(shaderReflection);
+				m_ShaderCache->Store(cacheKey, shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize(),
+					serializedReflection.data(), serializedReflection.size());
+			}
+		}
 
 		DX12SafeRelease(outShader->blob);
-		DX12SafeRelease(outShader->reflection);
 		outShader->blob = shaderBlob;
-		outShader->reflection = shaderReflection;
+		outShader->reflection = std::move(shaderReflection);
 		return true;
 	}
 
@@ -197,39 +575,29 @@ namespace vast
 			if (!shader)
 				continue;
 
-			D3D12_SHADER_DESC shaderDesc{};
-			shader->reflection->GetDesc(&shaderDesc);
-
-			for (uint32 rscIdx = 0; rscIdx < shaderDesc.BoundResources; ++rscIdx)
+			for (const auto& resource : shader->reflection.resources)
 			{
-				D3D12_SHADER_INPUT_BIND_DESC sibDesc{};
-				DX12Check(shader->reflection->GetResourceBindingDesc(rscIdx, &sibDesc));
-
 				// Skip resource if it was already registered on a previous shader of this pipeline.
-				if (pipeline.resourceProxyTable.IsRegistered(sibDesc.Name))
+				if (pipeline.resourceProxyTable.IsRegistered(resource.name))
 					continue;
 
-				pipeline.resourceProxyTable.Register(sibDesc.Name, ShaderResourceProxy{ static_cast<uint32>(rootParameters.size()) });
-				VAST_LOG_TRACE("[resource] [shader] Registered shader resource '{}'.", sibDesc.Name);
+				pipeline.resourceProxyTable.Register(resource.name, ShaderResourceProxy{ static_cast<uint32>(rootParameters.size()) });
+				VAST_LOG_TRACE("[resource] [shader] Registered shader resource '{}'.", resource.name);
 
-				switch (sibDesc.Type)
+				switch (resource.type)
 				{
-				case D3D_SIT_CBUFFER:
+				case ShaderResourceType::CONSTANT_BUFFER:
 				{
 					// CBV or PushConstants
-					ID3D12ShaderReflectionConstantBuffer* shaderReflectionCB = shader->reflection->GetConstantBufferByIndex(rscIdx);
-					D3D12_SHADER_BUFFER_DESC cbDesc{};
-					shaderReflectionCB->GetDesc(&cbDesc);
-
 					D3D12_ROOT_PARAMETER1 rootParameter = {};
 
-					if (sibDesc.BindPoint == PUSH_CONSTANT_REGISTER_INDEX)
+					if (resource.bindPoint == PUSH_CONSTANT_REGISTER_INDEX)
 					{
 						rootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
 						rootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
-						rootParameter.Constants.ShaderRegister = sibDesc.BindPoint;
-						rootParameter.Constants.RegisterSpace = sibDesc.Space;
-						rootParameter.Constants.Num32BitValues = cbDesc.Size / 4;
+						rootParameter.Constants.ShaderRegister = resource.bindPoint;
+						rootParameter.Constants.RegisterSpace = resource.space;
+						rootParameter.Constants.Num32BitValues = resource.size / 4;
 
 						VAST_ASSERTF(pipeline.pushConstantIndex == UINT8_MAX, "Multiple push constants for a single pipeline not currently supported.");
 						pipeline.pushConstantIndex = static_cast<uint8>(rootParameters.size());
@@ -238,8 +606,8 @@ namespace vast
 					{
 						rootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
 						rootParameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
-						rootParameter.Descriptor.ShaderRegister = sibDesc.BindPoint;
-						rootParameter.Descriptor.RegisterSpace = sibDesc.Space;
+						rootParameter.Descriptor.ShaderRegister = resource.bindPoint;
+						rootParameter.Descriptor.RegisterSpace = resource.space;
 						// TODO: Review usage, ideally we can set D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC for most stuff.
 						rootParameter.Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
 					}
@@ -247,15 +615,14 @@ namespace vast
 					rootParameters.push_back(rootParameter);
 					break;
 				}
-				case D3D_SIT_STRUCTURED:
-				case D3D_SIT_TEXTURE:
+				case ShaderResourceType::SRV:
 				{
 					// SRV
 					D3D12_DESCRIPTOR_RANGE1 descriptorRange = {};
 					descriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
 					descriptorRange.NumDescriptors = 1;
-					descriptorRange.BaseShaderRegister = sibDesc.BindPoint;
-					descriptorRange.RegisterSpace = sibDesc.Space;
+					descriptorRange.BaseShaderRegister = resource.bindPoint;
+					descriptorRange.RegisterSpace = resource.space;
 					// TODO: Review usage, ideally we can set D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC for most stuff.
 					descriptorRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
 					descriptorRange.OffsetInDescriptorsFromTableStart = static_cast<uint32>(descriptorRanges.size());
@@ -263,15 +630,14 @@ namespace vast
 					descriptorRanges.push_back(descriptorRange);
 					break;
 				}
-				case D3D_SIT_UAV_RWSTRUCTURED:
-				case D3D_SIT_UAV_RWTYPED:
+				case ShaderResourceType::UAV:
 				{
 					// UAV
 					D3D12_DESCRIPTOR_RANGE1 descriptorRange = {};
 					descriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
 					descriptorRange.NumDescriptors = 1;
-					descriptorRange.BaseShaderRegister = sibDesc.BindPoint;
-					descriptorRange.RegisterSpace = sibDesc.Space;
+					descriptorRange.BaseShaderRegister = resource.bindPoint;
+					descriptorRange.RegisterSpace = resource.space;
 					// TODO: Review usage, ideally we can set D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC for most stuff.
 					descriptorRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
 					descriptorRange.OffsetInDescriptorsFromTableStart = static_cast<uint32>(descriptorRanges.size());
@@ -279,7 +645,7 @@ namespace vast
 					descriptorRanges.push_back(descriptorRange);
 					break;
 				}
-				case D3D_SIT_SAMPLER:
+				case ShaderResourceType::SAMPLER:
 					break; // TODO: Should we assert here? Test using one of these
 				default:
 					VAST_ASSERTF(0, "Shader Input type not currently supported.");
@@ -300,6 +666,111 @@ namespace vast
 			rootParameters.push_back(descriptorTable);
 		}
 
+		pipeline.resourceProxyTable.Build();
+
+		return SerializeRootSignature(rootParameters);
+	}
+
+	ID3DBlob* DX12ShaderManager::CreateGlobalRootSignature() const
+	{
+		Vector<D3D12_ROOT_PARAMETER1> rootParameters;
+
+		D3D12_ROOT_PARAMETER1 pushConstants = {};
+		pushConstants.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+		pushConstants.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+		pushConstants.Constants.ShaderRegister = PUSH_CONSTANT_REGISTER_INDEX;
+		pushConstants.Constants.RegisterSpace = 0;
+		pushConstants.Constants.Num32BitValues = GLOBAL_ROOT_SIGNATURE_NUM_PUSH_CONSTANTS;
+		rootParameters.push_back(pushConstants);
+
+		for (uint32 i = 0; i < GLOBAL_ROOT_SIGNATURE_NUM_ROOT_CBVS; ++i)
+		{
+			D3D12_ROOT_PARAMETER1 rootCBV = {};
+			rootCBV.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+			rootCBV.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+			rootCBV.Descriptor.ShaderRegister = i;
+			rootCBV.Descriptor.RegisterSpace = 0;
+			rootCBV.Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+			rootParameters.push_back(rootCBV);
+		}
+
+		return SerializeRootSignature(rootParameters);
+	}
+
+	bool DX12ShaderManager::MapToGlobalRootSignature(DX12Pipeline& pipeline) const
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		DX12Shader* shaders[] = { pipeline.vs.get(), pipeline.ps.get(), pipeline.cs.get() };
+
+		// Validate every shader first, so that the pipeline is left untouched if any doesn't fit.
+		for (auto shader : shaders)
+		{
+			if (!shader)
+				continue;
+
+			for (const auto& resource : shader->reflection.resources)
+			{
+				bool bIsCompatible = false;
+				switch (resource.type)
+				{
+				case ShaderResourceType::CONSTANT_BUFFER:
+					if (resource.bindPoint == PUSH_CONSTANT_REGISTER_INDEX)
+					{
+						bIsCompatible = (resource.space == 0 && resource.size <= GLOBAL_ROOT_SIGNATURE_NUM_PUSH_CONSTANTS * 4);
+					}
+					else
+					{
+						bIsCompatible = (resource.space == 0 && resource.bindPoint < GLOBAL_ROOT_SIGNATURE_NUM_ROOT_CBVS);
+					}
+					break;
+				case ShaderResourceType::SAMPLER:
+					// Note: Matches CreateRootSignatureFromReflection, which doesn't bind samplers either.
+					bIsCompatible = true;
+					break;
+				default:
+					// SRVs and UAVs bound to registers need a descriptor table.
+					break;
+				}
+
+				if (!bIsCompatible)
+				{
+					VAST_LOG_WARNING("[resource] [shader] Shader resource '{}' (register {}, space {}) doesn't fit the global root signature.",
+						resource.name, resource.bindPoint, resource.space);
+					return false;
+				}
+			}
+		}
+
+		for (auto shader : shaders)
+		{
+			if (!shader)
+				continue;
+
+			for (const auto& resource : shader->reflection.resources)
+			{
+				if (resource.type != ShaderResourceType::CONSTANT_BUFFER || pipeline.resourceProxyTable.IsRegistered(resource.name))
+					continue;
+
+				// Push constants are the first root parameter, followed by a root CBV per register.
+				const bool bIsPushConstants = (resource.bindPoint == PUSH_CONSTANT_REGISTER_INDEX);
+				const uint32 rootParameterIdx = bIsPushConstants ? 0 : 1 + resource.bindPoint;
+				pipeline.resourceProxyTable.Register(resource.name, ShaderResourceProxy{ rootParameterIdx });
+				VAST_LOG_TRACE("[resource] [shader] Registered shader resource '{}'.", resource.name);
+
+				if (bIsPushConstants)
+				{
+					pipeline.pushConstantIndex = 0;
+				}
+			}
+		}
+
+		pipeline.resourceProxyTable.Build();
+		return true;
+	}
+
+	ID3DBlob* DX12ShaderManager::SerializeRootSignature(const Vector<D3D12_ROOT_PARAMETER1>& rootParameters)
+	{
 		D3D12_ROOT_SIGNATURE_DESC1 rootSignatureDesc = {};
 		rootSignatureDesc.NumParameters		= static_cast<uint32>(rootParameters.size());
 		rootSignatureDesc.pParameters		= rootParameters.data();
@@ -322,25 +793,6 @@ namespace vast
 		DX12SafeRelease(errorBlob);
 		return rootSignatureBlob;
 	}
-	
-	Vector<D3D12_SIGNATURE_PARAMETER_DESC> DX12ShaderManager::GetInputParametersFromReflection(ID3D12ShaderReflection* reflection) const
-	{
-		VAST_ASSERT(reflection);
-
-		D3D12_SHADER_DESC shaderDesc{};
-		reflection->GetDesc(&shaderDesc);
 
-		Vector<D3D12_SIGNATURE_PARAMETER_DESC> params;
-		params.reserve(shaderDesc.InputParameters);
-
-		for (uint32 i = 0; i < shaderDesc.InputParameters; ++i)
-		{
-			D3D12_SIGNATURE_PARAMETER_DESC paramDesc = {};
-			reflection->GetInputParameterDesc(i, &paramDesc);
-			params.emplace_back(paramDesc);
-		}
-
-		return params;
-	}
 
 }
\ No newline at end of file
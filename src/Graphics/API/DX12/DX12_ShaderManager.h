@@ -1,12 +1,14 @@
 #pragma once
 
+#include "Core/FlatHashMap.h"
 #include "Graphics/ShaderResourceProxy.h"
 #include "Graphics/Resources.h"
 #include "Graphics/API/DX12/DX12_Common.h"
 
 #include "dx12/DirectXAgilitySDK/include/d3d12shader.h"
 
-struct ID3D12ShaderReflection;
+#include <mutex>
+
 
 // TODO: Refactor
 // - Shader "Manager" class should be higher level (not owned by device), and GFX API agnostic
@@ -15,9 +17,28 @@ struct ID3D12ShaderReflection;
 namespace vast
 {
 	class DX12ShaderCompiler;
+	class ThreadPool;
+	class ShaderCache;
+	class ShaderFileCache;
+	class ShaderArchive;
 	struct DX12Shader;
 	struct DX12Pipeline;
 
+	// Layout of the global root signature: push constants (in 32-bit values) at the push constant
+	// register, followed by root CBVs at registers b0 onwards, all in space 0.
+	constexpr uint32 GLOBAL_ROOT_SIGNATURE_NUM_PUSH_CONSTANTS = 16;
+	constexpr uint32 GLOBAL_ROOT_SIGNATURE_NUM_ROOT_CBVS = 3;
+
+	// New version of a loaded shader, compiled while the current one remains in use.
+	struct DX12ShaderReload
+	{
+		Ref<DX12Shader> shader;
+		ShaderDesc desc;
+		DX12Shader compiled;
+		Vector<std::string> files;
+		bool bSucceeded = false;
+	};
+
 	class DX12ShaderManager
 	{
 	public:
@@ -26,22 +47,97 @@ namespace vast
 
 		void AddGlobalShaderDefine(const std::wstring& define);
 
+		// Shaders can be loaded from multiple threads concurrently (e.g. by pipelines created in the
+		// background).
 		Ref<DX12Shader> LoadShader(const ShaderDesc& desc);
-		bool ReloadShader(Ref<DX12Shader> shader);
+		// Compiles all shaders that haven't been loaded yet in parallel, and returns them in the
+		// same order as the given descs. Each permutation of a shader is loaded as a separate shader.
+		Vector<Ref<DX12Shader>> LoadShaders(const Vector<ShaderDesc>& descs);
+		// Same as LoadShaders, but shaders that fail to compile are returned as null instead of waiting
+		// for the error to be fixed, and are compiled again the next time they are loaded. Used from
+		// background threads, where there is nobody to wait for the fix.
+		Vector<Ref<DX12Shader>> TryLoadShaders(const Vector<ShaderDesc>& descs);
+
+		// Shader reloads happen in three steps, so that compilation can run in the background while
+		// the current versions of the shaders keep being used:
+		// - Prepare returns a reload for each of the given shaders whose source file or any of its
+		//   includes changed since it was last compiled.
+		// - Compile compiles them in parallel without modifying any loaded shader, and can be called
+		//   from any thread. Only one set of reloads can be compiled at a time.
+		// - Apply replaces the loaded shaders with the versions that compiled successfully. Shaders
+		//   that failed keep their previous version, and remain out of date.
+		// Prepare and Apply must be called from the main thread, and Apply can't overlap with shaders
+		// being loaded from other threads, since it modifies loaded shaders in place.
+		Vector<DX12ShaderReload> PrepareShaderReloads(const Vector<Ref<DX12Shader>>& shaders);
+		void CompileShaderReloads(Vector<DX12ShaderReload>& reloads);
+		void ApplyShaderReloads(Vector<DX12ShaderReload>& reloads);
+		// Checks the source files and includes of all loaded shaders for changes, and returns true if
+		// any shader became out of date since the last check.
+		bool UpdateOutOfDateShaders();
 
 		ID3DBlob* CreateRootSignatureFromReflection(DX12Pipeline& pipeline) const;
-		Vector<D3D12_SIGNATURE_PARAMETER_DESC> GetInputParametersFromReflection(ID3D12ShaderReflection* reflection) const;
+		// Root signature that can be shared by all pipelines, holding push constants and a few root
+		// CBVs, with any other resources accessed through the descriptor heaps.
+		ID3DBlob* CreateGlobalRootSignature() const;
+		// Registers the pipeline's shader resources with the global root signature parameters they
+		// bind to. Returns false, leaving the pipeline untouched, if any of them doesn't fit in it.
+		bool MapToGlobalRootSignature(DX12Pipeline& pipeline) const;
 
 	private:
-		bool CompileShader(const ShaderDesc& desc, DX12Shader* outShader);
+		enum class LoadMode
+		{
+			// Shader compile errors block until the user fixes them, e.g. on startup.
+			WAIT_FOR_FIXES,
+			// Shaders that fail to compile are skipped.
+			SKIP_FAILED,
+			// Same as SKIP_FAILED, but loaded shaders aren't recorded as used.
+			PRECOMPILE,
+		};
+		Vector<Ref<DX12Shader>> LoadShaders(const Vector<ShaderDesc>& descs, LoadMode mode);
+		void PrecompileShaderManifest();
+		void WriteShaderManifest() const;
+
+		static ID3DBlob* SerializeRootSignature(const Vector<D3D12_ROOT_PARAMETER1>& rootParameters);
+
+		bool CompileShader(const ShaderDesc& desc, DX12Shader* outShader, DX12ShaderCompiler& compiler);
+		// Loads a new shader from the shader archive instead of compiling it, if found there.
+		bool LoadShaderFromArchive(const ShaderDesc& desc, DX12Shader* outShader, DX12ShaderCompiler& compiler);
+		DX12ShaderCompiler& GetShaderCompiler(uint32 threadIdx);
 
-		std::string MakeShaderKey(const std::string& shaderName, const std::string& entryPoint) const;
-		bool IsShaderRegistered(const std::string key) const;
+		bool IsShaderRegistered(ShaderKey key) const;
+
+		// Returns the source file of the shader followed by all the files it includes, recursively.
+		Vector<std::string> GetShaderFiles(const ShaderDesc& desc) const;
+		void TrackShaderFiles(uint32 shaderIdx, Vector<std::string>&& files);
 
 	private:
-		Ptr<DX12ShaderCompiler> m_ShaderCompiler;
-		std::unordered_map<std::string, uint32> m_ShaderKeys;
-		Vector<std::pair<Ref<DX12Shader>, ShaderDesc>> m_Shaders;
+		struct LoadedShader
+		{
+			Ref<DX12Shader> shader;
+			ShaderDesc desc;
+			Vector<std::string> files;
+			bool bIsOutOfDate = false;
+			bool bIsUsed = false;
+		};
+
+		Ptr<ThreadPool> m_CompileThreadPool;
+		// Shared by all compile threads.
+		Ptr<ShaderFileCache> m_ShaderFileCache;
+		// One per compile thread, indexed by thread index.
+		Vector<Ptr<DX12ShaderCompiler>> m_ShaderCompilers;
+		Ptr<ShaderCache> m_ShaderCache;
+		Ptr<ShaderArchive> m_ShaderArchive;
+		// Empty if the shader usage manifest is disabled.
+		std::string m_ShaderManifestPath;
+		std::string m_CompilerVersion;
+		// Guards the loaded shaders and their file dependencies.
+		std::mutex m_ShadersMutex;
+		// Index into m_Shaders for each loaded shader.
+		FlatHashMap<uint32> m_ShaderIndices;
+		Vector<LoadedShader> m_Shaders;
+		// Include graph: indices of the shaders that depend on each source or include file.
+		std::unordered_map<std::string, Vector<uint32>> m_ShaderFileDependents;
+		Filesystem::FileWatcher m_ShaderFileWatcher;
 		Vector<std::wstring> m_GlobalShaderDefines;
 		Vector<std::wstring> m_ShaderIncludeDirectories;
 	};
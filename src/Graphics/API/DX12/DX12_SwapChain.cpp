@@ -102,6 +102,8 @@ namespace vast
 			DX12Check(m_SwapChain->GetBuffer(i, IID_PPV_ARGS(&backBuffer)));
 			m_BackBuffers[i]->resource = backBuffer;
 			m_BackBuffers[i]->state	= D3D12_RESOURCE_STATE_PRESENT;
+			m_BackBuffers[i]->width = m_Size.x;
+			m_BackBuffers[i]->height = m_Size.y;
 			m_BackBuffers[i]->rtv = m_Device.CreateBackBufferRTV(backBuffer, TranslateToDX12(m_BackBufferFormat));
 			m_BackBuffers[i]->SetName(std::string("Back Buffer ") + std::to_string(i));
 		}
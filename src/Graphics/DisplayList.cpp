@@ -0,0 +1,252 @@
+#include "vastpch.h"
+#include "Graphics/DisplayList.h"
+
+#include <cstring>
+
+namespace vast
+{
+
+	DisplayList::DisplayList(uint32 capacityInBytes /* = kDefaultCapacity */)
+		: m_Memory(nullptr)
+		, m_Capacity(capacityInBytes)
+		, m_UsedBytes(0)
+		, m_NumCommands(0)
+		, m_bHasOverflowed(false)
+	{
+		VAST_ASSERTF(capacityInBytes > 0, "Invalid display list capacity.");
+		m_Memory = MakePtr<uint8[]>(capacityInBytes);
+	}
+
+	void DisplayList::Reset()
+	{
+		m_UsedBytes = 0;
+		m_NumCommands = 0;
+		m_bHasOverflowed = false;
+	}
+
+	void DisplayList::BeginRenderPass(PipelineHandle h, const RenderPassDesc& desc)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BeginRenderPass>(DisplayListCmdType::BEGIN_RENDER_PASS))
+		{
+			cmd->h = h;
+			cmd->desc = desc;
+		}
+	}
+
+	void DisplayList::BeginRenderPassToBackBuffer(PipelineHandle h, LoadOp loadOp /* = LoadOp::LOAD */, StoreOp storeOp /* = StoreOp::STORE */)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BeginRenderPassToBackBuffer>(DisplayListCmdType::BEGIN_RENDER_PASS_TO_BACK_BUFFER))
+		{
+			cmd->h = h;
+			cmd->loadOp = loadOp;
+			cmd->storeOp = storeOp;
+		}
+	}
+
+	void DisplayList::EndRenderPass()
+	{
+		PushCommand<DisplayListCmds::EndRenderPass>(DisplayListCmdType::END_RENDER_PASS);
+	}
+
+	void DisplayList::BindPipeline(PipelineHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindPipeline>(DisplayListCmdType::BIND_PIPELINE))
+		{
+			cmd->h = h;
+		}
+	}
+
+	void DisplayList::BindPipelineForCompute(PipelineHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindPipelineForCompute>(DisplayListCmdType::BIND_PIPELINE_FOR_COMPUTE))
+		{
+			cmd->h = h;
+		}
+	}
+
+	void DisplayList::AddBarrier(BufferHandle h, ResourceState newState)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::AddBarrierBuffer>(DisplayListCmdType::ADD_BARRIER_BUFFER))
+		{
+			cmd->h = h;
+			cmd->newState = newState;
+		}
+	}
+
+	void DisplayList::AddBarrier(TextureHandle h, ResourceState newState)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::AddBarrierTexture>(DisplayListCmdType::ADD_BARRIER_TEXTURE))
+		{
+			cmd->h = h;
+			cmd->newState = newState;
+		}
+	}
+
+	void DisplayList::FlushBarriers()
+	{
+		PushCommand<DisplayListCmds::FlushBarriers>(DisplayListCmdType::FLUSH_BARRIERS);
+	}
+
+	void DisplayList::BindVertexBuffer(BufferHandle h, uint32 offset /* = 0 */, uint32 stride /* = 0 */)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindVertexBuffer>(DisplayListCmdType::BIND_VERTEX_BUFFER))
+		{
+			cmd->h = h;
+			cmd->offset = offset;
+			cmd->stride = stride;
+		}
+	}
+
+	void DisplayList::BindIndexBuffer(BufferHandle h, uint32 offset /* = 0 */, IndexBufFormat format /* = IndexBufFormat::R16_UINT */)
+	{
+		VAST_ASSERT(h.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindIndexBuffer>(DisplayListCmdType::BIND_INDEX_BUFFER))
+		{
+			cmd->h = h;
+			cmd->offset = offset;
+			cmd->format = format;
+		}
+	}
+
+	void DisplayList::BindConstantBuffer(ShaderResourceProxy proxy, BufferHandle h, uint32 offset /* = 0 */)
+	{
+		VAST_ASSERT(h.IsValid() && proxy.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindConstantBuffer>(DisplayListCmdType::BIND_CONSTANT_BUFFER))
+		{
+			cmd->proxy = proxy;
+			cmd->h = h;
+			cmd->offset = offset;
+		}
+	}
+
+	void DisplayList::BindDynamicConstantBuffer(ShaderResourceProxy proxy, const void* data, const uint32 size)
+	{
+		VAST_ASSERT(data && size && proxy.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindDynamicConstantBuffer>(DisplayListCmdType::BIND_DYNAMIC_CONSTANT_BUFFER, size))
+		{
+			cmd->proxy = proxy;
+			cmd->dataSize = size;
+			memcpy(const_cast<uint8*>(cmd->GetData()), data, size);
+		}
+	}
+
+	void DisplayList::SetPushConstants(const void* data, const uint32 size)
+	{
+		VAST_ASSERT(data && size);
+		if (auto cmd = PushCommand<DisplayListCmds::SetPushConstants>(DisplayListCmdType::SET_PUSH_CONSTANTS, size))
+		{
+			cmd->dataSize = size;
+			memcpy(const_cast<uint8*>(cmd->GetData()), data, size);
+		}
+	}
+
+	void DisplayList::BindSRV(ShaderResourceProxy proxy, BufferHandle h)
+	{
+		VAST_ASSERT(h.IsValid() && proxy.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindSRVBuffer>(DisplayListCmdType::BIND_SRV_BUFFER))
+		{
+			cmd->proxy = proxy;
+			cmd->h = h;
+		}
+	}
+
+	void DisplayList::BindSRV(ShaderResourceProxy proxy, TextureHandle h)
+	{
+		VAST_ASSERT(h.IsValid() && proxy.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindSRVTexture>(DisplayListCmdType::BIND_SRV_TEXTURE))
+		{
+			cmd->proxy = proxy;
+			cmd->h = h;
+		}
+	}
+
+	void DisplayList::BindUAV(ShaderResourceProxy proxy, TextureHandle h, uint32 mipLevel /* = 0 */)
+	{
+		VAST_ASSERT(h.IsValid() && proxy.IsValid());
+		if (auto cmd = PushCommand<DisplayListCmds::BindUAVTexture>(DisplayListCmdType::BIND_UAV_TEXTURE))
+		{
+			cmd->proxy = proxy;
+			cmd->h = h;
+			cmd->mipLevel = mipLevel;
+		}
+	}
+
+	void DisplayList::SetScissorRect(int4 rect)
+	{
+		if (auto cmd = PushCommand<DisplayListCmds::SetScissorRect>(DisplayListCmdType::SET_SCISSOR_RECT))
+		{
+			for (uint32 i = 0; i < 4; ++i)
+			{
+				cmd->rect[i] = rect[i];
+			}
+		}
+	}
+
+	void DisplayList::SetBlendFactor(float4 blend)
+	{
+		if (auto cmd = PushCommand<DisplayListCmds::SetBlendFactor>(DisplayListCmdType::SET_BLEND_FACTOR))
+		{
+			for (uint32 i = 0; i < 4; ++i)
+			{
+				cmd->blend[i] = blend[i];
+			}
+		}
+	}
+
+	void DisplayList::Draw(uint32 vtxCount, uint32 vtxStartLocation /* = 0 */)
+	{
+		DrawInstanced(vtxCount, 1, vtxStartLocation, 0);
+	}
+
+	void DisplayList::DrawIndexed(uint32 idxCount, uint32 startIdxLocation /* = 0 */, uint32 baseVtxLocation /* = 0 */)
+	{
+		DrawIndexedInstanced(idxCount, 1, startIdxLocation, baseVtxLocation, 0);
+	}
+
+	void DisplayList::DrawInstanced(uint32 vtxCountPerInst, uint32 instCount, uint32 vtxStartLocation /* = 0 */, uint32 instStartLocation /* = 0 */)
+	{
+		if (auto cmd = PushCommand<DisplayListCmds::DrawInstanced>(DisplayListCmdType::DRAW_INSTANCED))
+		{
+			cmd->vtxCountPerInst = vtxCountPerInst;
+			cmd->instCount = instCount;
+			cmd->vtxStartLocation = vtxStartLocation;
+			cmd->instStartLocation = instStartLocation;
+		}
+	}
+
+	void DisplayList::DrawIndexedInstanced(uint32 idxCountPerInst, uint32 instCount, uint32 startIdxLocation, uint32 baseVtxLocation, uint32 startInstLocation)
+	{
+		if (auto cmd = PushCommand<DisplayListCmds::DrawIndexedInstanced>(DisplayListCmdType::DRAW_INDEXED_INSTANCED))
+		{
+			cmd->idxCountPerInst = idxCountPerInst;
+			cmd->instCount = instCount;
+			cmd->startIdxLocation = startIdxLocation;
+			cmd->baseVtxLocation = baseVtxLocation;
+			cmd->startInstLocation = startInstLocation;
+		}
+	}
+
+	void DisplayList::DrawFullscreenTriangle()
+	{
+		PushCommand<DisplayListCmds::DrawFullscreenTriangle>(DisplayListCmdType::DRAW_FULLSCREEN_TRIANGLE);
+	}
+
+	void DisplayList::Dispatch(uint3 threadGroupCount)
+	{
+		if (auto cmd = PushCommand<DisplayListCmds::Dispatch>(DisplayListCmdType::DISPATCH))
+		{
+			for (uint32 i = 0; i < 3; ++i)
+			{
+				cmd->threadGroupCount[i] = threadGroupCount[i];
+			}
+		}
+	}
+
+}
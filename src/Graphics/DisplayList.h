@@ -0,0 +1,208 @@
+#pragma once
+
+#include "Graphics/Resources.h"
+#include "Graphics/ShaderResourceProxy.h"
+
+#include <type_traits>
+
+// ======================================== DISPLAY LIST ==========================================
+//
+// A DisplayList is a compact CPU-side stream of commands that mirrors the GraphicsContext API.
+// Instead of being recorded directly into a GPU command list, commands are packed back to back into
+// a fixed size memory block that is allocated once on construction, so recording never allocates.
+//
+// A recorded list can be played back into a GraphicsContext any number of times (see
+// GraphicsContext::ExecuteDisplayList), which makes it possible to record static content once and
+// replay it every frame. Since commands only store handles and plain values, a list stays valid for
+// as long as the resources it references are alive. Note that memory obtained from per-frame
+// allocators (e.g. AllocTempBufferView) is only valid for the frame it was allocated on, and thus
+// should not be referenced by lists replayed across frames.
+//
+// Iterating a list does not depend on the graphics backend, so recording and traversal can be run
+// and measured without a device (see the DisplayList benchmarks in the tests project).
+//
+// ================================================================================================
+
+namespace vast
+{
+	enum class DisplayListCmdType : uint16
+	{
+		BEGIN_RENDER_PASS,
+		BEGIN_RENDER_PASS_TO_BACK_BUFFER,
+		END_RENDER_PASS,
+		BIND_PIPELINE,
+		BIND_PIPELINE_FOR_COMPUTE,
+		ADD_BARRIER_BUFFER,
+		ADD_BARRIER_TEXTURE,
+		FLUSH_BARRIERS,
+		BIND_VERTEX_BUFFER,
+		BIND_INDEX_BUFFER,
+		BIND_CONSTANT_BUFFER,
+		BIND_DYNAMIC_CONSTANT_BUFFER,
+		SET_PUSH_CONSTANTS,
+		BIND_SRV_BUFFER,
+		BIND_SRV_TEXTURE,
+		BIND_UAV_TEXTURE,
+		SET_SCISSOR_RECT,
+		SET_BLEND_FACTOR,
+		DRAW_INSTANCED,
+		DRAW_INDEXED_INSTANCED,
+		DRAW_FULLSCREEN_TRIANGLE,
+		DISPATCH,
+		COUNT,
+	};
+
+	// Every command starts with a header. Commands are padded so that the next header is always
+	// aligned to DISPLAY_LIST_CMD_ALIGNMENT.
+	static constexpr uint32 DISPLAY_LIST_CMD_ALIGNMENT = 8;
+
+	struct DisplayListCmd
+	{
+		DisplayListCmdType type;
+		uint16 size;
+	};
+
+	namespace DisplayListCmds
+	{
+		struct BeginRenderPass : DisplayListCmd { PipelineHandle h; RenderPassDesc desc; };
+		struct BeginRenderPassToBackBuffer : DisplayListCmd { PipelineHandle h; LoadOp loadOp; StoreOp storeOp; };
+		struct EndRenderPass : DisplayListCmd {};
+		struct BindPipeline : DisplayListCmd { PipelineHandle h; };
+		struct BindPipelineForCompute : DisplayListCmd { PipelineHandle h; };
+		struct AddBarrierBuffer : DisplayListCmd { BufferHandle h; ResourceState newState; };
+		struct AddBarrierTexture : DisplayListCmd { TextureHandle h; ResourceState newState; };
+		struct FlushBarriers : DisplayListCmd {};
+		struct BindVertexBuffer : DisplayListCmd { BufferHandle h; uint32 offset; uint32 stride; };
+		struct BindIndexBuffer : DisplayListCmd { BufferHandle h; uint32 offset; IndexBufFormat format; };
+		struct BindConstantBuffer : DisplayListCmd { ShaderResourceProxy proxy; BufferHandle h; uint32 offset; };
+		// Note: Constant data is stored inline right after the command.
+		struct BindDynamicConstantBuffer : DisplayListCmd { ShaderResourceProxy proxy; uint32 dataSize; const uint8* GetData() const { return reinterpret_cast<const uint8*>(this + 1); } };
+		// Note: Push constant data is stored inline right after the command.
+		struct SetPushConstants : DisplayListCmd { uint32 dataSize; const uint8* GetData() const { return reinterpret_cast<const uint8*>(this + 1); } };
+		struct BindSRVBuffer : DisplayListCmd { ShaderResourceProxy proxy; BufferHandle h; };
+		struct BindSRVTexture : DisplayListCmd { ShaderResourceProxy proxy; TextureHandle h; };
+		struct BindUAVTexture : DisplayListCmd { ShaderResourceProxy proxy; TextureHandle h; uint32 mipLevel; };
+		// Note: Vector types are stored as plain arrays since hlslpp types are SIMD aligned.
+		struct SetScissorRect : DisplayListCmd { int32 rect[4]; };
+		struct SetBlendFactor : DisplayListCmd { float blend[4]; };
+		struct DrawInstanced : DisplayListCmd { uint32 vtxCountPerInst; uint32 instCount; uint32 vtxStartLocation; uint32 instStartLocation; };
+		struct DrawIndexedInstanced : DisplayListCmd { uint32 idxCountPerInst; uint32 instCount; uint32 startIdxLocation; uint32 baseVtxLocation; uint32 startInstLocation; };
+		struct DrawFullscreenTriangle : DisplayListCmd {};
+		struct Dispatch : DisplayListCmd { uint32 threadGroupCount[3]; };
+	}
+
+	class DisplayList
+	{
+	public:
+		static constexpr uint32 kDefaultCapacity = 64 * 1024;
+
+		DisplayList(uint32 capacityInBytes = kDefaultCapacity);
+
+		// Discards all recorded commands, keeping the memory block for re-recording.
+		void Reset();
+
+		// - Recording ------------------------------------------------------------------------- //
+
+		void BeginRenderPass(PipelineHandle h, const RenderPassDesc& desc);
+		void BeginRenderPassToBackBuffer(PipelineHandle h, LoadOp loadOp = LoadOp::LOAD, StoreOp storeOp = StoreOp::STORE);
+		void EndRenderPass();
+
+		void BindPipeline(PipelineHandle h);
+		void BindPipelineForCompute(PipelineHandle h);
+
+		void AddBarrier(BufferHandle h, ResourceState newState);
+		void AddBarrier(TextureHandle h, ResourceState newState);
+		void FlushBarriers();
+
+		void BindVertexBuffer(BufferHandle h, uint32 offset = 0, uint32 stride = 0);
+		void BindIndexBuffer(BufferHandle h, uint32 offset = 0, IndexBufFormat format = IndexBufFormat::R16_UINT);
+		void BindConstantBuffer(ShaderResourceProxy proxy, BufferHandle h, uint32 offset = 0);
+		// Constant data is copied into the list, and into per-frame memory every time the list is
+		// played back, so lists using it can be replayed across frames.
+		void BindDynamicConstantBuffer(ShaderResourceProxy proxy, const void* data, const uint32 size);
+		template<typename T>
+		void BindDynamicConstantBuffer(ShaderResourceProxy proxy, const T& data)
+		{
+			BindDynamicConstantBuffer(proxy, &data, static_cast<uint32>(sizeof(T)));
+		}
+		// Push constant data is copied into the list.
+		void SetPushConstants(const void* data, const uint32 size);
+
+		void BindSRV(ShaderResourceProxy proxy, BufferHandle h);
+		void BindSRV(ShaderResourceProxy proxy, TextureHandle h);
+		void BindUAV(ShaderResourceProxy proxy, TextureHandle h, uint32 mipLevel = 0);
+
+		void SetScissorRect(int4 rect);
+		void SetBlendFactor(float4 blend);
+
+		void Draw(uint32 vtxCount, uint32 vtxStartLocation = 0);
+		void DrawIndexed(uint32 idxCount, uint32 startIdxLocation = 0, uint32 baseVtxLocation = 0);
+		void DrawInstanced(uint32 vtxCountPerInst, uint32 instCount, uint32 vtxStartLocation = 0, uint32 instStartLocation = 0);
+		void DrawIndexedInstanced(uint32 idxCountPerInstance, uint32 instanceCount, uint32 startIdxLocation, uint32 baseVtxLocation, uint32 startInstLocation);
+		void DrawFullscreenTriangle();
+
+		void Dispatch(uint3 threadGroupCount);
+
+		// - Playback -------------------------------------------------------------------------- //
+
+		// Calls 'f' with every recorded command header in recording order. The header can be cast to
+		// the matching DisplayListCmds type based on its 'type'.
+		template<typename F>
+		void ForEachCommand(F&& f) const
+		{
+			ForEachCommand(0, m_UsedBytes, std::forward<F>(f));
+		}
+
+		// Same as above, limited to the commands recorded in the [beginOffset, endOffset) byte range
+		// (see GetUsedBytes).
+		template<typename F>
+		void ForEachCommand(uint32 beginOffset, uint32 endOffset, F&& f) const
+		{
+			VAST_ASSERT(beginOffset <= endOffset && endOffset <= m_UsedBytes);
+			for (uint32 offset = beginOffset; offset < endOffset; )
+			{
+				const DisplayListCmd* cmd = reinterpret_cast<const DisplayListCmd*>(m_Memory.get() + offset);
+				VAST_ASSERT(cmd->size > 0);
+				f(*cmd);
+				offset += cmd->size;
+			}
+		}
+
+		uint32 GetNumCommands() const { return m_NumCommands; }
+		uint32 GetUsedBytes() const { return m_UsedBytes; }
+		uint32 GetCapacity() const { return m_Capacity; }
+		bool IsEmpty() const { return m_NumCommands == 0; }
+		// Set when a command didn't fit in the list and was dropped.
+		bool HasOverflowed() const { return m_bHasOverflowed; }
+
+	private:
+		template<typename T>
+		T* PushCommand(DisplayListCmdType type, uint32 extraBytes = 0)
+		{
+			static_assert(std::is_trivially_copyable_v<T> && std::is_base_of_v<DisplayListCmd, T>);
+			static_assert(alignof(T) <= DISPLAY_LIST_CMD_ALIGNMENT);
+
+			const uint32 size = AlignU32(static_cast<uint32>(sizeof(T)) + extraBytes, DISPLAY_LIST_CMD_ALIGNMENT);
+			if (m_UsedBytes + size > m_Capacity || size > UINT16_MAX)
+			{
+				VAST_ASSERTF(0, "Display list capacity exhausted.");
+				m_bHasOverflowed = true;
+				return nullptr;
+			}
+
+			T* cmd = new (m_Memory.get() + m_UsedBytes) T();
+			cmd->type = type;
+			cmd->size = static_cast<uint16>(size);
+			m_UsedBytes += size;
+			m_NumCommands++;
+			return cmd;
+		}
+
+		Ptr<uint8[]> m_Memory;
+		uint32 m_Capacity;
+		uint32 m_UsedBytes;
+		uint32 m_NumCommands;
+		bool m_bHasOverflowed;
+	};
+
+}
@@ -0,0 +1,138 @@
+#include "vastpch.h"
+#include "Graphics/DrawQueue.h"
+
+#include <algorithm>
+
+namespace vast
+{
+
+	uint64 MakeDrawSortKey(uint8 pass, PipelineHandle pipeline, uint32 material, float depth, bool bBackToFront /* = false */)
+	{
+		constexpr uint32 kMaxDepth = (1u << DRAW_SORT_KEY_DEPTH_BITS) - 1;
+		constexpr uint32 kMaxMaterial = (1u << DRAW_SORT_KEY_MATERIAL_BITS) - 1;
+		VAST_ASSERTF(material <= kMaxMaterial, "Material id does not fit in the draw sort key.");
+
+		uint32 quantizedDepth = static_cast<uint32>((std::min)((std::max)(depth, 0.0f), 1.0f) * float(kMaxDepth));
+		if (bBackToFront)
+		{
+			quantizedDepth = kMaxDepth - quantizedDepth;
+		}
+
+		return (uint64(pass) << DRAW_SORT_KEY_PASS_SHIFT)
+			| (uint64(pipeline.GetIndex()) << DRAW_SORT_KEY_PIPELINE_SHIFT)
+			| (uint64(material & kMaxMaterial) << DRAW_SORT_KEY_MATERIAL_SHIFT)
+			| (uint64(quantizedDepth) << DRAW_SORT_KEY_DEPTH_SHIFT);
+	}
+
+	uint8 GetDrawSortKeyPass(uint64 key)
+	{
+		return static_cast<uint8>(key >> DRAW_SORT_KEY_PASS_SHIFT);
+	}
+
+	//
+
+	DrawQueue::DrawQueue(uint32 cmdCapacityInBytes /* = DisplayList::kDefaultCapacity */)
+		: m_Commands(cmdCapacityInBytes)
+		, m_Items()
+		, m_SortScratch()
+		, m_bIsRecordingDraw(false)
+		, m_bIsSorted(true)
+	{
+	}
+
+	void DrawQueue::Reset()
+	{
+		VAST_ASSERTF(!m_bIsRecordingDraw, "Cannot reset a draw queue in the middle of a draw.");
+		m_Commands.Reset();
+		m_Items.clear();
+		m_bIsSorted = true;
+	}
+
+	DisplayList& DrawQueue::BeginDraw(uint64 sortKey)
+	{
+		VAST_ASSERTF(!m_bIsRecordingDraw, "A draw is already being recorded.");
+		m_bIsRecordingDraw = true;
+		m_bIsSorted = false;
+
+		DrawQueueItem& item = m_Items.emplace_back();
+		item.key = sortKey;
+		item.cmdBegin = m_Commands.GetUsedBytes();
+		return m_Commands;
+	}
+
+	void DrawQueue::EndDraw()
+	{
+		VAST_ASSERTF(m_bIsRecordingDraw, "No draw is currently being recorded.");
+		m_bIsRecordingDraw = false;
+
+		m_Items.back().cmdEnd = m_Commands.GetUsedBytes();
+	}
+
+	void DrawQueue::Sort()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!m_bIsRecordingDraw, "Cannot sort a draw queue in the middle of a draw.");
+
+		if (m_bIsSorted)
+			return;
+
+		// LSD radix sort over the 8 bytes of the key. All histograms are built in a single pass over
+		// the items, and digits shared by all keys (common for the pass and pipeline bytes) are skipped.
+		constexpr uint32 kNumDigits = sizeof(uint64);
+		constexpr uint32 kNumBuckets = 256;
+
+		const size_t n = m_Items.size();
+		m_SortScratch.resize(n);
+
+		Array<Array<uint32, kNumBuckets>, kNumDigits> histograms = {};
+		for (const auto& item : m_Items)
+		{
+			for (uint32 d = 0; d < kNumDigits; ++d)
+			{
+				histograms[d][(item.key >> (d * 8)) & 0xFF]++;
+			}
+		}
+
+		DrawQueueItem* src = m_Items.data();
+		DrawQueueItem* dst = m_SortScratch.data();
+
+		for (uint32 d = 0; d < kNumDigits; ++d)
+		{
+			const uint32 shift = d * 8;
+			auto& histogram = histograms[d];
+
+			if (histogram[(src[0].key >> shift) & 0xFF] == n)
+				continue;
+
+			uint32 offset = 0;
+			for (uint32 b = 0; b < kNumBuckets; ++b)
+			{
+				const uint32 count = histogram[b];
+				histogram[b] = offset;
+				offset += count;
+			}
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+
+			std::swap(src, dst);
+		}
+
+		if (src != m_Items.data())
+		{
+			m_Items.swap(m_SortScratch);
+		}
+
+		m_bIsSorted = true;
+	}
+
+	uint32 DrawQueue::FindFirstDrawOfPass(uint8 pass) const
+	{
+		auto it = std::lower_bound(m_Items.begin(), m_Items.end(), pass, 
+			[](const DrawQueueItem& item, uint8 p) { return GetDrawSortKeyPass(item.key) < p; });
+		return static_cast<uint32>(it - m_Items.begin());
+	}
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Graphics/DisplayList.h"
+
+// ========================================= DRAW QUEUE ===========================================
+//
+// A DrawQueue collects draws tagged with a 64-bit sort key, and sorts them before playback so that
+// draws sharing the same state end up next to each other. Keys are packed so that sorting them in
+// ascending order groups draws by pass first, then by pipeline and material, and finally by depth:
+//
+//	 63        56 55           44 43                    24 23                     0
+//	| pass (8b)  | pipeline (12b) |    material (20b)     |       depth (24b)       |
+//
+// Depth is sorted front-to-back by default to maximize early depth rejection, and can be flipped to
+// back-to-front for passes that need it (e.g. transparency).
+//
+// The commands of each draw are recorded into a DisplayList owned by the queue, between calls to
+// BeginDraw and EndDraw. Sorting only reorders the (key, command range) pairs, using a radix sort
+// which runs in linear time regardless of the key distribution.
+//
+// Pipelines are only switched by the commands of a draw, so draws that don't use the pipeline their
+// render pass was begun with must start by recording DisplayList::BindPipeline with the same
+// pipeline used for their key. Since sorting groups these draws by pipeline, playback skips the
+// binds that are redundant and each pipeline is bound once per pass.
+//
+// Like DisplayLists, queues are device-agnostic, so sorting can be run and measured without a GPU
+// (see the DrawQueue benchmarks in the tests project).
+// See GraphicsContext::ExecuteDrawQueue for playback.
+//
+// ================================================================================================
+
+namespace vast
+{
+	static constexpr uint32 DRAW_SORT_KEY_DEPTH_BITS = 24;
+	static constexpr uint32 DRAW_SORT_KEY_MATERIAL_BITS = 20;
+	static constexpr uint32 DRAW_SORT_KEY_PIPELINE_BITS = 12;
+	static constexpr uint32 DRAW_SORT_KEY_PASS_BITS = 8;
+
+	static constexpr uint32 DRAW_SORT_KEY_DEPTH_SHIFT = 0;
+	static constexpr uint32 DRAW_SORT_KEY_MATERIAL_SHIFT = DRAW_SORT_KEY_DEPTH_SHIFT + DRAW_SORT_KEY_DEPTH_BITS;
+	static constexpr uint32 DRAW_SORT_KEY_PIPELINE_SHIFT = DRAW_SORT_KEY_MATERIAL_SHIFT + DRAW_SORT_KEY_MATERIAL_BITS;
+	static constexpr uint32 DRAW_SORT_KEY_PASS_SHIFT = DRAW_SORT_KEY_PIPELINE_SHIFT + DRAW_SORT_KEY_PIPELINE_BITS;
+	static_assert(DRAW_SORT_KEY_PASS_SHIFT + DRAW_SORT_KEY_PASS_BITS == 64);
+	static_assert(NUM_PIPELINES <= (1 << DRAW_SORT_KEY_PIPELINE_BITS));
+
+	// 'material' is any user defined id for the resources bound by the draw, and 'depth' is expected
+	// to be normalized to the [0, 1] range.
+	uint64 MakeDrawSortKey(uint8 pass, PipelineHandle pipeline, uint32 material, float depth, bool bBackToFront = false);
+	uint8 GetDrawSortKeyPass(uint64 key);
+
+	struct DrawQueueItem
+	{
+		uint64 key = 0;
+		// Byte range of the draw commands in the queue's display list.
+		uint32 cmdBegin = 0;
+		uint32 cmdEnd = 0;
+	};
+
+	class DrawQueue
+	{
+	public:
+		DrawQueue(uint32 cmdCapacityInBytes = DisplayList::kDefaultCapacity);
+
+		// Discards all draws, keeping allocated memory around.
+		void Reset();
+
+		// Commands recorded into the returned list until EndDraw belong to a draw with the given key.
+		DisplayList& BeginDraw(uint64 sortKey);
+		void EndDraw();
+
+		void Sort();
+		bool IsSorted() const { return m_bIsSorted; }
+
+		// Calls 'f' with every draw item of the given pass, in sorted order.
+		template<typename F>
+		void ForEachDraw(uint8 pass, F&& f) const
+		{
+			VAST_ASSERTF(m_bIsSorted, "Draw queue must be sorted before playback.");
+			const uint32 begin = FindFirstDrawOfPass(pass);
+			for (uint32 i = begin; i < m_Items.size() && GetDrawSortKeyPass(m_Items[i].key) == pass; ++i)
+			{
+				f(m_Items[i]);
+			}
+		}
+
+		const DisplayList& GetDisplayList() const { return m_Commands; }
+		const Vector<DrawQueueItem>& GetItems() const { return m_Items; }
+		uint32 GetNumDraws() const { return static_cast<uint32>(m_Items.size()); }
+
+	private:
+		uint32 FindFirstDrawOfPass(uint8 pass) const;
+
+		DisplayList m_Commands;
+		Vector<DrawQueueItem> m_Items;
+		Vector<DrawQueueItem> m_SortScratch;
+		bool m_bIsRecordingDraw;
+		bool m_bIsSorted;
+	};
+
+}
@@ -21,7 +21,7 @@ namespace vast
 			.usage = ResourceUsage::READBACK
 		};
 
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_TimestampsReadbackBuf[i] = m_ResourceManager.CreateBuffer(readbackBufferDesc);
 			m_TimestampData[i] = reinterpret_cast<const uint64*>(m_ResourceManager.GetBufferData(m_TimestampsReadbackBuf[i]));
@@ -30,7 +30,7 @@ namespace vast
 
 	GPUProfiler::~GPUProfiler()
 	{
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_ResourceManager.DestroyBuffer(m_TimestampsReadbackBuf[i]);
 		}
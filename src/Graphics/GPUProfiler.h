@@ -28,8 +28,8 @@ namespace vast
 
 		uint32 m_TimestampCount;
 		double m_TimestampFrequency;
-		Array<BufferHandle, NUM_FRAMES_IN_FLIGHT> m_TimestampsReadbackBuf;
-		Array<const uint64*, NUM_FRAMES_IN_FLIGHT> m_TimestampData;
+		Array<BufferHandle, MAX_FRAMES_IN_FLIGHT> m_TimestampsReadbackBuf;
+		Array<const uint64*, MAX_FRAMES_IN_FLIGHT> m_TimestampData;
 	};
 
 
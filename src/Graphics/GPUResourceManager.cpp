@@ -11,17 +11,28 @@ static const wchar_t* ASSETS_TEXTURES_PATH = L"../../assets/textures/";
 
 namespace vast
 {
+	// Automatically reload shaders when their source files or includes change.
+	Arg g_ShaderHotReload("ShaderHotReload", false);
+	static constexpr uint32 SHADER_HOT_RELOAD_POLL_INTERVAL_FRAMES = 30;
 
 	GPUResourceManager::GPUResourceManager()
 		: m_BufferHandles()
 		, m_TextureHandles()
 		, m_PipelineHandles()
+		, m_MemoryHeapHandles()
 		, m_BuffersMarkedForDestruction({})
 		, m_TexturesMarkedForDestruction({})
 		, m_PipelinesMarkedForDestruction({})
+		, m_MemoryHeapsMarkedForDestruction({})
+		, m_PipelineCache()
+		, m_PipelineKeys({})
 		, m_PipelinesMarkedForShaderReload({})
-		, m_TempFrameAllocators({})
+		, m_LivePipelines({})
+		, m_bShaderHotReload(false)
+		, m_FramesSinceShaderHotReloadPoll(0)
+		, m_TempFrameAllocators()
 	{
+		g_ShaderHotReload.Get(m_bShaderHotReload);
 
 		// Create frame allocators
 		BufferDesc tempFrameBufferDesc =
@@ -31,7 +42,7 @@ namespace vast
 			.bBindless = true,
 		};
 
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			auto& frameAllocator = m_TempFrameAllocators[i];
 			VAST_ASSERT(!frameAllocator.buffer.IsValid());
@@ -46,12 +57,12 @@ namespace vast
 		gfx::WaitForIdle();
 
 		// Destroy frame allocators
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			DestroyBuffer(m_TempFrameAllocators[i].buffer);
 		}
 
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			ProcessDestructions(i);
 		}
@@ -61,13 +72,13 @@ namespace vast
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		if (!m_PipelinesMarkedForShaderReload.empty())
+		if (m_bShaderHotReload)
 		{
-			// Pipelines are not double buffered, so we need a hard wait to reload shaders in place.
-			gfx::WaitForIdle();
-			ProcessShaderReloads();
+			PollShaderHotReload();
 		}
 
+		ProcessShaderReloads();
+
 		uint32 frameId = gfx::GetFrameId();
 
 		// TODO: Figure out where the profiling for destructions should go (cpu/gpu?)
@@ -107,8 +118,20 @@ namespace vast
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		PipelineHandle h = m_PipelineHandles.AllocHandle();
+		const PipelineKey key = MakePipelineKey(desc);
+		PipelineHandle h = AcquireCachedPipeline(key);
+		if (h.IsValid())
+		{
+			if (gfx::GetHasFailed(h))
+			{
+				gfx::CreatePipeline(h, desc);
+			}
+			return h;
+		}
+
+		h = m_PipelineHandles.AllocHandle();
 		gfx::CreatePipeline(h, desc);
+		AddCachedPipeline(key, h);
 		return h;
 	}
 
@@ -116,11 +139,139 @@ namespace vast
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		PipelineHandle h = m_PipelineHandles.AllocHandle();
+		const PipelineKey key = MakePipelineKey(desc);
+		PipelineHandle h = AcquireCachedPipeline(key);
+		if (h.IsValid())
+		{
+			if (gfx::GetHasFailed(h))
+			{
+				gfx::CreatePipeline(h, desc);
+			}
+			return h;
+		}
+
+		h = m_PipelineHandles.AllocHandle();
 		gfx::CreatePipeline(h, desc);
+		AddCachedPipeline(key, h);
+		return h;
+	}
+
+	PipelineHandle GPUResourceManager::CreatePipelineAsync(const PipelineDesc& desc)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		const PipelineKey key = MakePipelineKey(desc);
+		PipelineHandle h = AcquireCachedPipeline(key, false);
+		if (h.IsValid())
+		{
+			if (gfx::GetHasFailed(h))
+			{
+				gfx::CreatePipelineAsync(h, desc);
+			}
+			return h;
+		}
+
+		h = m_PipelineHandles.AllocHandle();
+		gfx::CreatePipelineAsync(h, desc);
+		AddCachedPipeline(key, h);
 		return h;
 	}
 
+	PipelineHandle GPUResourceManager::CreatePipelineAsync(const ShaderDesc& desc)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		const PipelineKey key = MakePipelineKey(desc);
+		PipelineHandle h = AcquireCachedPipeline(key, false);
+		if (h.IsValid())
+		{
+			if (gfx::GetHasFailed(h))
+			{
+				gfx::CreatePipelineAsync(h, desc);
+			}
+			return h;
+		}
+
+		h = m_PipelineHandles.AllocHandle();
+		gfx::CreatePipelineAsync(h, desc);
+		AddCachedPipeline(key, h);
+		return h;
+	}
+
+	PipelineHandle GPUResourceManager::AcquireCachedPipeline(PipelineKey key, bool bMustBeReady /* = true */)
+	{
+		CachedPipeline* cached = m_PipelineCache.Find(key);
+		if (cached == nullptr)
+			return PipelineHandle();
+
+		// Note: An identical pipeline may still be being created in the background. If that fails, the
+		// caller retries creating it.
+		if (bMustBeReady && !gfx::GetIsReady(cached->h))
+		{
+			gfx::WaitForPipelineCreation(cached->h);
+		}
+
+		cached->refCount++;
+		return cached->h;
+	}
+
+	void GPUResourceManager::AddCachedPipeline(PipelineKey key, PipelineHandle h)
+	{
+		m_PipelineCache.Insert(key, CachedPipeline{ h, 1 });
+		m_PipelineKeys[h.GetIndex()] = key;
+		m_LivePipelines.push_back(h);
+	}
+
+	void GPUResourceManager::PrecompileShaders(const Vector<ShaderDesc>& descs)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		gfx::PrecompileShaders(descs);
+	}
+
+	MemoryHeapHandle GPUResourceManager::CreateMemoryHeap(uint64 size, MemoryHeapType type /* = MemoryHeapType::MIXED */)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		MemoryHeapHandle h = m_MemoryHeapHandles.AllocHandle();
+		gfx::CreateMemoryHeap(h, size, type);
+		return h;
+	}
+
+	bool GPUResourceManager::SupportsMixedMemoryHeaps()
+	{
+		return gfx::SupportsMixedMemoryHeaps();
+	}
+
+	BufferHandle GPUResourceManager::CreatePlacedBuffer(const BufferDesc& desc, MemoryHeapHandle heap, uint64 heapOffset, const std::string& name /* = "Unnamed Placed Buffer" */)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERT(heap.IsValid());
+
+		BufferHandle h = m_BufferHandles.AllocHandle();
+		gfx::CreatePlacedBuffer(h, desc, heap, heapOffset, name);
+		return h;
+	}
+
+	TextureHandle GPUResourceManager::CreatePlacedTexture(const TextureDesc& desc, MemoryHeapHandle heap, uint64 heapOffset, const std::string& name /* = "Unnamed Placed Texture" */)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERT(heap.IsValid());
+
+		TextureHandle h = m_TextureHandles.AllocHandle();
+		gfx::CreatePlacedTexture(h, desc, heap, heapOffset, name);
+		return h;
+	}
+
+	ResourceAllocationInfo GPUResourceManager::GetAllocationInfo(const BufferDesc& desc)
+	{
+		return gfx::GetAllocationInfo(desc);
+	}
+
+	ResourceAllocationInfo GPUResourceManager::GetAllocationInfo(const TextureDesc& desc)
+	{
+		return gfx::GetAllocationInfo(desc);
+	}
+
 	// TODO: Move these to Filesystem
 	static bool FileExists(const std::wstring& filePath)
 	{
@@ -247,9 +398,24 @@ namespace vast
 	void GPUResourceManager::DestroyPipeline(PipelineHandle h)
 	{
 		VAST_ASSERT(h.IsValid());
+		const PipelineKey key = m_PipelineKeys[h.GetIndex()];
+		CachedPipeline* cached = m_PipelineCache.Find(key);
+		VAST_ASSERTF(cached && cached->h == h && cached->refCount > 0, "Attempted to destroy a pipeline that has already been destroyed.");
+		if (--cached->refCount > 0)
+			return;
+
+		// Note: Identical pipelines created from now on get a new pipeline, even if this one is still
+		// waiting to be destroyed.
+		m_PipelineCache.Remove(key);
 		m_PipelinesMarkedForDestruction[gfx::GetFrameId()].push_back(h);
 	}
 
+	void GPUResourceManager::DestroyMemoryHeap(MemoryHeapHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		m_MemoryHeapsMarkedForDestruction[gfx::GetFrameId()].push_back(h);
+	}
+
 	void GPUResourceManager::ProcessDestructions(uint32 frameId)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
@@ -275,31 +441,80 @@ namespace vast
 			VAST_ASSERT(h.IsValid());
 			gfx::DestroyPipeline(h);
 			m_PipelineHandles.FreeHandle(h);
+			std::erase(m_LivePipelines, h);
 		}
 		m_PipelinesMarkedForDestruction[frameId].clear();
+
+		// Note: Heaps go last, since placed resources must be released before their heap.
+		for (auto& h : m_MemoryHeapsMarkedForDestruction[frameId])
+		{
+			VAST_ASSERT(h.IsValid());
+			gfx::DestroyMemoryHeap(h);
+			m_MemoryHeapHandles.FreeHandle(h);
+		}
+		m_MemoryHeapsMarkedForDestruction[frameId].clear();
 	}
 
-	ShaderResourceProxy GPUResourceManager::LookupShaderResource(PipelineHandle h, const std::string& shaderResourceName)
+	ShaderResourceProxy GPUResourceManager::LookupShaderResource(PipelineHandle h, ShaderResourceName shaderResourceName)
 	{
-		return gfx::LookupShaderResource(h, shaderResourceName);
+		return gfx::LookupShaderResource(h, shaderResourceName.key);
 	}
 
 	void GPUResourceManager::ReloadShaders(PipelineHandle h)
 	{
 		VAST_ASSERT(h.IsValid());
-		m_PipelinesMarkedForShaderReload.push_back(h);
+		auto& reloads = m_PipelinesMarkedForShaderReload;
+		if (std::find(reloads.begin(), reloads.end(), h) == reloads.end())
+		{
+			reloads.push_back(h);
+		}
 	}
 
 	void GPUResourceManager::ProcessShaderReloads()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 
-		for (auto& h : m_PipelinesMarkedForShaderReload)
+		// Note: Reloads requested while another one is in progress wait for it to finish.
+		if (m_PipelinesMarkedForShaderReload.empty() || gfx::IsReloadingShaders())
+			return;
+
+		// Pipelines may have been destroyed since they were marked.
+		auto& reloads = m_PipelinesMarkedForShaderReload;
+		std::erase_if(reloads, [this](PipelineHandle h) { return std::find(m_LivePipelines.begin(), m_LivePipelines.end(), h) == m_LivePipelines.end(); });
+
+		// Note: Shaders can be shared by pipelines that weren't marked, which must be recreated too,
+		// since reloaded shaders are no longer considered out of date. Pipelines still being created
+		// in the background can't be, so reloads stay marked until all live pipelines are ready. Those
+		// that failed to be created have no shaders to reload.
+		for (const auto& h : m_LivePipelines)
 		{
-			VAST_ASSERT(h.IsValid());
-			gfx::ReloadShaders(h);
+			if (!gfx::GetIsReady(h) && !gfx::GetHasFailed(h))
+				return;
+		}
+
+		// Note: Shaders for all pipelines are compiled in parallel in a single batch, in the background.
+		if (!reloads.empty())
+		{
+			gfx::ReloadShaders(reloads, m_LivePipelines);
+		}
+		reloads.clear();
+	}
+
+	void GPUResourceManager::PollShaderHotReload()
+	{
+		if (++m_FramesSinceShaderHotReloadPoll < SHADER_HOT_RELOAD_POLL_INTERVAL_FRAMES)
+			return;
+		m_FramesSinceShaderHotReloadPoll = 0;
+
+		// Note: Only shaders affected by the change are recompiled, and only the pipelines using them
+		// are recreated, so requesting a reload for all pipelines is cheap.
+		if (gfx::PollShaderFileChanges())
+		{
+			for (const auto& h : m_LivePipelines)
+			{
+				ReloadShaders(h);
+			}
 		}
-		m_PipelinesMarkedForShaderReload.clear();
 	}
 
 	bool GPUResourceManager::GetIsReady(BufferHandle h)
@@ -308,6 +523,18 @@ namespace vast
 		return gfx::GetIsReady(h);
 	}
 
+	bool GPUResourceManager::GetIsReady(PipelineHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		return gfx::GetIsReady(h);
+	}
+
+	bool GPUResourceManager::GetHasFailed(PipelineHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		return gfx::GetHasFailed(h);
+	}
+
 	bool GPUResourceManager::GetIsReady(TextureHandle h)
 	{
 		VAST_ASSERT(h.IsValid());
@@ -366,14 +593,13 @@ namespace vast
 	uint32 TempAllocator::Alloc(uint32 size, uint32 alignment /* = 0 */)
 	{
 		VAST_ASSERT(size);
-		uint32 offset = usedMemory;
-		if (alignment > 0)
+		uint32 used = usedMemory.load(std::memory_order_relaxed);
+		uint32 offset;
+		do
 		{
-			offset = AlignU32(offset, alignment);
-		}
-		VAST_ASSERT(offset + size <= bufferSize);
-
-		usedMemory += size + alignment; // TODO: Is this just being conservative? Should be += offset delta from alignment + size
+			offset = (alignment > 0) ? AlignU32(used, alignment) : used;
+			VAST_ASSERTF(offset + size <= bufferSize, "Temp frame allocator memory exhausted.");
+		} while (!usedMemory.compare_exchange_weak(used, offset + size, std::memory_order_relaxed));
 		return offset;
 	}
 
@@ -2,6 +2,9 @@
 
 #include "Graphics/Resources.h"
 #include "Graphics/ShaderResourceProxy.h"
+#include "Core/FlatHashMap.h"
+
+#include <atomic>
 
 namespace vast
 {
@@ -9,8 +12,9 @@ namespace vast
 	{
 		BufferHandle buffer;
 		uint32 bufferSize = 0;
-		uint32 usedMemory = 0;
+		std::atomic<uint32> usedMemory = 0;
 
+		// Thread-safe, since memory can be allocated while recording from multiple threads.
 		uint32 Alloc(uint32 size, uint32 alignment = 0);
 		void Reset();
 	};
@@ -24,17 +28,48 @@ namespace vast
 
 		BufferHandle CreateBuffer(const BufferDesc& desc, const void* initialData = nullptr, const size_t dataSize = 0, const std::string& name = "Unnamed Buffer");
 		TextureHandle CreateTexture(const TextureDesc& desc, const void* initialData = nullptr, const std::string name = "Unnamed Texture");
+		// Pipelines are shared: creating a pipeline identical to an existing one (see MakePipelineKey)
+		// returns the same handle, and it is only destroyed once every creation has been matched by
+		// a DestroyPipeline call.
 		PipelineHandle CreatePipeline(const PipelineDesc& desc);
 		PipelineHandle CreatePipeline(const ShaderDesc& desc);
+		// Same as above, but returns right away while the pipeline is created in the background, so
+		// that new pipelines don't stall the frame. The pipeline can't be used, nor its resources looked
+		// up, until GetIsReady returns true for it, which happens at the start of a later frame. In the
+		// meantime, callers can skip the draws that use it, or use a fallback pipeline instead. If its
+		// shaders fail to compile, it never becomes ready and GetHasFailed returns true for it instead.
+		// Creating it again retries.
+		PipelineHandle CreatePipelineAsync(const PipelineDesc& desc);
+		PipelineHandle CreatePipelineAsync(const ShaderDesc& desc);
+		// Compiles the given shaders in parallel, so that creating the pipelines that use them later
+		// doesn't need to compile them one at a time.
+		void PrecompileShaders(const Vector<ShaderDesc>& descs);
+
+		// Memory heaps allow multiple placed resources to share (alias) the same memory, as long as
+		// they are not in use at the same time (e.g. transient render graph resources). MIXED heaps
+		// can only be created if SupportsMixedMemoryHeaps returns true.
+		MemoryHeapHandle CreateMemoryHeap(uint64 size, MemoryHeapType type = MemoryHeapType::MIXED);
+		bool SupportsMixedMemoryHeaps();
+		BufferHandle CreatePlacedBuffer(const BufferDesc& desc, MemoryHeapHandle heap, uint64 heapOffset, const std::string& name = "Unnamed Placed Buffer");
+		TextureHandle CreatePlacedTexture(const TextureDesc& desc, MemoryHeapHandle heap, uint64 heapOffset, const std::string& name = "Unnamed Placed Texture");
+		ResourceAllocationInfo GetAllocationInfo(const BufferDesc& desc);
+		ResourceAllocationInfo GetAllocationInfo(const TextureDesc& desc);
 
 		void DestroyBuffer(BufferHandle h);
 		void DestroyTexture(TextureHandle h);
 		void DestroyPipeline(PipelineHandle h);
+		// Note: Any resources placed in the heap must be destroyed no later than the heap itself.
+		void DestroyMemoryHeap(MemoryHeapHandle h);
 
 		void UpdateBuffer(BufferHandle h, void* data, const size_t size);
 
-		ShaderResourceProxy LookupShaderResource(PipelineHandle h, const std::string& shaderResourceName);
+		// Returns an invalid proxy if the pipeline doesn't use the resource.
+		ShaderResourceProxy LookupShaderResource(PipelineHandle h, ShaderResourceName shaderResourceName);
 
+		// Recompiles the shaders of the pipeline whose source files or includes changed since they were
+		// last compiled, and recreates the pipeline if needed, along with any other pipeline sharing
+		// the recompiled shaders. Shaders are compiled in the background, and pipelines keep using the
+		// old ones until the new ones are swapped in at the start of a later frame.
 		void ReloadShaders(PipelineHandle h);
 
 		// TODO: This should be separate from the Resource Manager (ContentLoader?)
@@ -49,6 +84,8 @@ namespace vast
 		// TODO: Review ready check for resources.
 		bool GetIsReady(BufferHandle h);
 		bool GetIsReady(TextureHandle h);
+		bool GetIsReady(PipelineHandle h);
+		bool GetHasFailed(PipelineHandle h);
 
 		TexFormat GetTextureFormat(TextureHandle h);
 
@@ -61,19 +98,38 @@ namespace vast
 		void BeginFrame();
 		void ProcessDestructions(uint32 frameId);
 		void ProcessShaderReloads();
+		void PollShaderHotReload();
+
+		// Waits for the cached pipeline to finish being created unless told otherwise.
+		PipelineHandle AcquireCachedPipeline(PipelineKey key, bool bMustBeReady = true);
+		void AddCachedPipeline(PipelineKey key, PipelineHandle h);
 
 	private:
 		HandlePool<Buffer, NUM_BUFFERS> m_BufferHandles;
 		HandlePool<Texture, NUM_TEXTURES> m_TextureHandles;
 		HandlePool<Pipeline, NUM_PIPELINES> m_PipelineHandles;
+		HandlePool<MemoryHeap, NUM_MEMORY_HEAPS> m_MemoryHeapHandles;
+
+		Array<Vector<BufferHandle>, MAX_FRAMES_IN_FLIGHT> m_BuffersMarkedForDestruction;
+		Array<Vector<TextureHandle>, MAX_FRAMES_IN_FLIGHT> m_TexturesMarkedForDestruction;
+		Array<Vector<PipelineHandle>, MAX_FRAMES_IN_FLIGHT> m_PipelinesMarkedForDestruction;
+		Array<Vector<MemoryHeapHandle>, MAX_FRAMES_IN_FLIGHT> m_MemoryHeapsMarkedForDestruction;
 
-		Array<Vector<BufferHandle>, NUM_FRAMES_IN_FLIGHT> m_BuffersMarkedForDestruction;
-		Array<Vector<TextureHandle>, NUM_FRAMES_IN_FLIGHT> m_TexturesMarkedForDestruction;
-		Array<Vector<PipelineHandle>, NUM_FRAMES_IN_FLIGHT> m_PipelinesMarkedForDestruction;
+		struct CachedPipeline
+		{
+			PipelineHandle h;
+			uint32 refCount = 0;
+		};
+		FlatHashMap<CachedPipeline> m_PipelineCache;
+		Array<PipelineKey, NUM_PIPELINES> m_PipelineKeys;
 
 		Vector<PipelineHandle> m_PipelinesMarkedForShaderReload;
+		// All pipelines that haven't been destroyed, for shader hot reload.
+		Vector<PipelineHandle> m_LivePipelines;
+		bool m_bShaderHotReload;
+		uint32 m_FramesSinceShaderHotReloadPoll;
 
-		Array<TempAllocator, NUM_FRAMES_IN_FLIGHT> m_TempFrameAllocators;
+		Array<TempAllocator, MAX_FRAMES_IN_FLIGHT> m_TempFrameAllocators;
 	};
 
 }
\ No newline at end of file
@@ -12,18 +12,38 @@ namespace vast::gfx
 	void BeginFrame();
 	void EndFrame();
 	uint32 GetFrameId();
+	// Must be called outside of a frame, once the GPU is idle.
+	void SetNumFramesInFlight(uint32 count);
+	uint32 GetNumFramesInFlight();
+	const StateCacheStats& GetLastFrameStateCacheStats();
+	const FenceWaitStats& GetLastFrameFenceWaitStats();
+	PipelineCacheStats GetPipelineCacheStats();
+
+	void BeginParallelCommandList(uint32 idx);
+	void EndParallelCommandList(uint32 idx);
+	void SubmitParallelCommandLists(uint32 count);
+
+	void BeginAsyncCompute();
+	QueueSyncPoint EndAsyncCompute();
+	QueueSyncPoint SignalQueue(QueueType type);
+	void WaitForSyncPoint(QueueType type, QueueSyncPoint syncPoint);
+	const QueueScheduler& GetQueueScheduler();
 
 	void BeginRenderPassToBackBuffer(PipelineHandle h, LoadOp loadOp = LoadOp::LOAD, StoreOp storeOp = StoreOp::STORE);
 	void BeginRenderPass(PipelineHandle h, RenderPassDesc desc);
 	void EndRenderPass();
+	void BindPipeline(PipelineHandle h);
 
 	void BindPipelineForCompute(PipelineHandle h);
 
-	void WaitForIdle();
+	void WaitForIdle(FenceWaitCause cause = FenceWaitCause::FLUSH);
 
 	void AddBarrier(BufferHandle h, ResourceState newState);
 	void AddBarrier(TextureHandle h, ResourceState newState);
+	void AddAliasingBarrier(BufferHandle h);
+	void AddAliasingBarrier(TextureHandle h);
 	void FlushBarriers();
+	void DiscardResource(TextureHandle h);
 
 	void BindVertexBuffer(BufferHandle h, uint32 offset = 0, uint32 stride = 0);
 	void BindIndexBuffer(BufferHandle h, uint32 offset = 0, IndexBufFormat format = IndexBufFormat::R16_UINT);
@@ -52,23 +72,46 @@ namespace vast::gfx
 
 	void CreateBuffer(BufferHandle h, const BufferDesc& desc, const std::string& name = "");
 	void CreateTexture(TextureHandle h, const TextureDesc& desc, const std::string& name = "");
+	void CreateMemoryHeap(MemoryHeapHandle h, uint64 size, MemoryHeapType type);
+	bool SupportsMixedMemoryHeaps();
+	void CreatePlacedBuffer(BufferHandle h, const BufferDesc& desc, MemoryHeapHandle heap, uint64 heapOffset, const std::string& name = "");
+	void CreatePlacedTexture(TextureHandle h, const TextureDesc& desc, MemoryHeapHandle heap, uint64 heapOffset, const std::string& name = "");
 	void CreatePipeline(PipelineHandle h, const PipelineDesc& desc);
 	void CreatePipeline(PipelineHandle h, const ShaderDesc& desc);
+	// Pipelines created asynchronously become ready at the start of a later frame.
+	void CreatePipelineAsync(PipelineHandle h, const PipelineDesc& desc);
+	void CreatePipelineAsync(PipelineHandle h, const ShaderDesc& desc);
+	// Blocks until the given pipeline, if being created asynchronously, is ready.
+	void WaitForPipelineCreation(PipelineHandle h);
+	void PrecompileShaders(const Vector<ShaderDesc>& descs);
 
 	void DestroyBuffer(BufferHandle h);
 	void DestroyTexture(TextureHandle h);
 	void DestroyPipeline(PipelineHandle h);
+	void DestroyMemoryHeap(MemoryHeapHandle h);
+
+	ResourceAllocationInfo GetAllocationInfo(const BufferDesc& desc);
+	ResourceAllocationInfo GetAllocationInfo(const TextureDesc& desc);
 
 	void UpdateBuffer(BufferHandle h, const void* srcMem, size_t srcSize);
 	void UpdateTexture(TextureHandle h, const void* srcMem);
 
-	void ReloadShaders(PipelineHandle h);
-	ShaderResourceProxy LookupShaderResource(PipelineHandle h, const std::string& shaderResourceName);
+	// Shaders are reloaded in the background, and swapped in at the start of a frame once ready.
+	// Only one reload can be in progress at a time. Every pipeline in 'livePipelines' that uses a
+	// reloaded shader is recreated, not only those in 'handles'.
+	void ReloadShaders(const Vector<PipelineHandle>& handles, const Vector<PipelineHandle>& livePipelines);
+	bool IsReloadingShaders();
+	// Returns true if any shader source file or include changed since the last call.
+	bool PollShaderFileChanges();
+	ShaderResourceProxy LookupShaderResource(PipelineHandle h, ShaderResourceKey key);
 
 	const uint8* GetBufferData(BufferHandle h);
 
 	bool GetIsReady(BufferHandle h);
 	bool GetIsReady(TextureHandle h);
+	bool GetIsReady(PipelineHandle h);
+	// Pipelines created asynchronously whose shaders fail to compile never become ready.
+	bool GetHasFailed(PipelineHandle h);
 
 	TexFormat GetTextureFormat(TextureHandle h);
 
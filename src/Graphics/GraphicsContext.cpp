@@ -3,19 +3,25 @@
 #include "Graphics/GraphicsBackend.h"
 #include "Graphics/GPUResourceManager.h"
 #include "Graphics/GPUProfiler.h"
+#include "Graphics/DisplayList.h"
+#include "Graphics/DrawQueue.h"
 
 #include "Core/EventTypes.h"
 
 namespace vast
 {
 
+	// Render passes are recorded into the command list bound to the calling thread, so their state
+	// is tracked per thread.
+	static thread_local bool s_bHasRenderPassBegun = false;
+
 	static void OnWindowResizeEvent(const WindowResizeEvent& event)
 	{
 		const uint2 scSize = gfx::GetBackBufferSize();
 
 		if (event.m_WindowSize.x != scSize.x || event.m_WindowSize.y != scSize.y)
 		{
-			gfx::WaitForIdle();
+			gfx::WaitForIdle(FenceWaitCause::RESIZE);
 			gfx::ResizeSwapChainAndBackBuffers(event.m_WindowSize);
 		}
 	}
@@ -24,7 +30,8 @@ namespace vast
 		: m_GPUResourceManager(nullptr)
 		, m_GpuProfiler(nullptr)
 		, m_bHasFrameBegun(false)
-		, m_bHasRenderPassBegun(false)
+		, m_LatencyMode(params.latencyMode)
+		, m_PendingLatencyMode(params.latencyMode)
 		, m_GpuFrameTimestampIdx(0)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
@@ -53,10 +60,21 @@ namespace vast
 		VAST_PROFILE_TRACE_FUNCTION;
 		VAST_ASSERTF(!m_bHasFrameBegun, "A frame is already running");
 
+		if (m_PendingLatencyMode != m_LatencyMode)
+		{
+			// Per-frame resources are indexed by frame id, so any work still referencing them must
+			// be done before the ring is resized.
+			FlushGPU();
+			gfx::SetNumFramesInFlight(vast::GetNumFramesInFlight(m_PendingLatencyMode));
+			m_LatencyMode = m_PendingLatencyMode;
+		}
+
 		m_bHasFrameBegun = true;
 
-		m_GPUResourceManager->BeginFrame();
+		// Note: The backend waits for the GPU to be done with this frame id, so resources queued for
+		// destruction on it can only be released after.
 		gfx::BeginFrame();
+		m_GPUResourceManager->BeginFrame();
 		m_GpuFrameTimestampIdx = m_GpuProfiler->BeginTimestamp();
 	}
 
@@ -64,6 +82,7 @@ namespace vast
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
 		VAST_ASSERTF(m_bHasFrameBegun, "No frame is currently running.");
+		VAST_ASSERTF(!m_bIsRecordingAsyncCompute, "Async compute recording was never ended.");
 
 		m_GpuProfiler->EndTimestamp(m_GpuFrameTimestampIdx);
 		m_GpuProfiler->CollectTimestamps();
@@ -84,14 +103,46 @@ namespace vast
 		return m_GpuProfiler->GetTimestampDuration(m_GpuFrameTimestampIdx);
 	}
 
+	const StateCacheStats& GraphicsContext::GetLastFrameStateCacheStats() const
+	{
+		return gfx::GetLastFrameStateCacheStats();
+	}
+
+	const FenceWaitStats& GraphicsContext::GetLastFrameFenceWaitStats() const
+	{
+		return gfx::GetLastFrameFenceWaitStats();
+	}
+
+	PipelineCacheStats GraphicsContext::GetPipelineCacheStats() const
+	{
+		return gfx::GetPipelineCacheStats();
+	}
+
+	void GraphicsContext::SetFrameLatencyMode(FrameLatencyMode mode)
+	{
+		VAST_ASSERT(mode != FrameLatencyMode::COUNT);
+		m_PendingLatencyMode = mode;
+	}
+
+	FrameLatencyMode GraphicsContext::GetFrameLatencyMode() const
+	{
+		return m_LatencyMode;
+	}
+
+	uint32 GraphicsContext::GetNumFramesInFlight() const
+	{
+		return gfx::GetNumFramesInFlight();
+	}
+
 	void GraphicsContext::BeginRenderPass(PipelineHandle h, const RenderPassDesc desc)
 	{
 		VAST_PROFILE_TRACE_BEGIN("Render Pass");
 		VAST_PROFILE_TRACE_FUNCTION;
-		VAST_ASSERTF(!m_bHasRenderPassBegun, "A render pass is already running.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "A render pass is already running.");
+		VAST_ASSERTF(!m_bIsRecordingAsyncCompute, "Render passes cannot be recorded on the compute queue.");
 		VAST_ASSERT(h.IsValid());
 
-		m_bHasRenderPassBegun = true;
+		s_bHasRenderPassBegun = true;
 		gfx::BeginRenderPass(h, desc);
 	}
 
@@ -99,33 +150,43 @@ namespace vast
 	{
 		VAST_PROFILE_TRACE_BEGIN("Render Pass");
 		VAST_PROFILE_TRACE_FUNCTION;
-		VAST_ASSERTF(!m_bHasRenderPassBegun, "A render pass is already running.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "A render pass is already running.");
+		VAST_ASSERTF(!m_bIsRecordingAsyncCompute, "Render passes cannot be recorded on the compute queue.");
 		VAST_ASSERT(h.IsValid());
 
-		m_bHasRenderPassBegun = true;
+		s_bHasRenderPassBegun = true;
 		gfx::BeginRenderPassToBackBuffer(h, loadOp, storeOp);
 	}
 
 	void GraphicsContext::EndRenderPass()
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
-		VAST_ASSERTF(m_bHasRenderPassBegun, "No render pass is currently running.");
+		VAST_ASSERTF(s_bHasRenderPassBegun, "No render pass is currently running.");
 
-		m_bHasRenderPassBegun = false;
+		s_bHasRenderPassBegun = false;
 		gfx::EndRenderPass();
 
 		VAST_PROFILE_TRACE_END("Render Pass");
 	}
 
+	void GraphicsContext::BindPipeline(PipelineHandle h)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(s_bHasRenderPassBegun, "Graphics pipelines can only be switched in the middle of a render pass.");
+		VAST_ASSERT(h.IsValid());
+
+		gfx::BindPipeline(h);
+	}
+
 	bool GraphicsContext::IsInRenderPass() const
 	{
-		return m_bHasRenderPassBegun;
+		return s_bHasRenderPassBegun;
 	}
 
 	void GraphicsContext::BindPipelineForCompute(PipelineHandle h)
 	{
 		VAST_PROFILE_TRACE_FUNCTION;
-		VAST_ASSERTF(!m_bHasRenderPassBegun, "Cannot bind another pipeline in the middle of a render pass.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "Cannot bind another pipeline in the middle of a render pass.");
 		VAST_ASSERT(h.IsValid());
 
 		gfx::BindPipelineForCompute(h);
@@ -144,7 +205,7 @@ namespace vast
 
 		gfx::WaitForIdle();
 		m_GPUResourceManager->ProcessShaderReloads();
-		for (uint32 i = 0; i < NUM_FRAMES_IN_FLIGHT; ++i)
+		for (uint32 i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
 		{
 			m_GPUResourceManager->ProcessDestructions(i);
 		}
@@ -164,11 +225,29 @@ namespace vast
 		gfx::AddBarrier(h, newState);
 	}
 
+	void GraphicsContext::AddAliasingBarrier(BufferHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		gfx::AddAliasingBarrier(h);
+	}
+
+	void GraphicsContext::AddAliasingBarrier(TextureHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		gfx::AddAliasingBarrier(h);
+	}
+
 	void GraphicsContext::FlushBarriers()
 	{
 		gfx::FlushBarriers();
 	}
 
+	void GraphicsContext::DiscardResource(TextureHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		gfx::DiscardResource(h);
+	}
+
 	//
 
 	void GraphicsContext::BindVertexBuffer(BufferHandle h, uint32 offset /* = 0 */, uint32 stride /* = 0 */)
@@ -189,6 +268,14 @@ namespace vast
 		gfx::BindConstantBuffer(proxy, h, offset);
 	}
 
+	void GraphicsContext::BindDynamicConstantBuffer(ShaderResourceProxy proxy, const void* data, const uint32 size)
+	{
+		VAST_ASSERT(data && size && proxy.IsValid());
+		BufferView cbv = m_GPUResourceManager->AllocTempBufferView(size, CONSTANT_BUFFER_ALIGNMENT);
+		memcpy(cbv.data, data, size);
+		gfx::BindConstantBuffer(proxy, cbv.buffer, cbv.offset);
+	}
+
 	void GraphicsContext::SetPushConstants(const void* data, const uint32 size)
 	{
 		VAST_ASSERT(data && size);
@@ -262,6 +349,249 @@ namespace vast
 
 	//
 
+	void GraphicsContext::ExecuteDisplayList(const DisplayList& dl)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bHasFrameBegun, "Display lists must be executed within a frame.");
+		VAST_ASSERTF(!dl.HasOverflowed(), "Executing a display list that dropped commands.");
+
+		dl.ForEachCommand([this](const DisplayListCmd& cmd) { ExecuteDisplayListCommand(cmd); });
+	}
+
+	void GraphicsContext::ExecuteDrawQueue(const DrawQueue& dq, uint8 pass)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bHasFrameBegun, "Draw queues must be executed within a frame.");
+		VAST_ASSERTF(!dq.GetDisplayList().HasOverflowed(), "Executing a draw queue that dropped commands.");
+
+		const DisplayList& dl = dq.GetDisplayList();
+		PipelineHandle boundPipeline;
+		dq.ForEachDraw(pass, [&](const DrawQueueItem& item)
+		{
+			dl.ForEachCommand(item.cmdBegin, item.cmdEnd, [&](const DisplayListCmd& cmd)
+			{
+				// Note: Draws sharing a pipeline are sorted next to each other, so most binds are
+				// redundant and can be skipped before reaching the backend.
+				if (cmd.type == DisplayListCmdType::BIND_PIPELINE)
+				{
+					const PipelineHandle h = static_cast<const DisplayListCmds::BindPipeline&>(cmd).h;
+					if (h == boundPipeline)
+						return;
+					boundPipeline = h;
+				}
+				ExecuteDisplayListCommand(cmd);
+			});
+		});
+	}
+
+	void GraphicsContext::ExecuteDisplayListCommand(const DisplayListCmd& cmd)
+	{
+		switch (cmd.type)
+		{
+		case DisplayListCmdType::BEGIN_RENDER_PASS:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BeginRenderPass&>(cmd);
+			BeginRenderPass(c.h, c.desc);
+			break;
+		}
+		case DisplayListCmdType::BEGIN_RENDER_PASS_TO_BACK_BUFFER:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BeginRenderPassToBackBuffer&>(cmd);
+			BeginRenderPassToBackBuffer(c.h, c.loadOp, c.storeOp);
+			break;
+		}
+		case DisplayListCmdType::END_RENDER_PASS:
+			EndRenderPass();
+			break;
+		case DisplayListCmdType::BIND_PIPELINE:
+			BindPipeline(static_cast<const DisplayListCmds::BindPipeline&>(cmd).h);
+			break;
+		case DisplayListCmdType::BIND_PIPELINE_FOR_COMPUTE:
+			BindPipelineForCompute(static_cast<const DisplayListCmds::BindPipelineForCompute&>(cmd).h);
+			break;
+		case DisplayListCmdType::ADD_BARRIER_BUFFER:
+		{
+			const auto& c = static_cast<const DisplayListCmds::AddBarrierBuffer&>(cmd);
+			AddBarrier(c.h, c.newState);
+			break;
+		}
+		case DisplayListCmdType::ADD_BARRIER_TEXTURE:
+		{
+			const auto& c = static_cast<const DisplayListCmds::AddBarrierTexture&>(cmd);
+			AddBarrier(c.h, c.newState);
+			break;
+		}
+		case DisplayListCmdType::FLUSH_BARRIERS:
+			FlushBarriers();
+			break;
+		case DisplayListCmdType::BIND_VERTEX_BUFFER:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BindVertexBuffer&>(cmd);
+			BindVertexBuffer(c.h, c.offset, c.stride);
+			break;
+		}
+		case DisplayListCmdType::BIND_INDEX_BUFFER:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BindIndexBuffer&>(cmd);
+			BindIndexBuffer(c.h, c.offset, c.format);
+			break;
+		}
+		case DisplayListCmdType::BIND_CONSTANT_BUFFER:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BindConstantBuffer&>(cmd);
+			BindConstantBuffer(c.proxy, c.h, c.offset);
+			break;
+		}
+		case DisplayListCmdType::BIND_DYNAMIC_CONSTANT_BUFFER:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BindDynamicConstantBuffer&>(cmd);
+			BindDynamicConstantBuffer(c.proxy, c.GetData(), c.dataSize);
+			break;
+		}
+		case DisplayListCmdType::SET_PUSH_CONSTANTS:
+		{
+			const auto& c = static_cast<const DisplayListCmds::SetPushConstants&>(cmd);
+			SetPushConstants(c.GetData(), c.dataSize);
+			break;
+		}
+		case DisplayListCmdType::BIND_SRV_BUFFER:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BindSRVBuffer&>(cmd);
+			BindSRV(c.proxy, c.h);
+			break;
+		}
+		case DisplayListCmdType::BIND_SRV_TEXTURE:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BindSRVTexture&>(cmd);
+			BindSRV(c.proxy, c.h);
+			break;
+		}
+		case DisplayListCmdType::BIND_UAV_TEXTURE:
+		{
+			const auto& c = static_cast<const DisplayListCmds::BindUAVTexture&>(cmd);
+			BindUAV(c.proxy, c.h, c.mipLevel);
+			break;
+		}
+		case DisplayListCmdType::SET_SCISSOR_RECT:
+		{
+			const auto& c = static_cast<const DisplayListCmds::SetScissorRect&>(cmd);
+			SetScissorRect(int4(c.rect[0], c.rect[1], c.rect[2], c.rect[3]));
+			break;
+		}
+		case DisplayListCmdType::SET_BLEND_FACTOR:
+		{
+			const auto& c = static_cast<const DisplayListCmds::SetBlendFactor&>(cmd);
+			SetBlendFactor(float4(c.blend[0], c.blend[1], c.blend[2], c.blend[3]));
+			break;
+		}
+		case DisplayListCmdType::DRAW_INSTANCED:
+		{
+			const auto& c = static_cast<const DisplayListCmds::DrawInstanced&>(cmd);
+			DrawInstanced(c.vtxCountPerInst, c.instCount, c.vtxStartLocation, c.instStartLocation);
+			break;
+		}
+		case DisplayListCmdType::DRAW_INDEXED_INSTANCED:
+		{
+			const auto& c = static_cast<const DisplayListCmds::DrawIndexedInstanced&>(cmd);
+			DrawIndexedInstanced(c.idxCountPerInst, c.instCount, c.startIdxLocation, c.baseVtxLocation, c.startInstLocation);
+			break;
+		}
+		case DisplayListCmdType::DRAW_FULLSCREEN_TRIANGLE:
+			DrawFullscreenTriangle();
+			break;
+		case DisplayListCmdType::DISPATCH:
+		{
+			const auto& c = static_cast<const DisplayListCmds::Dispatch&>(cmd);
+			Dispatch(uint3(c.threadGroupCount[0], c.threadGroupCount[1], c.threadGroupCount[2]));
+			break;
+		}
+		default:
+			VAST_ASSERTF(0, "Unknown display list command.");
+			break;
+		}
+	}
+
+	//
+
+	void GraphicsContext::BeginParallelRecording(uint32 idx)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bHasFrameBegun, "Command lists must be recorded within a frame.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "Cannot begin recording a command list in the middle of a render pass.");
+
+		gfx::BeginParallelCommandList(idx);
+	}
+
+	void GraphicsContext::EndParallelRecording(uint32 idx)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "Render passes must end within the command list they began in.");
+
+		gfx::EndParallelCommandList(idx);
+	}
+
+	void GraphicsContext::SubmitParallelRecordings(uint32 count)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bHasFrameBegun, "Command lists must be submitted within a frame.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "Cannot submit command lists in the middle of a render pass.");
+
+		if (count > 0)
+		{
+			gfx::SubmitParallelCommandLists(count);
+		}
+	}
+
+	//
+
+	void GraphicsContext::BeginAsyncCompute()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bHasFrameBegun, "Async compute must be recorded within a frame.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "Cannot begin async compute in the middle of a render pass.");
+		VAST_ASSERTF(!m_bIsRecordingAsyncCompute, "Async compute is already being recorded.");
+
+		m_bIsRecordingAsyncCompute = true;
+		gfx::BeginAsyncCompute();
+	}
+
+	QueueSyncPoint GraphicsContext::EndAsyncCompute()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bIsRecordingAsyncCompute, "Async compute is not being recorded.");
+
+		m_bIsRecordingAsyncCompute = false;
+		return gfx::EndAsyncCompute();
+	}
+
+	QueueSyncPoint GraphicsContext::SignalQueue(QueueType type)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bHasFrameBegun, "Queues must be signaled within a frame.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "Cannot signal a queue in the middle of a render pass.");
+		VAST_ASSERTF(!m_bIsRecordingAsyncCompute, "Cannot signal a queue while recording async compute.");
+
+		return gfx::SignalQueue(type);
+	}
+
+	void GraphicsContext::WaitForSyncPoint(QueueType type, QueueSyncPoint syncPoint)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(m_bHasFrameBegun, "Queue waits must be issued within a frame.");
+		VAST_ASSERTF(!s_bHasRenderPassBegun, "Cannot wait on a sync point in the middle of a render pass.");
+		VAST_ASSERTF(!m_bIsRecordingAsyncCompute, "Cannot wait on a sync point while recording async compute.");
+		VAST_ASSERT(syncPoint.IsValid());
+
+		gfx::WaitForSyncPoint(type, syncPoint);
+	}
+
+	const QueueScheduler& GraphicsContext::GetQueueScheduler() const
+	{
+		return gfx::GetQueueScheduler();
+	}
+
+	//
+
 	uint2 GraphicsContext::GetBackBufferSize() const
 	{
 		return gfx::GetBackBufferSize();
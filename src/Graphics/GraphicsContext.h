@@ -2,6 +2,7 @@
 
 #include "Core/Core.h"
 #include "Graphics/Handles.h"
+#include "Graphics/QueueScheduler.h"
 #include "Graphics/Resources.h"
 #include "Graphics/ShaderResourceProxy.h"
 
@@ -14,15 +15,20 @@ namespace vast
 			: swapChainSize(1600, 900)
 			, swapChainFormat(TexFormat::RGBA8_UNORM)
 			, backBufferFormat(TexFormat::RGBA8_UNORM_SRGB)
+			, latencyMode(FrameLatencyMode::BALANCED)
 		{}
 
 		uint2 swapChainSize;
 		TexFormat swapChainFormat;
 		TexFormat backBufferFormat;
+		FrameLatencyMode latencyMode;
 	};
 
 	class GPUResourceManager;
 	class GPUProfiler;
+	class DisplayList;
+	class DrawQueue;
+	struct DisplayListCmd;
 	
 	class GraphicsContext
 	{
@@ -35,12 +41,29 @@ namespace vast
 
 		bool IsInFrame() const;
 		double GetLastFrameDuration();
+		// Number of state changes that were set or skipped as redundant during the last frame.
+		const StateCacheStats& GetLastFrameStateCacheStats() const;
+		// Time the CPU spent blocked on the GPU during the last frame, by cause.
+		const FenceWaitStats& GetLastFrameFenceWaitStats() const;
+		// Pipeline states found in (hits) or added to (stores) the persistent pipeline cache.
+		PipelineCacheStats GetPipelineCacheStats() const;
+
+		// The new mode takes effect at the beginning of the next frame, which waits for the GPU to
+		// go idle before changing the number of frames in flight.
+		void SetFrameLatencyMode(FrameLatencyMode mode);
+		FrameLatencyMode GetFrameLatencyMode() const;
+		uint32 GetNumFramesInFlight() const;
 
 		void BeginRenderPass(PipelineHandle h, const RenderPassDesc desc);
 		// Renders to the back buffer as the only target
 		void BeginRenderPassToBackBuffer(PipelineHandle h, LoadOp loadOp = LoadOp::LOAD, StoreOp storeOp = StoreOp::STORE);
 		void EndRenderPass();
+		// Switches to another graphics pipeline within the current render pass. The pipeline must
+		// render to the same target formats as the one the pass was begun with. Binding the pipeline
+		// that is already bound is skipped.
+		void BindPipeline(PipelineHandle h);
 
+		// Note: Render pass state is tracked per thread, see Multithreaded Recording below.
 		bool IsInRenderPass() const;
 
 		// TODO: We may want to do Begin/End functions for compute to be analogous with graphics 
@@ -58,12 +81,27 @@ namespace vast
 		// Resource Transitions
 		void AddBarrier(BufferHandle h, ResourceState newState);
 		void AddBarrier(TextureHandle h, ResourceState newState);
+		// Must precede the first use of a placed resource that aliases memory with other resources.
+		void AddAliasingBarrier(BufferHandle h);
+		void AddAliasingBarrier(TextureHandle h);
 		void FlushBarriers();
+		// Render and depth targets activated by an aliasing barrier must be discarded (or fully
+		// cleared) before any other use. Must be in RENDER_TARGET or DEPTH_WRITE state respectively.
+		void DiscardResource(TextureHandle h);
 
 		// Resource View Binding
 		void BindVertexBuffer(BufferHandle h, uint32 offset = 0, uint32 stride = 0);
 		void BindIndexBuffer(BufferHandle h, uint32 offset = 0, IndexBufFormat format = IndexBufFormat::R16_UINT);
 		void BindConstantBuffer(ShaderResourceProxy proxy, BufferHandle h, uint32 offset = 0);
+		// Copies the data into memory that is only valid for the current frame, and binds it as the
+		// constant buffer for the given proxy. Suited for per draw data that doesn't fit in push
+		// constants, without the need for a persistent buffer per object. Size is in bytes.
+		void BindDynamicConstantBuffer(ShaderResourceProxy proxy, const void* data, const uint32 size);
+		template<typename T>
+		void BindDynamicConstantBuffer(ShaderResourceProxy proxy, const T& data)
+		{
+			BindDynamicConstantBuffer(proxy, &data, static_cast<uint32>(sizeof(T)));
+		}
 
 		// Passes some data to be used in the GPU under a constant buffer declared in a shader using slot
 		// 'PushConstantRegister'. Push Constants are best suited for small amounts of data that change
@@ -89,6 +127,50 @@ namespace vast
 
 		void Dispatch(uint3 threadGroupCount);
 
+		// - Display Lists --------------------------------------------------------------------- //
+
+		// Plays back all commands recorded in the list as if they were called on this context.
+		void ExecuteDisplayList(const DisplayList& dl);
+		// Plays back the draws of a sorted queue tagged with the given pass, in sort key order. Draw
+		// commands are expected to be recorded inside a render pass begun by the caller. Consecutive
+		// draws binding the same pipeline only bind it once.
+		void ExecuteDrawQueue(const DrawQueue& dq, uint8 pass);
+
+		// - Multithreaded Recording ----------------------------------------------------------- //
+
+		// Binds parallel command list 'idx' to the calling thread, so that all recording calls made
+		// from it go into that list instead of the main one. Different lists can be recorded
+		// concurrently from different threads, and each list can be recorded once per frame. Render
+		// passes must begin and end within the same list, and bindings are not inherited from the
+		// main command list.
+		void BeginParallelRecording(uint32 idx);
+		void EndParallelRecording(uint32 idx);
+		// Submits parallel command lists [0, count) in index order, after all work recorded on the
+		// main thread so far. Resource states are reconciled across lists here, so barriers recorded
+		// on each thread only need to account for their own usage. Must be called from the main
+		// thread once all lists in the range have finished recording.
+		void SubmitParallelRecordings(uint32 count);
+
+		// - Async Compute --------------------------------------------------------------------- //
+
+		// Recording calls made between Begin/EndAsyncCompute go into the compute command list, which
+		// is submitted to the compute queue on EndAsyncCompute and runs concurrently with graphics
+		// work unless explicitly synchronized. Only compute dispatches, bindings and barriers are
+		// allowed. Can be used multiple times per frame. Like parallel recordings, resource states
+		// are reconciled on submission. Transitions from graphics-only states (e.g. render targets)
+		// are recorded on the graphics queue, which the compute queue then waits on.
+		void BeginAsyncCompute();
+		// Returns the point the compute queue will signal once the recorded work completes.
+		QueueSyncPoint EndAsyncCompute();
+		// Submits all work recorded so far on the given queue and returns a point that other queues
+		// can wait on.
+		QueueSyncPoint SignalQueue(QueueType type);
+		// Work submitted to queue 'type' after this call won't start on the GPU until 'syncPoint' is
+		// reached. Waits that are already satisfied by previous waits are skipped. Waiting on a point
+		// that hasn't been signaled yet is not allowed, since it could deadlock the GPU.
+		void WaitForSyncPoint(QueueType type, QueueSyncPoint syncPoint);
+		const QueueScheduler& GetQueueScheduler() const;
+
 		// - Swap Chain/Back Buffers ----------------------------------------------------------- //
 
 		uint2 GetBackBufferSize() const;
@@ -101,11 +183,16 @@ namespace vast
 		GPUProfiler& GetGPUProfiler();
 
 	private:
+		void ExecuteDisplayListCommand(const DisplayListCmd& cmd);
+
 		Ptr<GPUResourceManager> m_GPUResourceManager;
 		Ptr<GPUProfiler> m_GpuProfiler;
 
 		bool m_bHasFrameBegun = false;
-		bool m_bHasRenderPassBegun = false;
+		bool m_bIsRecordingAsyncCompute = false;
+
+		FrameLatencyMode m_LatencyMode;
+		FrameLatencyMode m_PendingLatencyMode;
 
 		uint32 m_GpuFrameTimestampIdx;
 	};
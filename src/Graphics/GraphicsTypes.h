@@ -6,12 +6,17 @@ namespace vast
 {
 	// - Graphics constants -------------------------------------------------------------------- //
 
-	constexpr uint32 NUM_FRAMES_IN_FLIGHT = 2;
+	// Per-frame resources are allocated for the maximum number of frames in flight, while the number
+	// actually in use is chosen at runtime (see FrameLatencyMode).
+	constexpr uint32 MAX_FRAMES_IN_FLIGHT = 3;
+	// Maximum number of command lists that can be recorded in parallel from worker threads.
+	constexpr uint32 NUM_PARALLEL_COMMAND_LISTS = 8;
 
 	// TODO: Set sensible defaults
 	constexpr uint32 NUM_TEXTURES = 512;
 	constexpr uint32 NUM_BUFFERS = 512;
 	constexpr uint32 NUM_PIPELINES = 64;
+	constexpr uint32 NUM_MEMORY_HEAPS = 16;
 	constexpr uint32 NUM_TIMESTAMP_QUERIES = 256;
 
 	constexpr const char* VAST_SHADERS_SOURCE_PATH = "../../src/Shaders/";
@@ -32,6 +37,62 @@ namespace vast
 	};
 	static_assert(NELEM(g_GPUAdapterPreferenceCriteriaNames) == (CountBits(IDX(GPUAdapterPreferenceCriteria::MIN_POWER)) + 1));
 
+	// Trades input latency for GPU utilization by changing how many frames the CPU can record ahead
+	// of the GPU.
+	enum class FrameLatencyMode
+	{
+		LOW_LATENCY = 0,
+		BALANCED,
+		THROUGHPUT,
+		COUNT,
+	};
+	static const char* g_FrameLatencyModeNames[]
+	{
+		"Low Latency",
+		"Balanced",
+		"Throughput",
+	};
+	static_assert(NELEM(g_FrameLatencyModeNames) == IDX(FrameLatencyMode::COUNT));
+
+	constexpr uint32 GetNumFramesInFlight(FrameLatencyMode mode)
+	{
+		return static_cast<uint32>(IDX(mode)) + 1;
+	}
+	static_assert(GetNumFramesInFlight(FrameLatencyMode::THROUGHPUT) <= MAX_FRAMES_IN_FLIGHT);
+
+	// Reason the CPU had to block on a GPU fence.
+	enum class FenceWaitCause
+	{
+		FRAME_PACING = 0,
+		UPLOAD,
+		FLUSH,
+		RESIZE,
+		COUNT,
+	};
+	static const char* g_FenceWaitCauseNames[]
+	{
+		"Frame Pacing",
+		"Upload Sync",
+		"Flush",
+		"Resize",
+	};
+	static_assert(NELEM(g_FenceWaitCauseNames) == IDX(FenceWaitCause::COUNT));
+
+	enum class QueueType
+	{
+		GRAPHICS = 0,
+		COMPUTE,
+		UPLOAD,
+		COUNT,
+	};
+	static const char* g_QueueTypeNames[]
+	{
+		"Graphics",
+		"Compute",
+		"Upload",
+	};
+	static_assert(NELEM(g_QueueTypeNames) == IDX(QueueType::COUNT));
+
 	enum class BufViewFlags
 	{
 		NONE = 0,
@@ -264,6 +325,17 @@ namespace vast
 		// TODO: GPU_UPLOAD support when it hits mainstream support on the Agility SDK
 	};
 
+	// Kinds of resources a memory heap can hold. Devices that don't support MIXED heaps (i.e. D3D12
+	// Resource Heap Tier 1) need a separate heap for each of the other kinds instead.
+	enum class MemoryHeapType
+	{
+		BUFFERS = 0,
+		RT_DS_TEXTURES,
+		NON_RT_DS_TEXTURES,
+		MIXED,
+		COUNT,
+	};
+
 	enum class SamplerState
 	{
 		LINEAR_WRAP = 0,
@@ -303,4 +375,104 @@ namespace vast
 		ClearDepthStencil ds;
 	};
 
+	// - Stats ------------------------------------------------------------------------------------ //
+
+	struct StateCacheCounter
+	{
+		uint32 numSet = 0;
+		// Sets that were skipped because the state was already bound.
+		uint32 numElided = 0;
+
+		StateCacheCounter& operator+=(const StateCacheCounter& o) { numSet += o.numSet; numElided += o.numElided; return *this; }
+	};
+
+	struct StateCacheStats
+	{
+		StateCacheCounter pipeline;
+		StateCacheCounter rootSignature;
+		StateCacheCounter topology;
+		StateCacheCounter viewport;
+		StateCacheCounter scissorRect;
+		StateCacheCounter vertexBuffer;
+		StateCacheCounter indexBuffer;
+		StateCacheCounter rootArgument;
+
+		StateCacheStats& operator+=(const StateCacheStats& o)
+		{
+			pipeline += o.pipeline;
+			rootSignature += o.rootSignature;
+			topology += o.topology;
+			viewport += o.viewport;
+			scissorRect += o.scissorRect;
+			vertexBuffer += o.vertexBuffer;
+			indexBuffer += o.indexBuffer;
+			rootArgument += o.rootArgument;
+			return *this;
+		}
+
+		uint32 GetTotalElided() const
+		{
+			return pipeline.numElided + rootSignature.numElided + topology.numElided + viewport.numElided 
+				+ scissorRect.numElided + vertexBuffer.numElided + indexBuffer.numElided + rootArgument.numElided;
+		}
+	};
+
+	// Pipeline states loaded from, or added to, the persistent pipeline cache since startup.
+	struct PipelineCacheStats
+	{
+		uint32 numHits = 0;
+		uint32 numMisses = 0;
+		uint32 numStores = 0;
+		// Size of the cache loaded from disk at startup, and of the last one saved.
+		uint64 loadedBytes = 0;
+		uint64 savedBytes = 0;
+	};
+
+	// How fence waits that couldn't return immediately were resolved. Waits that complete while
+	// spinning avoid the OS wake-up latency of a kernel wait, which is included in the block times.
+	struct FenceWaitLatencyStats
+	{
+		uint32 numSpinWaits = 0;
+		uint32 numBlockingWaits = 0;
+		// Includes time spent spinning before falling back to a kernel wait.
+		uint64 spinTimeUs = 0;
+		uint64 blockTimeUs = 0;
+		uint64 maxBlockTimeUs = 0;
+
+		FenceWaitLatencyStats& operator+=(const FenceWaitLatencyStats& o)
+		{
+			numSpinWaits += o.numSpinWaits;
+			numBlockingWaits += o.numBlockingWaits;
+			spinTimeUs += o.spinTimeUs;
+			blockTimeUs += o.blockTimeUs;
+			maxBlockTimeUs = (std::max)(maxBlockTimeUs, o.maxBlockTimeUs);
+			return *this;
+		}
+	};
+
+	// Time the CPU spent blocked on GPU fences, by cause. Waits on fences that were already reached
+	// are not counted.
+	struct FenceWaitStats
+	{
+		Array<double, IDX(FenceWaitCause::COUNT)> waitTimeMs = { 0 };
+		Array<uint32, IDX(FenceWaitCause::COUNT)> numWaits = { 0 };
+		FenceWaitLatencyStats latency;
+
+		void Record(FenceWaitCause cause, double timeMs)
+		{
+			waitTimeMs[IDX(cause)] += timeMs;
+			numWaits[IDX(cause)]++;
+		}
+
+		double GetTotalWaitTimeMs() const
+		{
+			double total = 0.0;
+			for (double t : waitTimeMs)
+			{
+				total += t;
+			}
+			return total;
+		}
+	};
+
 }
\ No newline at end of file
@@ -51,7 +51,7 @@ namespace vast
 	{
 		static const uint32 kInvalidHandleIdx = UINT32_MAX;
 		FreeList<SIZE> m_FreeQueue;
-		Array<uint32, SIZE> m_GenerationCounters;
+		Array<uint32, SIZE> m_GenerationCounters = {};
 
 	public:
 		Handle<H> AllocHandle()
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Core/Core.h"
+
+// ==================================== LOCAL RESOURCE STATES =====================================
+//
+// Command lists recorded in parallel can't resolve barriers against the global state of a resource,
+// since the state a resource is in when a list starts executing depends on every list submitted
+// before it. Instead, these lists track resource states locally: barriers are only recorded for
+// transitions within the list, and for each resource the list remembers the first state it is used
+// in and the state it is left in.
+//
+// On submission, ResolveLocalResourceStates is called on each list in submission order to get the
+// transitions from the global states into the states the list expects. These transitions must be
+// recorded on a command list that tracks states globally and executes right before it, since a list
+// tracking states locally would take them as the first use of each resource instead.
+//
+// The global state of a resource is read from and written to its 'state' member.
+//
+// ================================================================================================
+
+namespace vast
+{
+	template<typename Resource, typename State>
+	struct LocalResourceState
+	{
+		Resource* resource = nullptr;
+		// State the resource is expected to be in when the command list starts executing.
+		State initialState = {};
+		// State the resource is left in when the command list finishes executing.
+		State currentState = {};
+	};
+
+	template<typename Resource, typename State>
+	struct LocalResourceTransition
+	{
+		Resource* resource = nullptr;
+		State before = {};
+		State after = {};
+	};
+
+	// Appends the transitions required before a command list that tracked the given local states,
+	// and advances the global state of each resource to the one the list leaves it in. Resources
+	// already in the expected state need no transition, unless it is 'uavState', since accesses to
+	// unordered access resources in different lists must still be ordered by a UAV barrier.
+	template<typename Resource, typename State>
+	void ResolveLocalResourceStates(const Vector<LocalResourceState<Resource, State>>& localStates, Vector<LocalResourceTransition<Resource, State>>& outTransitions, const State& uavState)
+	{
+		for (const auto& rs : localStates)
+		{
+			if (rs.resource->state != rs.initialState || rs.initialState == uavState)
+			{
+				outTransitions.push_back(LocalResourceTransition<Resource, State>{ rs.resource, rs.resource->state, rs.initialState });
+			}
+			rs.resource->state = rs.currentState;
+		}
+	}
+}
@@ -0,0 +1,173 @@
+#include "vastpch.h"
+#include "Graphics/QueueScheduler.h"
+
+#include <algorithm>
+
+namespace vast
+{
+
+	QueueScheduler::QueueScheduler()
+		: m_KnownValues({ { 0 } })
+		, m_SignalSnapshots()
+		, m_NextSnapshotIdx({ 0 })
+		, m_FrameEvents()
+		, m_FrameStartValues({ 0 })
+		, m_NumElidedWaits(0)
+	{
+	}
+
+	void QueueScheduler::BeginFrame()
+	{
+		m_FrameEvents.clear();
+		for (uint32 i = 0; i < IDX(QueueType::COUNT); ++i)
+		{
+			m_FrameStartValues[i] = m_KnownValues[i][i];
+		}
+		m_NumElidedWaits = 0;
+	}
+
+	void QueueScheduler::OnExecute(QueueType queue, float cost /* = 0.0f */)
+	{
+		VAST_ASSERT(queue != QueueType::COUNT);
+		m_FrameEvents.push_back(QueueEvent{ QueueEventType::EXECUTE, queue, {}, cost });
+	}
+
+	void QueueScheduler::OnSignal(QueueType queue, uint64 value)
+	{
+		VAST_ASSERT(queue != QueueType::COUNT);
+		KnownValues& known = m_KnownValues[IDX(queue)];
+		VAST_ASSERTF(value > known[IDX(queue)], "Fence values must increase monotonically.");
+		// A queue has always reached its own signals.
+		known[IDX(queue)] = value;
+
+		uint32& snapshotIdx = m_NextSnapshotIdx[IDX(queue)];
+		m_SignalSnapshots[IDX(queue)][snapshotIdx] = SignalSnapshot{ value, known };
+		snapshotIdx = (snapshotIdx + 1) % kNumSignalSnapshots;
+
+		m_FrameEvents.push_back(QueueEvent{ QueueEventType::SIGNAL, queue, QueueSyncPoint{ queue, value } });
+	}
+
+	bool QueueScheduler::RequestWait(QueueType queue, QueueSyncPoint syncPoint)
+	{
+		VAST_ASSERT(queue != QueueType::COUNT && syncPoint.IsValid());
+		VAST_ASSERTF(syncPoint.value <= GetLastSignaledValue(syncPoint.queue),
+			"Attempted to wait on a sync point that has not been submitted yet. This could deadlock the GPU.");
+
+		KnownValues& known = m_KnownValues[IDX(queue)];
+		if (known[IDX(syncPoint.queue)] >= syncPoint.value)
+		{
+			m_NumElidedWaits++;
+			return false;
+		}
+
+		// Waiting on a signal also waits on everything the signaling queue had waited on before it.
+		if (const SignalSnapshot* snapshot = FindSnapshot(syncPoint.queue, syncPoint.value))
+		{
+			for (uint32 i = 0; i < IDX(QueueType::COUNT); ++i)
+			{
+				if (i != static_cast<uint32>(IDX(queue)))
+				{
+					known[i] = (std::max)(known[i], snapshot->knownValues[i]);
+				}
+			}
+		}
+		known[IDX(syncPoint.queue)] = (std::max)(known[IDX(syncPoint.queue)], syncPoint.value);
+
+		m_FrameEvents.push_back(QueueEvent{ QueueEventType::WAIT, queue, syncPoint });
+		return true;
+	}
+
+	uint64 QueueScheduler::GetLastSignaledValue(QueueType queue) const
+	{
+		return m_KnownValues[IDX(queue)][IDX(queue)];
+	}
+
+	uint64 QueueScheduler::GetKnownValue(QueueType waitingQueue, QueueType signalingQueue) const
+	{
+		return m_KnownValues[IDX(waitingQueue)][IDX(signalingQueue)];
+	}
+
+	const QueueScheduler::SignalSnapshot* QueueScheduler::FindSnapshot(QueueType queue, uint64 value) const
+	{
+		// Note: Sync points handed out are always values that were signaled through OnSignal, so an
+		// exact match is required. Otherwise a later signal could report waits that the one we are
+		// waiting on didn't include yet.
+		for (const auto& snapshot : m_SignalSnapshots[IDX(queue)])
+		{
+			if (snapshot.value == value)
+			{
+				return &snapshot;
+			}
+		}
+		return nullptr;
+	}
+
+	//
+
+	QueueTimelineResult SimulateQueueTimeline(const Vector<QueueEvent>& events, const QueueFenceValues& reachedValues /* = {} */)
+	{
+		constexpr uint32 kNumQueues = IDX(QueueType::COUNT);
+
+		QueueTimelineResult result;
+
+		// Split events into one ordered stream per queue.
+		Array<Vector<const QueueEvent*>, kNumQueues> streams;
+		for (const auto& e : events)
+		{
+			streams[IDX(e.queue)].push_back(&e);
+		}
+
+		Array<uint32, kNumQueues> cursor = { 0 };
+		Array<float, kNumQueues> time = { 0 };
+		// Signaled values and the time at which they were reached, per queue.
+		Array<Vector<std::pair<uint64, float>>, kNumQueues> signals;
+
+		bool bProgress = true;
+		while (bProgress)
+		{
+			bProgress = false;
+			for (uint32 q = 0; q < kNumQueues; ++q)
+			{
+				while (cursor[q] < streams[q].size())
+				{
+					const QueueEvent& e = *streams[q][cursor[q]];
+					if (e.type == QueueEventType::EXECUTE)
+					{
+						time[q] += e.cost;
+					}
+					else if (e.type == QueueEventType::SIGNAL)
+					{
+						signals[q].push_back(std::make_pair(e.syncPoint.value, time[q]));
+					}
+					else if (e.syncPoint.value > reachedValues[IDX(e.syncPoint.queue)])
+					{
+						const auto& s = signals[IDX(e.syncPoint.queue)];
+						auto it = std::find_if(s.begin(), s.end(), [&e](const auto& sig) { return sig.first >= e.syncPoint.value; });
+						if (it == s.end())
+							break; // Blocked until the signaling queue makes progress.
+
+						if (it->second > time[q])
+						{
+							result.queueStallTime[q] += it->second - time[q];
+							time[q] = it->second;
+						}
+					}
+					cursor[q]++;
+					bProgress = true;
+				}
+			}
+		}
+
+		for (uint32 q = 0; q < kNumQueues; ++q)
+		{
+			result.queueEndTime[q] = time[q];
+			if (cursor[q] < streams[q].size())
+			{
+				result.bDeadlock = true;
+			}
+		}
+
+		return result;
+	}
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Graphics/GraphicsTypes.h"
+
+// ====================================== QUEUE SCHEDULER =========================================
+//
+// Work submitted to different GPU queues runs concurrently unless it is explicitly synchronized.
+// Each queue signals a monotonically increasing fence value after each submission, and a queue
+// can be made to wait on the GPU until another queue has reached a given value. A (queue, value)
+// pair is referred to as a QueueSyncPoint.
+//
+// The QueueScheduler keeps track of the dependencies between queues in order to:
+//
+//	- Elide waits that are already satisfied, either because the waiting queue already waited on
+//	  a later value of the same queue, or transitively through a wait on a third queue (e.g. if
+//	  graphics waits on compute, and compute had waited on upload, graphics has also waited on
+//	  upload).
+//	- Validate that waits only target sync points that have already been submitted. Forward waits
+//	  are the only way to build a dependency cycle between queues, so this guarantees the GPU can
+//	  never deadlock.
+//
+// Every signal, wait and submission is recorded as a QueueEvent, which makes it possible to
+// replay a frame on a simulated multi-queue timeline (see SimulateQueueTimeline). Since events are
+// cleared every frame, the values each queue had signaled when the frame began are kept as well, so
+// that waits on work from previous frames can be replayed. The scheduler has no dependencies on
+// the graphics backend.
+//
+// ================================================================================================
+
+namespace vast
+{
+	struct QueueSyncPoint
+	{
+		QueueType queue = QueueType::COUNT;
+		uint64 value = 0;
+
+		bool IsValid() const { return queue != QueueType::COUNT && value != 0; }
+	};
+
+	enum class QueueEventType
+	{
+		EXECUTE,
+		SIGNAL,
+		WAIT,
+	};
+
+	// Fence value per queue.
+	using QueueFenceValues = Array<uint64, IDX(QueueType::COUNT)>;
+
+	struct QueueEvent
+	{
+		QueueEventType type = QueueEventType::EXECUTE;
+		QueueType queue = QueueType::COUNT;
+		// Signaled value, or the sync point waited on.
+		QueueSyncPoint syncPoint = {};
+		// Estimated duration of the work, only used by the simulation.
+		float cost = 0.0f;
+	};
+
+	class QueueScheduler
+	{
+	public:
+		QueueScheduler();
+
+		// Clears the recorded events. Dependency state carries over across frames.
+		void BeginFrame();
+
+		void OnExecute(QueueType queue, float cost = 0.0f);
+		void OnSignal(QueueType queue, uint64 value);
+		// Returns true if 'queue' needs to issue a GPU wait on the sync point, false if the wait is
+		// already satisfied by previous waits.
+		bool RequestWait(QueueType queue, QueueSyncPoint syncPoint);
+
+		uint64 GetLastSignaledValue(QueueType queue) const;
+		// Latest value of 'signalingQueue' that 'waitingQueue' is known to have waited on.
+		uint64 GetKnownValue(QueueType waitingQueue, QueueType signalingQueue) const;
+
+		const Vector<QueueEvent>& GetFrameEvents() const { return m_FrameEvents; }
+		// Last value signaled by each queue before the current frame began.
+		const QueueFenceValues& GetFrameStartValues() const { return m_FrameStartValues; }
+		uint32 GetNumElidedWaits() const { return m_NumElidedWaits; }
+
+	private:
+		using KnownValues = QueueFenceValues;
+
+		// Number of past signals per queue for which we remember what the queue had waited on. Waits
+		// on older signals are still correct but can't be used to elide waits transitively.
+		static constexpr uint32 kNumSignalSnapshots = 64;
+
+		struct SignalSnapshot
+		{
+			uint64 value = 0;
+			KnownValues knownValues = { 0 };
+		};
+
+		const SignalSnapshot* FindSnapshot(QueueType queue, uint64 value) const;
+
+		// What each queue has waited on, per signaling queue.
+		Array<KnownValues, IDX(QueueType::COUNT)> m_KnownValues;
+		Array<Array<SignalSnapshot, kNumSignalSnapshots>, IDX(QueueType::COUNT)> m_SignalSnapshots;
+		Array<uint32, IDX(QueueType::COUNT)> m_NextSnapshotIdx;
+
+		Vector<QueueEvent> m_FrameEvents;
+		QueueFenceValues m_FrameStartValues;
+		uint32 m_NumElidedWaits;
+	};
+
+	struct QueueTimelineResult
+	{
+		// Time at which each queue finishes its last event.
+		Array<float, IDX(QueueType::COUNT)> queueEndTime = { 0 };
+		// Time each queue spent blocked on waits.
+		Array<float, IDX(QueueType::COUNT)> queueStallTime = { 0 };
+		// Set if some wait could never be satisfied.
+		bool bDeadlock = false;
+	};
+
+	// Replays the events on an idealized GPU where each queue processes its events in order, work
+	// takes 'cost' time units, and queues run fully in parallel unless they wait on each other. Waits
+	// on values at or below 'reachedValues' (e.g. signaled during previous frames, see
+	// QueueScheduler::GetFrameStartValues) are already satisfied when the timeline starts.
+	QueueTimelineResult SimulateQueueTimeline(const Vector<QueueEvent>& events, const QueueFenceValues& reachedValues = {});
+
+}
@@ -0,0 +1,558 @@
+#include "vastpch.h"
+#include "Graphics/RenderGraph.h"
+
+#include <algorithm>
+
+namespace vast
+{
+	// Matches D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, but kept here so the graph remains device-agnostic.
+	static constexpr uint64 kDefaultPlacementAlignment = 64 * 1024;
+
+	static uint32 GetTexFormatBytesPerPixel(TexFormat format)
+	{
+		switch (format)
+		{
+		case TexFormat::RGBA32_FLOAT:			return 16;
+		case TexFormat::RGBA16_FLOAT:			return 8;
+		case TexFormat::RG32_FLOAT:				return 8;
+		case TexFormat::RG16_FLOAT:				return 4;
+		case TexFormat::RGBA8_UNORM:			return 4;
+		case TexFormat::RGBA8_UNORM_SRGB:		return 4;
+		case TexFormat::D16_UNORM:				return 2;
+		case TexFormat::D32_FLOAT:				return 4;
+		case TexFormat::D32_FLOAT_S8X24_UINT:	return 8;
+		case TexFormat::D24_UNORM_S8_UINT:		return 4;
+		case TexFormat::R16_UINT:				return 2;
+		default: VAST_ASSERTF(0, "Unknown TexFormat size."); return 4;
+		}
+	}
+
+	ResourceAllocationInfo EstimateAllocationInfo(const BufferDesc& desc)
+	{
+		return ResourceAllocationInfo{ AlignU64(desc.size, kDefaultPlacementAlignment), kDefaultPlacementAlignment };
+	}
+
+	ResourceAllocationInfo EstimateAllocationInfo(const TextureDesc& desc)
+	{
+		const uint64 bpp = GetTexFormatBytesPerPixel(desc.format);
+		const bool bIs3D = (desc.type == TexType::TEXTURE_3D);
+
+		uint64 size = 0;
+		uint64 w = desc.width, h = desc.height, d = bIs3D ? desc.depthOrArraySize : 1;
+		for (uint32 i = 0; i < desc.mipCount; ++i)
+		{
+			size += w * h * d * bpp;
+			w = (std::max)(w / 2, uint64(1));
+			h = (std::max)(h / 2, uint64(1));
+			d = (std::max)(d / 2, uint64(1));
+		}
+
+		if (!bIs3D)
+		{
+			size *= desc.depthOrArraySize;
+		}
+
+		return ResourceAllocationInfo{ AlignU64(size, kDefaultPlacementAlignment), kDefaultPlacementAlignment };
+	}
+
+	static MemoryHeapType GetMemoryHeapType(const RGResource& r)
+	{
+		if (r.type == RGResourceType::BUFFER)
+			return MemoryHeapType::BUFFERS;
+
+		const bool bIsRenderOrDepthTarget = (r.texDesc.viewFlags & (TexViewFlags::RTV | TexViewFlags::DSV)) != TexViewFlags::NONE;
+		return bIsRenderOrDepthTarget ? MemoryHeapType::RT_DS_TEXTURES : MemoryHeapType::NON_RT_DS_TEXTURES;
+	}
+
+	//
+
+	RGBufferHandle RenderGraphBuilder::CreateBuffer(const std::string& name, const BufferDesc& desc)
+	{
+		RGResource r;
+		r.name = name;
+		r.type = RGResourceType::BUFFER;
+		r.bufDesc = desc;
+		uint32 nodeIdx = m_Graph.CreateNode(m_Graph.CreateResource(std::move(r)), m_PassIdx);
+
+		RGPass& pass = m_Graph.m_Passes[m_PassIdx];
+		pass.creates.push_back(nodeIdx);
+		// Creating a resource counts as writing its initial contents.
+		pass.writes.push_back(RGPass::Access{ nodeIdx, ResourceState::UNORDERED_ACCESS });
+		return RGBufferHandle(nodeIdx);
+	}
+
+	RGTextureHandle RenderGraphBuilder::CreateTexture(const std::string& name, const TextureDesc& desc)
+	{
+		RGResource r;
+		r.name = name;
+		r.type = RGResourceType::TEXTURE;
+		r.texDesc = desc;
+		uint32 nodeIdx = m_Graph.CreateNode(m_Graph.CreateResource(std::move(r)), m_PassIdx);
+
+		RGPass& pass = m_Graph.m_Passes[m_PassIdx];
+		pass.creates.push_back(nodeIdx);
+		ResourceState initialState = IsTexFormatDepth(desc.format) ? ResourceState::DEPTH_WRITE : ResourceState::RENDER_TARGET;
+		if ((desc.viewFlags & TexViewFlags::UAV) == TexViewFlags::UAV)
+		{
+			initialState = ResourceState::UNORDERED_ACCESS;
+		}
+		pass.writes.push_back(RGPass::Access{ nodeIdx, initialState });
+		return RGTextureHandle(nodeIdx);
+	}
+
+	RGBufferHandle RenderGraphBuilder::Read(RGBufferHandle h, ResourceState state /* = ResourceState::NON_PIXEL_SHADER_RESOURCE */)
+	{
+		VAST_ASSERT(h.IsValid());
+		m_Graph.m_Passes[m_PassIdx].reads.push_back(RGPass::Access{ h.m_NodeIdx, state });
+		m_Graph.m_Nodes[h.m_NodeIdx].readCount++;
+		return h;
+	}
+
+	RGTextureHandle RenderGraphBuilder::Read(RGTextureHandle h, ResourceState state /* = ResourceState::PIXEL_SHADER_RESOURCE */)
+	{
+		VAST_ASSERT(h.IsValid());
+		m_Graph.m_Passes[m_PassIdx].reads.push_back(RGPass::Access{ h.m_NodeIdx, state });
+		m_Graph.m_Nodes[h.m_NodeIdx].readCount++;
+		return h;
+	}
+
+	RGBufferHandle RenderGraphBuilder::Write(RGBufferHandle h, ResourceState state /* = ResourceState::UNORDERED_ACCESS */)
+	{
+		VAST_ASSERT(h.IsValid());
+		uint32 resourceIdx = m_Graph.m_Nodes[h.m_NodeIdx].resourceIdx;
+		VAST_ASSERTF(m_Graph.m_Resources[resourceIdx].latestNodeIdx == h.m_NodeIdx, "Writing to an outdated version of a resource.");
+
+		// Note: Writing counts as reading the previous version, so that its producer isn't culled.
+		m_Graph.m_Passes[m_PassIdx].writtenOver.push_back(h.m_NodeIdx);
+		m_Graph.m_Nodes[h.m_NodeIdx].readCount++;
+
+		uint32 nodeIdx = m_Graph.CreateNode(resourceIdx, m_PassIdx);
+		m_Graph.m_Passes[m_PassIdx].writes.push_back(RGPass::Access{ nodeIdx, state });
+		return RGBufferHandle(nodeIdx);
+	}
+
+	RGTextureHandle RenderGraphBuilder::Write(RGTextureHandle h, ResourceState state /* = ResourceState::RENDER_TARGET */)
+	{
+		VAST_ASSERT(h.IsValid());
+		uint32 resourceIdx = m_Graph.m_Nodes[h.m_NodeIdx].resourceIdx;
+		VAST_ASSERTF(m_Graph.m_Resources[resourceIdx].latestNodeIdx == h.m_NodeIdx, "Writing to an outdated version of a resource.");
+
+		// Note: Writing counts as reading the previous version, so that its producer isn't culled.
+		m_Graph.m_Passes[m_PassIdx].writtenOver.push_back(h.m_NodeIdx);
+		m_Graph.m_Nodes[h.m_NodeIdx].readCount++;
+
+		uint32 nodeIdx = m_Graph.CreateNode(resourceIdx, m_PassIdx);
+		m_Graph.m_Passes[m_PassIdx].writes.push_back(RGPass::Access{ nodeIdx, state });
+		return RGTextureHandle(nodeIdx);
+	}
+
+	void RenderGraphBuilder::SetSideEffects()
+	{
+		m_Graph.m_Passes[m_PassIdx].bHasSideEffects = true;
+	}
+
+	//
+
+	RenderGraph::RenderGraph()
+		: m_Passes()
+		, m_Resources()
+		, m_Nodes()
+		, m_ExecutionOrder()
+		, m_MemoryQuery()
+		, m_Stats()
+		, m_bIsCompiled(false)
+	{
+		m_MemoryQuery.buffer = [](const BufferDesc& desc) { return EstimateAllocationInfo(desc); };
+		m_MemoryQuery.texture = [](const TextureDesc& desc) { return EstimateAllocationInfo(desc); };
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Passes.clear();
+		m_Resources.clear();
+		m_Nodes.clear();
+		m_ExecutionOrder.clear();
+		m_Stats = {};
+		m_bIsCompiled = false;
+	}
+
+	uint32 RenderGraph::CreateResource(RGResource&& r)
+	{
+		m_Resources.push_back(std::move(r));
+		return static_cast<uint32>(m_Resources.size() - 1);
+	}
+
+	uint32 RenderGraph::CreateNode(uint32 resourceIdx, uint32 producerPass)
+	{
+		RGResource& r = m_Resources[resourceIdx];
+
+		Node n;
+		n.resourceIdx = resourceIdx;
+		n.version = (r.latestNodeIdx == kInvalidRenderGraphIdx) ? 0 : m_Nodes[r.latestNodeIdx].version + 1;
+		n.producerPass = producerPass;
+		m_Nodes.push_back(n);
+
+		r.latestNodeIdx = static_cast<uint32>(m_Nodes.size() - 1);
+		return r.latestNodeIdx;
+	}
+
+	RGResource& RenderGraph::GetNodeResource(uint32 nodeIdx)
+	{
+		return m_Resources[m_Nodes[nodeIdx].resourceIdx];
+	}
+
+	const RGResource& RenderGraph::GetNodeResource(uint32 nodeIdx) const
+	{
+		return m_Resources[m_Nodes[nodeIdx].resourceIdx];
+	}
+
+	RGBufferHandle RenderGraph::ImportBuffer(const std::string& name, BufferHandle h, ResourceState currState /* = ResourceState::NONE */)
+	{
+		VAST_ASSERT(h.IsValid());
+		RGResource r;
+		r.name = name;
+		r.type = RGResourceType::BUFFER;
+		r.bImported = true;
+		r.importedState = currState;
+		r.buf = h;
+		return RGBufferHandle(CreateNode(CreateResource(std::move(r)), kInvalidRenderGraphIdx));
+	}
+
+	RGTextureHandle RenderGraph::ImportTexture(const std::string& name, TextureHandle h, ResourceState currState /* = ResourceState::NONE */)
+	{
+		VAST_ASSERT(h.IsValid());
+		RGResource r;
+		r.name = name;
+		r.type = RGResourceType::TEXTURE;
+		r.bImported = true;
+		r.importedState = currState;
+		r.tex = h;
+		return RGTextureHandle(CreateNode(CreateResource(std::move(r)), kInvalidRenderGraphIdx));
+	}
+
+	void RenderGraph::Export(RGBufferHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		GetNodeResource(h.m_NodeIdx).bExported = true;
+	}
+
+	void RenderGraph::Export(RGTextureHandle h)
+	{
+		VAST_ASSERT(h.IsValid());
+		GetNodeResource(h.m_NodeIdx).bExported = true;
+	}
+
+	void RenderGraph::AddPass(const std::string& name, const std::function<void(RenderGraphBuilder&)>& setup, RenderGraphExecuteFunc&& execute)
+	{
+		VAST_ASSERTF(!m_bIsCompiled, "Cannot add passes to a compiled graph, call Reset() first.");
+
+		RGPass pass;
+		pass.name = name;
+		pass.execute = std::move(execute);
+		m_Passes.push_back(std::move(pass));
+
+		RenderGraphBuilder builder(*this, static_cast<uint32>(m_Passes.size() - 1));
+		setup(builder);
+	}
+
+	void RenderGraph::SetMemoryQuery(const RenderGraphMemoryQuery& query)
+	{
+		VAST_ASSERT(query.buffer && query.texture);
+		m_MemoryQuery = query;
+	}
+
+	BufferHandle RenderGraph::GetBuffer(RGBufferHandle h) const
+	{
+		VAST_ASSERT(h.IsValid());
+		const RGResource& r = GetNodeResource(h.m_NodeIdx);
+		VAST_ASSERTF(r.type == RGResourceType::BUFFER && r.buf.IsValid(), "Buffer '{}' has not been realized.", r.name);
+		return r.buf;
+	}
+
+	TextureHandle RenderGraph::GetTexture(RGTextureHandle h) const
+	{
+		VAST_ASSERT(h.IsValid());
+		const RGResource& r = GetNodeResource(h.m_NodeIdx);
+		VAST_ASSERTF(r.type == RGResourceType::TEXTURE && r.tex.IsValid(), "Texture '{}' has not been realized.", r.name);
+		return r.tex;
+	}
+
+	//
+
+	void RenderGraph::Compile()
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(!m_bIsCompiled, "Render graph has already been compiled.");
+
+		CullPasses();
+
+		m_ExecutionOrder.clear();
+		for (uint32 i = 0; i < m_Passes.size(); ++i)
+		{
+			if (!m_Passes[i].bCulled)
+			{
+				m_ExecutionOrder.push_back(i);
+			}
+		}
+
+		ComputeLifetimes();
+		ComputeTransientPlacement();
+		ComputeBarriers();
+
+		m_Stats.numPasses = static_cast<uint32>(m_Passes.size());
+		m_Stats.numCulledPasses = m_Stats.numPasses - static_cast<uint32>(m_ExecutionOrder.size());
+
+		m_bIsCompiled = true;
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		// Reference count passes by the number of resources they write to, then walk backwards from
+		// every resource version nobody reads, releasing the references held by their producers.
+		for (auto& pass : m_Passes)
+		{
+			pass.refCount = static_cast<uint32>(pass.writes.size());
+			pass.bCulled = false;
+		}
+
+		auto IsKept = [this](uint32 nodeIdx)
+		{
+			const RGResource& r = GetNodeResource(nodeIdx);
+			return r.bImported || r.bExported;
+		};
+
+		Vector<uint32> readCounts(m_Nodes.size());
+		Vector<uint32> unreferencedNodes;
+		for (uint32 i = 0; i < m_Nodes.size(); ++i)
+		{
+			readCounts[i] = m_Nodes[i].readCount;
+			if (readCounts[i] == 0 && !IsKept(i))
+			{
+				unreferencedNodes.push_back(i);
+			}
+		}
+
+		while (!unreferencedNodes.empty())
+		{
+			uint32 nodeIdx = unreferencedNodes.back();
+			unreferencedNodes.pop_back();
+
+			uint32 producerIdx = m_Nodes[nodeIdx].producerPass;
+			if (producerIdx == kInvalidRenderGraphIdx)
+				continue;
+
+			RGPass& producer = m_Passes[producerIdx];
+			VAST_ASSERT(producer.refCount > 0);
+			if (--producer.refCount > 0 || producer.bHasSideEffects)
+				continue;
+
+			producer.bCulled = true;
+			auto ReleaseRead = [&](uint32 readNodeIdx)
+			{
+				VAST_ASSERT(readCounts[readNodeIdx] > 0);
+				if (--readCounts[readNodeIdx] == 0 && !IsKept(readNodeIdx))
+				{
+					unreferencedNodes.push_back(readNodeIdx);
+				}
+			};
+			for (const auto& read : producer.reads)
+			{
+				ReleaseRead(read.nodeIdx);
+			}
+			for (uint32 writtenOverNodeIdx : producer.writtenOver)
+			{
+				ReleaseRead(writtenOverNodeIdx);
+			}
+		}
+	}
+
+	void RenderGraph::ComputeLifetimes()
+	{
+		for (auto& r : m_Resources)
+		{
+			r.firstUse = kInvalidRenderGraphIdx;
+			r.lastUse = kInvalidRenderGraphIdx;
+		}
+
+		auto UpdateLifetime = [this](uint32 nodeIdx, uint32 orderIdx)
+		{
+			RGResource& r = GetNodeResource(nodeIdx);
+			if (r.firstUse == kInvalidRenderGraphIdx)
+			{
+				r.firstUse = orderIdx;
+			}
+			r.lastUse = orderIdx;
+		};
+
+		for (uint32 i = 0; i < m_ExecutionOrder.size(); ++i)
+		{
+			const RGPass& pass = m_Passes[m_ExecutionOrder[i]];
+			for (const auto& read : pass.reads)
+			{
+				UpdateLifetime(read.nodeIdx, i);
+			}
+			for (const auto& write : pass.writes)
+			{
+				UpdateLifetime(write.nodeIdx, i);
+			}
+		}
+	}
+
+	void RenderGraph::ComputeTransientPlacement()
+	{
+		Vector<uint32> transients;
+		m_Stats.transientUnaliasedSize = 0;
+		for (uint32 i = 0; i < m_Resources.size(); ++i)
+		{
+			RGResource& r = m_Resources[i];
+			r.heapOffset = 0;
+			r.bAliased = false;
+			if (!r.IsTransient() || !r.IsUsed())
+				continue;
+
+			r.heapType = m_MemoryQuery.bSupportsMixedHeaps ? MemoryHeapType::MIXED : GetMemoryHeapType(r);
+			r.allocInfo = (r.type == RGResourceType::BUFFER) ? m_MemoryQuery.buffer(r.bufDesc) : m_MemoryQuery.texture(r.texDesc);
+			m_Stats.transientUnaliasedSize += r.allocInfo.size;
+			transients.push_back(i);
+		}
+
+		// Place the biggest resources first, then fit each resource at the lowest offset that doesn't
+		// collide with any already placed resource in the same heap whose lifetime overlaps its own.
+		std::stable_sort(transients.begin(), transients.end(), [this](uint32 a, uint32 b)
+		{
+			return m_Resources[a].allocInfo.size > m_Resources[b].allocInfo.size;
+		});
+
+		auto LifetimesOverlap = [](const RGResource& a, const RGResource& b)
+		{
+			return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+		};
+
+		auto MemoryOverlaps = [](const RGResource& a, const RGResource& b)
+		{
+			return a.heapType == b.heapType && a.heapOffset < b.heapOffset + b.allocInfo.size && b.heapOffset < a.heapOffset + a.allocInfo.size;
+		};
+
+		m_Stats.transientHeapSizes = {};
+		Vector<uint32> placed;
+		Vector<uint32> colliding;
+		for (uint32 idx : transients)
+		{
+			RGResource& r = m_Resources[idx];
+
+			colliding.clear();
+			for (uint32 p : placed)
+			{
+				if (r.heapType == m_Resources[p].heapType && LifetimesOverlap(r, m_Resources[p]))
+				{
+					colliding.push_back(p);
+				}
+			}
+			std::sort(colliding.begin(), colliding.end(), [this](uint32 a, uint32 b)
+			{
+				return m_Resources[a].heapOffset < m_Resources[b].heapOffset;
+			});
+
+			uint64 offset = 0;
+			for (uint32 p : colliding)
+			{
+				const RGResource& other = m_Resources[p];
+				if (offset + r.allocInfo.size <= other.heapOffset)
+					break;
+
+				offset = (std::max)(offset, AlignU64(other.heapOffset + other.allocInfo.size, r.allocInfo.alignment));
+			}
+
+			r.heapOffset = offset;
+			uint64& heapSize = m_Stats.transientHeapSizes[IDX(r.heapType)];
+			heapSize = (std::max)(heapSize, offset + r.allocInfo.size);
+			placed.push_back(idx);
+		}
+
+		for (uint32 i = 0; i < placed.size(); ++i)
+		{
+			for (uint32 j = i + 1; j < placed.size(); ++j)
+			{
+				RGResource& a = m_Resources[placed[i]];
+				RGResource& b = m_Resources[placed[j]];
+				if (MemoryOverlaps(a, b))
+				{
+					VAST_ASSERT(!LifetimesOverlap(a, b));
+					a.bAliased = true;
+					b.bAliased = true;
+				}
+			}
+		}
+
+		m_Stats.numTransientResources = static_cast<uint32>(transients.size());
+		m_Stats.transientHeapSize = 0;
+		for (uint64 heapSize : m_Stats.transientHeapSizes)
+		{
+			m_Stats.transientHeapSize += heapSize;
+		}
+	}
+
+	void RenderGraph::ComputeBarriers()
+	{
+		Vector<ResourceState> currStates(m_Resources.size());
+		Vector<bool> bHasBeenUsed(m_Resources.size(), false);
+		for (uint32 i = 0; i < m_Resources.size(); ++i)
+		{
+			currStates[i] = m_Resources[i].bImported ? m_Resources[i].importedState : ResourceState::NONE;
+		}
+
+		m_Stats.numBarriers = 0;
+		Vector<std::pair<uint32, ResourceState>> passStates;
+		for (uint32 passIdx : m_ExecutionOrder)
+		{
+			RGPass& pass = m_Passes[passIdx];
+			pass.barriers.clear();
+
+			// Gather the state each resource needs for this pass. Read states are combined, while a
+			// write in the same pass takes precedence over any reads.
+			passStates.clear();
+			auto RequestState = [&passStates](uint32 resourceIdx, ResourceState state, bool bIsWrite)
+			{
+				for (auto& i : passStates)
+				{
+					if (i.first == resourceIdx)
+					{
+						i.second = bIsWrite ? state : (i.second | state);
+						return;
+					}
+				}
+				passStates.push_back(std::make_pair(resourceIdx, state));
+			};
+
+			for (const auto& read : pass.reads)
+			{
+				RequestState(m_Nodes[read.nodeIdx].resourceIdx, read.state, false);
+			}
+			for (const auto& write : pass.writes)
+			{
+				RequestState(m_Nodes[write.nodeIdx].resourceIdx, write.state, true);
+			}
+
+			for (const auto& [resourceIdx, state] : passStates)
+			{
+				const RGResource& r = m_Resources[resourceIdx];
+				const bool bIsFirstUse = !bHasBeenUsed[resourceIdx];
+				const bool bNeedsAliasing = bIsFirstUse && r.bAliased;
+				const bool bNeedsDiscard = bNeedsAliasing && r.type == RGResourceType::TEXTURE &&
+					(r.texDesc.viewFlags & (TexViewFlags::RTV | TexViewFlags::DSV)) != TexViewFlags::NONE;
+				// Consecutive unordered accesses still need a barrier to make writes visible.
+				const bool bNeedsUAVBarrier = (state == ResourceState::UNORDERED_ACCESS) && (currStates[resourceIdx] == state);
+
+				if (currStates[resourceIdx] != state || bNeedsAliasing || bNeedsUAVBarrier)
+				{
+					pass.barriers.push_back(RGBarrier{ resourceIdx, currStates[resourceIdx], state, bNeedsAliasing, bNeedsDiscard });
+					m_Stats.numBarriers++;
+				}
+
+				currStates[resourceIdx] = state;
+				bHasBeenUsed[resourceIdx] = true;
+			}
+		}
+	}
+
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "Graphics/Resources.h"
+
+#include <functional>
+
+// ======================================== RENDER GRAPH ==========================================
+//
+// The RenderGraph lets the user describe a frame as a list of passes that declare which resources
+// they create, read and write. Once all passes are added, the graph is compiled, which:
+//
+//	- Culls passes whose outputs are never consumed (unless they are flagged as having side
+//	  effects, or write to imported/exported resources).
+//	- Computes the resource state transitions required before each pass, so the user never has to
+//	  add barriers manually for resources managed by the graph.
+//	- Computes the lifetime of each transient resource and assigns it an offset in a shared
+//	  transient heap, such that resources whose lifetimes don't overlap alias the same memory.
+//	  Devices that can't mix kinds of resources in a heap get a transient heap for each kind.
+//
+// Compilation is purely CPU-side and device-agnostic: it has no dependencies on the graphics
+// backend and can be run and tested without a GPU. Turning a compiled graph into GPU work is the
+// job of the RenderGraphExecutor.
+//
+// Writing to a resource produces a new 'version' of it, returned as a new handle. Passes are
+// executed in declaration order, which is always a valid topological order since a pass can only
+// reference handles returned by earlier declarations.
+//
+// ================================================================================================
+
+namespace vast
+{
+	static constexpr uint32 kInvalidRenderGraphIdx = UINT32_MAX;
+
+	template<typename T>
+	class RenderGraphHandle
+	{
+		friend class RenderGraph;
+		friend class RenderGraphBuilder;
+	public:
+		RenderGraphHandle() : m_NodeIdx(kInvalidRenderGraphIdx) {}
+		bool IsValid() const { return m_NodeIdx != kInvalidRenderGraphIdx; }
+		bool operator==(const RenderGraphHandle<T>& o) const { return m_NodeIdx == o.m_NodeIdx; }
+		bool operator!=(const RenderGraphHandle<T>& o) const { return m_NodeIdx != o.m_NodeIdx; }
+
+		uint32 GetNodeIndex() const { return m_NodeIdx; }
+
+	private:
+		explicit RenderGraphHandle(uint32 nodeIdx) : m_NodeIdx(nodeIdx) {}
+
+		uint32 m_NodeIdx;
+	};
+
+	using RGBufferHandle = RenderGraphHandle<Buffer>;
+	using RGTextureHandle = RenderGraphHandle<Texture>;
+
+	enum class RGResourceType
+	{
+		BUFFER,
+		TEXTURE,
+	};
+
+	// Returns the size and alignment a resource would take when placed in a heap. The executor
+	// provides one that queries the device, while a CPU estimate is used by default.
+	struct RenderGraphMemoryQuery
+	{
+		std::function<ResourceAllocationInfo(const BufferDesc&)> buffer;
+		std::function<ResourceAllocationInfo(const TextureDesc&)> texture;
+		// If not supported, transients are placed in a separate heap for each kind of resource, and
+		// only resources of the same kind alias each other.
+		bool bSupportsMixedHeaps = true;
+	};
+
+	struct RGResource
+	{
+		std::string name;
+		RGResourceType type = RGResourceType::TEXTURE;
+		BufferDesc bufDesc = {};
+		TextureDesc texDesc = {};
+		bool bImported = false;
+		bool bExported = false;
+		ResourceState importedState = ResourceState::NONE;
+
+		// Physical resources, either imported or assigned by the executor.
+		BufferHandle buf;
+		TextureHandle tex;
+
+		uint32 latestNodeIdx = kInvalidRenderGraphIdx;
+
+		// Compilation results. Lifetimes are expressed as positions in the execution order.
+		uint32 firstUse = kInvalidRenderGraphIdx;
+		uint32 lastUse = kInvalidRenderGraphIdx;
+		ResourceAllocationInfo allocInfo = {};
+		MemoryHeapType heapType = MemoryHeapType::MIXED;
+		uint64 heapOffset = 0;
+		bool bAliased = false;
+
+		bool IsTransient() const { return !bImported; }
+		bool IsUsed() const { return firstUse != kInvalidRenderGraphIdx; }
+	};
+
+	struct RGBarrier
+	{
+		uint32 resourceIdx = kInvalidRenderGraphIdx;
+		ResourceState before = ResourceState::NONE;
+		ResourceState after = ResourceState::NONE;
+		// First use of a resource that shares heap memory with other transient resources.
+		bool bAliasing = false;
+		// Aliased render and depth targets must have their contents discarded before first use.
+		bool bDiscard = false;
+	};
+
+	class GraphicsContext;
+	class RenderGraph;
+
+	using RenderGraphExecuteFunc = std::function<void(GraphicsContext&, const RenderGraph&)>;
+
+	struct RGPass
+	{
+		struct Access
+		{
+			uint32 nodeIdx = kInvalidRenderGraphIdx;
+			ResourceState state = ResourceState::NONE;
+		};
+
+		std::string name;
+		RenderGraphExecuteFunc execute;
+		Vector<uint32> creates;
+		Vector<Access> reads;
+		Vector<Access> writes;
+		// Versions replaced by writes, since written contents may build upon them (e.g. when loaded).
+		Vector<uint32> writtenOver;
+		bool bHasSideEffects = false;
+
+		// Compilation results
+		uint32 refCount = 0;
+		bool bCulled = false;
+		Vector<RGBarrier> barriers;
+	};
+
+	class RenderGraphBuilder
+	{
+		friend class RenderGraph;
+	public:
+		RGBufferHandle CreateBuffer(const std::string& name, const BufferDesc& desc);
+		RGTextureHandle CreateTexture(const std::string& name, const TextureDesc& desc);
+
+		RGBufferHandle Read(RGBufferHandle h, ResourceState state = ResourceState::NON_PIXEL_SHADER_RESOURCE);
+		RGTextureHandle Read(RGTextureHandle h, ResourceState state = ResourceState::PIXEL_SHADER_RESOURCE);
+		// Writes return a new version of the resource that subsequent passes must use to read the
+		// written contents.
+		RGBufferHandle Write(RGBufferHandle h, ResourceState state = ResourceState::UNORDERED_ACCESS);
+		RGTextureHandle Write(RGTextureHandle h, ResourceState state = ResourceState::RENDER_TARGET);
+
+		// Passes with side effects (e.g. writing to the back buffer, readbacks) are never culled.
+		void SetSideEffects();
+
+	private:
+		RenderGraphBuilder(RenderGraph& rg, uint32 passIdx) : m_Graph(rg), m_PassIdx(passIdx) {}
+
+		RenderGraph& m_Graph;
+		uint32 m_PassIdx;
+	};
+
+	struct RenderGraphStats
+	{
+		uint32 numPasses = 0;
+		uint32 numCulledPasses = 0;
+		uint32 numBarriers = 0;
+		uint32 numTransientResources = 0;
+		// Total size of the transient heaps, and size of each of them (see RenderGraphMemoryQuery).
+		uint64 transientHeapSize = 0;
+		Array<uint64, IDX(MemoryHeapType::COUNT)> transientHeapSizes = {};
+		// Memory the transient resources would take without aliasing.
+		uint64 transientUnaliasedSize = 0;
+	};
+
+	class RenderGraph
+	{
+		friend class RenderGraphBuilder;
+		friend class RenderGraphExecutor;
+	public:
+		RenderGraph();
+
+		// Clears all passes and resources so the graph can be rebuilt for the next frame. Allocated
+		// memory is kept around to avoid reallocating every frame.
+		void Reset();
+
+		RGBufferHandle ImportBuffer(const std::string& name, BufferHandle h, ResourceState currState = ResourceState::NONE);
+		RGTextureHandle ImportTexture(const std::string& name, TextureHandle h, ResourceState currState = ResourceState::NONE);
+		// Exported resources are kept alive past the end of the graph, so their producers are not culled.
+		void Export(RGBufferHandle h);
+		void Export(RGTextureHandle h);
+
+		void AddPass(const std::string& name, const std::function<void(RenderGraphBuilder&)>& setup, RenderGraphExecuteFunc&& execute);
+
+		void SetMemoryQuery(const RenderGraphMemoryQuery& query);
+		void Compile();
+		bool IsCompiled() const { return m_bIsCompiled; }
+
+		// Physical resources can only be retrieved during execution.
+		BufferHandle GetBuffer(RGBufferHandle h) const;
+		TextureHandle GetTexture(RGTextureHandle h) const;
+
+		const Vector<RGPass>& GetPasses() const { return m_Passes; }
+		const Vector<RGResource>& GetResources() const { return m_Resources; }
+		const Vector<uint32>& GetExecutionOrder() const { return m_ExecutionOrder; }
+		const RenderGraphStats& GetStats() const { return m_Stats; }
+
+	private:
+		struct Node
+		{
+			uint32 resourceIdx = kInvalidRenderGraphIdx;
+			uint32 version = 0;
+			uint32 producerPass = kInvalidRenderGraphIdx;
+			uint32 readCount = 0;
+		};
+
+		uint32 CreateResource(RGResource&& r);
+		uint32 CreateNode(uint32 resourceIdx, uint32 producerPass);
+		RGResource& GetNodeResource(uint32 nodeIdx);
+		const RGResource& GetNodeResource(uint32 nodeIdx) const;
+
+		void CullPasses();
+		void ComputeLifetimes();
+		void ComputeBarriers();
+		void ComputeTransientPlacement();
+
+		Vector<RGPass> m_Passes;
+		Vector<RGResource> m_Resources;
+		Vector<Node> m_Nodes;
+		Vector<uint32> m_ExecutionOrder;
+
+		RenderGraphMemoryQuery m_MemoryQuery;
+		RenderGraphStats m_Stats;
+		bool m_bIsCompiled;
+	};
+
+	// CPU-side estimate of the memory requirements of a resource, used when no device is available.
+	ResourceAllocationInfo EstimateAllocationInfo(const BufferDesc& desc);
+	ResourceAllocationInfo EstimateAllocationInfo(const TextureDesc& desc);
+
+}
@@ -0,0 +1,220 @@
+#include "vastpch.h"
+#include "Graphics/RenderGraphExecutor.h"
+#include "Graphics/GraphicsContext.h"
+#include "Graphics/GPUResourceManager.h"
+
+namespace vast
+{
+
+	RenderGraphExecutor::RenderGraphExecutor(GraphicsContext& ctx)
+		: ctx(ctx)
+		, m_TransientHeaps()
+		, m_TransientHeapSizes({})
+		, m_TransientResources()
+	{
+	}
+
+	RenderGraphExecutor::~RenderGraphExecutor()
+	{
+		ReleaseTransientResources();
+
+		for (auto& heap : m_TransientHeaps)
+		{
+			if (heap.IsValid())
+			{
+				ctx.GetGPUResourceManager().DestroyMemoryHeap(heap);
+			}
+		}
+	}
+
+	void RenderGraphExecutor::Execute(RenderGraph& rg)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERTF(ctx.IsInFrame(), "Render graphs must be executed within a frame.");
+
+		if (!rg.IsCompiled())
+		{
+			GPUResourceManager& rm = ctx.GetGPUResourceManager();
+			rg.SetMemoryQuery(RenderGraphMemoryQuery
+			{
+				.buffer = [&rm](const BufferDesc& desc) { return rm.GetAllocationInfo(desc); },
+				.texture = [&rm](const TextureDesc& desc) { return rm.GetAllocationInfo(desc); },
+				.bSupportsMixedHeaps = rm.SupportsMixedMemoryHeaps(),
+			});
+			rg.Compile();
+		}
+
+		RealizeTransientResources(rg);
+
+		for (uint32 passIdx : rg.m_ExecutionOrder)
+		{
+			const RGPass& pass = rg.m_Passes[passIdx];
+
+			for (const auto& barrier : pass.barriers)
+			{
+				const RGResource& r = rg.m_Resources[barrier.resourceIdx];
+				if (r.type == RGResourceType::BUFFER)
+				{
+					if (barrier.bAliasing)
+					{
+						ctx.AddAliasingBarrier(r.buf);
+					}
+					ctx.AddBarrier(r.buf, barrier.after);
+				}
+				else
+				{
+					if (barrier.bAliasing)
+					{
+						ctx.AddAliasingBarrier(r.tex);
+					}
+					if (barrier.bDiscard)
+					{
+						const bool bIsDepthTarget = (r.texDesc.viewFlags & TexViewFlags::DSV) == TexViewFlags::DSV;
+						ctx.AddBarrier(r.tex, bIsDepthTarget ? ResourceState::DEPTH_WRITE : ResourceState::RENDER_TARGET);
+						ctx.DiscardResource(r.tex);
+					}
+					ctx.AddBarrier(r.tex, barrier.after);
+				}
+			}
+			ctx.FlushBarriers();
+
+			if (pass.execute)
+			{
+				pass.execute(ctx, rg);
+			}
+		}
+	}
+
+	bool RenderGraphExecutor::IsTransientResourceReusable(const TransientResource& t, const RGResource& r) const
+	{
+		if (t.type != r.type || t.heapType != r.heapType || t.heapOffset != r.heapOffset)
+			return false;
+
+		if (r.type == RGResourceType::BUFFER)
+		{
+			return t.buf.IsValid() 
+				&& t.bufDesc.size == r.bufDesc.size
+				&& t.bufDesc.stride == r.bufDesc.stride
+				&& t.bufDesc.viewFlags == r.bufDesc.viewFlags
+				&& t.bufDesc.bBindless == r.bufDesc.bBindless;
+		}
+		else
+		{
+			return t.tex.IsValid()
+				&& t.texDesc.type == r.texDesc.type
+				&& t.texDesc.format == r.texDesc.format
+				&& t.texDesc.width == r.texDesc.width
+				&& t.texDesc.height == r.texDesc.height
+				&& t.texDesc.depthOrArraySize == r.texDesc.depthOrArraySize
+				&& t.texDesc.mipCount == r.texDesc.mipCount
+				&& t.texDesc.viewFlags == r.texDesc.viewFlags
+				&& memcmp(&t.texDesc.clear, &r.texDesc.clear, sizeof(ClearValue)) == 0;
+		}
+	}
+
+	void RenderGraphExecutor::RealizeTransientResources(RenderGraph& rg)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		GPUResourceManager& rm = ctx.GetGPUResourceManager();
+
+		// Placed resources can be reused from previous frames as long as the graph places the exact 
+		// same resources at the same offsets, which is the common case for a mostly static frame.
+		bool bCanReuse = (m_TransientResources.size() == rg.m_Resources.size());
+		for (uint32 i = 0; bCanReuse && i < rg.m_Resources.size(); ++i)
+		{
+			const RGResource& r = rg.m_Resources[i];
+			if (r.IsTransient() && r.IsUsed())
+			{
+				bCanReuse = IsTransientResourceReusable(m_TransientResources[i], r);
+			}
+			else
+			{
+				bCanReuse = !m_TransientResources[i].buf.IsValid() && !m_TransientResources[i].tex.IsValid();
+			}
+		}
+
+		if (!bCanReuse)
+		{
+			ReleaseTransientResources();
+
+			bool bHasResizedHeaps = false;
+			for (uint32 i = 0; i < IDX(MemoryHeapType::COUNT); ++i)
+			{
+				const uint64 requiredHeapSize = rg.GetStats().transientHeapSizes[i];
+				if (requiredHeapSize <= m_TransientHeapSizes[i])
+					continue;
+
+				// Note: Destruction is deferred, so any frames in flight still using the old heap are safe.
+				if (m_TransientHeaps[i].IsValid())
+				{
+					rm.DestroyMemoryHeap(m_TransientHeaps[i]);
+				}
+				m_TransientHeaps[i] = rm.CreateMemoryHeap(requiredHeapSize, static_cast<MemoryHeapType>(i));
+				m_TransientHeapSizes[i] = requiredHeapSize;
+				bHasResizedHeaps = true;
+			}
+
+			if (bHasResizedHeaps)
+			{
+				VAST_LOG_INFO("[gfx] [rendergraph] Transient heaps resized to {:.2f} MB ({:.2f} MB without aliasing).",
+					B_TO_MB(rg.GetStats().transientHeapSize), B_TO_MB(rg.GetStats().transientUnaliasedSize));
+			}
+
+			m_TransientResources.resize(rg.m_Resources.size());
+			for (uint32 i = 0; i < rg.m_Resources.size(); ++i)
+			{
+				const RGResource& r = rg.m_Resources[i];
+				if (!r.IsTransient() || !r.IsUsed())
+					continue;
+
+				TransientResource& t = m_TransientResources[i];
+				t.type = r.type;
+				t.heapType = r.heapType;
+				t.heapOffset = r.heapOffset;
+				const MemoryHeapHandle heap = m_TransientHeaps[IDX(r.heapType)];
+				if (r.type == RGResourceType::BUFFER)
+				{
+					VAST_ASSERTF(rm.GetAllocationInfo(r.bufDesc).size <= r.allocInfo.size, "Graph was compiled with invalid memory requirements.");
+					t.bufDesc = r.bufDesc;
+					t.buf = rm.CreatePlacedBuffer(r.bufDesc, heap, r.heapOffset, r.name);
+				}
+				else
+				{
+					VAST_ASSERTF(rm.GetAllocationInfo(r.texDesc).size <= r.allocInfo.size, "Graph was compiled with invalid memory requirements.");
+					t.texDesc = r.texDesc;
+					t.tex = rm.CreatePlacedTexture(r.texDesc, heap, r.heapOffset, r.name);
+				}
+			}
+		}
+
+		for (uint32 i = 0; i < rg.m_Resources.size(); ++i)
+		{
+			RGResource& r = rg.m_Resources[i];
+			if (r.IsTransient() && r.IsUsed())
+			{
+				r.buf = m_TransientResources[i].buf;
+				r.tex = m_TransientResources[i].tex;
+			}
+		}
+	}
+
+	void RenderGraphExecutor::ReleaseTransientResources()
+	{
+		GPUResourceManager& rm = ctx.GetGPUResourceManager();
+
+		for (auto& t : m_TransientResources)
+		{
+			if (t.buf.IsValid())
+			{
+				rm.DestroyBuffer(t.buf);
+			}
+			if (t.tex.IsValid())
+			{
+				rm.DestroyTexture(t.tex);
+			}
+		}
+		m_TransientResources.clear();
+	}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Graphics/RenderGraph.h"
+
+namespace vast
+{
+	class GraphicsContext;
+
+	// Turns a compiled RenderGraph into GPU work. Transient resources are realized as placed resources
+	// in a single memory heap (or one per kind of resource, on devices that can't mix them) following
+	// the placement computed by the graph, and are kept alive across frames for as long as the
+	// placement doesn't change.
+	class RenderGraphExecutor
+	{
+	public:
+		RenderGraphExecutor(GraphicsContext& ctx);
+		~RenderGraphExecutor();
+
+		// Compiles the graph (if not compiled already) using the device memory requirements, then 
+		// records every pass that survived culling, issuing its barriers right before it executes.
+		void Execute(RenderGraph& rg);
+
+	private:
+		struct TransientResource
+		{
+			RGResourceType type = RGResourceType::TEXTURE;
+			BufferDesc bufDesc = {};
+			TextureDesc texDesc = {};
+			MemoryHeapType heapType = MemoryHeapType::MIXED;
+			uint64 heapOffset = 0;
+			BufferHandle buf;
+			TextureHandle tex;
+		};
+
+		bool IsTransientResourceReusable(const TransientResource& t, const RGResource& r) const;
+		void RealizeTransientResources(RenderGraph& rg);
+		void ReleaseTransientResources();
+
+		GraphicsContext& ctx;
+
+		// Indexed by MemoryHeapType.
+		Array<MemoryHeapHandle, IDX(MemoryHeapType::COUNT)> m_TransientHeaps;
+		Array<uint64, IDX(MemoryHeapType::COUNT)> m_TransientHeapSizes;
+		// Indexed by resource index in the graph.
+		Vector<TransientResource> m_TransientResources;
+	};
+
+}
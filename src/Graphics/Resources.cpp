@@ -117,4 +117,113 @@ namespace vast
 		return AllocShaderDesc(ShaderType::PIXEL, shaderName, filePath, entryPoint);
 	}
 
+	ShaderKey MakeShaderKey(const ShaderDesc& desc)
+	{
+		const ShaderKey key = MakeShaderKey(desc.shaderName, desc.entryPoint);
+		if (desc.permutationDomain.IsEmpty())
+			return key;
+
+		// Note: Axes are hashed too, so that changing them doesn't reuse permutations of the old ones.
+		Hasher hasher;
+		hasher.Add(key);
+		for (const auto& axis : desc.permutationDomain.GetAxes())
+		{
+			hasher.Add(axis.define);
+			hasher.Add(axis.numValues);
+		}
+		hasher.Add(desc.permutation);
+		return hasher.Get();
+	}
+
+	PipelineDesc CanonicalizePipelineDesc(const PipelineDesc& desc)
+	{
+		PipelineDesc c = desc;
+
+		for (ShaderDesc* shader : { &c.vs, &c.ps })
+		{
+			if (shader->type == ShaderType::UNKNOWN)
+			{
+				*shader = ShaderDesc{};
+			}
+		}
+
+		// Note: Independent blending isn't supported, so only the first blend state is used.
+		for (uint32 i = 1; i < MAX_RENDERTARGETS; ++i)
+		{
+			c.blendStates[i] = BlendState{};
+		}
+		if (!c.blendStates[0].blendEnable)
+		{
+			c.blendStates[0] = BlendState{ .blendEnable = false, .writeMask = c.blendStates[0].writeMask };
+		}
+
+		if (!c.depthStencilState.depthEnable)
+		{
+			c.depthStencilState = DepthStencilState::Preset::kDisabled;
+		}
+
+		// Render targets are bound up to the first unused slot.
+		bool bIsUnused = false;
+		for (auto& format : c.renderPassLayout.rtFormats)
+		{
+			bIsUnused |= (format == TexFormat::UNKNOWN);
+			if (bIsUnused)
+			{
+				format = TexFormat::UNKNOWN;
+			}
+		}
+
+		return c;
+	}
+
+	static void HashShaderDesc(Hasher& hasher, const ShaderDesc& desc)
+	{
+		// Note: Shaders are identified by name, entry point and permutation only, same as when they
+		// are loaded.
+		hasher.Add(desc.type);
+		if (desc.type != ShaderType::UNKNOWN)
+		{
+			hasher.Add(MakeShaderKey(desc));
+		}
+	}
+
+	PipelineKey MakePipelineKey(const PipelineDesc& desc)
+	{
+		const PipelineDesc c = CanonicalizePipelineDesc(desc);
+
+		// Note: Fields are hashed one by one, since struct padding bytes are undefined.
+		Hasher hasher;
+		HashShaderDesc(hasher, c.vs);
+		HashShaderDesc(hasher, c.ps);
+		for (const auto& blend : c.blendStates)
+		{
+			hasher.Add(blend.blendEnable);
+			hasher.Add(blend.srcBlend);
+			hasher.Add(blend.dstBlend);
+			hasher.Add(blend.blendOp);
+			hasher.Add(blend.srcBlendAlpha);
+			hasher.Add(blend.dstBlendAlpha);
+			hasher.Add(blend.blendOpAlpha);
+			hasher.Add(blend.writeMask);
+		}
+		hasher.Add(c.depthStencilState.depthEnable);
+		hasher.Add(c.depthStencilState.depthWrite);
+		hasher.Add(c.depthStencilState.depthFunc);
+		hasher.Add(c.rasterizerState.fillMode);
+		hasher.Add(c.rasterizerState.cullMode);
+		for (const auto& format : c.renderPassLayout.rtFormats)
+		{
+			hasher.Add(format);
+		}
+		hasher.Add(c.renderPassLayout.dsFormat);
+		return hasher.Get();
+	}
+
+	PipelineKey MakePipelineKey(const ShaderDesc& desc)
+	{
+		Hasher hasher;
+		HashShaderDesc(hasher, desc);
+		return hasher.Get();
+	}
+
 }
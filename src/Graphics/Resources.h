@@ -2,6 +2,8 @@
 
 #include "Graphics/Handles.h"
 #include "Graphics/GraphicsTypes.h"
+#include "Graphics/ShaderPermutation.h"
+#include "Core/Hash.h"
 
 namespace vast
 {
@@ -10,10 +12,12 @@ namespace vast
 	class Buffer {};
 	class Texture {};
 	class Pipeline {};
+	class MemoryHeap {};
 
 	using BufferHandle = Handle<Buffer>;
 	using TextureHandle = Handle<Texture>;
 	using PipelineHandle = Handle<Pipeline>;
+	using MemoryHeapHandle = Handle<MemoryHeap>;
 
 	// - Resource Descriptors --------------------------------------------------------------------- //
 
@@ -55,14 +59,46 @@ namespace vast
 	TextureDesc AllocRenderTargetDesc(TexFormat format, uint2 dimensions, float4 clear = DEFAULT_CLEAR_COLOR_VALUE);
 	TextureDesc AllocDepthStencilTargetDesc(TexFormat format, uint2 dimensions, ClearDepthStencil clear = { DEFAULT_CLEAR_DEPTH_VALUE, 0 });
 
+	// Memory requirements of a resource placed inside a MemoryHeap.
+	struct ResourceAllocationInfo
+	{
+		uint64 size = 0;
+		uint64 alignment = 0;
+	};
+
 	struct ShaderDesc
 	{
 		ShaderType type = ShaderType::UNKNOWN;
 		std::string filePath = VAST_SHADERS_SOURCE_PATH;
 		std::string shaderName = "";
 		std::string entryPoint = "";
+		// Permutation axes declared by the shader, and the permutation to compile (see ShaderPermutation.h).
+		ShaderPermutationDomain permutationDomain = {};
+		ShaderPermutationKey permutation = 0;
 	};
 
+	// Identifies a shader by its file name and entry point. File names are compared
+	// case-insensitively, since the filesystems shaders are loaded from are too. Keys can be
+	// computed at compile time for literals, e.g. constexpr ShaderKey k = MakeShaderKey("Imgui.hlsl", "VS_Main").
+	using ShaderKey = uint64;
+
+	constexpr ShaderKey MakeShaderKey(std::string_view shaderName, std::string_view entryPoint)
+	{
+		uint64 h = HASH_OFFSET_BASIS;
+		for (char c : shaderName)
+		{
+			h = (h ^ static_cast<uint8>((c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c)) * HASH_PRIME;
+		}
+		// Note: Names can't contain a null character, so separating them with one keeps different
+		// splits of the same characters from colliding.
+		h = (h ^ 0) * HASH_PRIME;
+		return HashString(entryPoint, h);
+	}
+
+	// Same as above, but also identifies the permutation of shaders that declare permutation axes.
+	// Shaders without any share the key of their file name and entry point.
+	ShaderKey MakeShaderKey(const ShaderDesc& desc);
+
 	ShaderDesc AllocComputeShaderDesc(const char* shaderName, const char* filePath = VAST_SHADERS_SOURCE_PATH, const char* entryPoint = "CS_Main");
 	ShaderDesc AllocVertexShaderDesc(const char* shaderName, const char* filePath = VAST_SHADERS_SOURCE_PATH, const char* entryPoint = "VS_Main");
 	ShaderDesc AllocPixelShaderDesc(const char* shaderName, const char* filePath = VAST_SHADERS_SOURCE_PATH, const char* entryPoint = "PS_Main");
@@ -128,6 +164,16 @@ namespace vast
 		RenderPassLayout renderPassLayout = {};
 	};
 
+	// Identifies a pipeline by the state it creates, so that identical pipelines can be shared.
+	using PipelineKey = uint64;
+
+	// Returns a copy of the description with any state that doesn't affect the created pipeline
+	// reset to defaults (e.g. depth function with depth testing disabled), so that equivalent
+	// descriptions compare and hash the same.
+	PipelineDesc CanonicalizePipelineDesc(const PipelineDesc& desc);
+	PipelineKey MakePipelineKey(const PipelineDesc& desc);
+	PipelineKey MakePipelineKey(const ShaderDesc& desc);
+
 	struct RenderTargetDesc
 	{
 		TextureHandle h;
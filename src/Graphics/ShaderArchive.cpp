@@ -0,0 +1,218 @@
+#include "vastpch.h"
+#include "Graphics/ShaderArchive.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vast
+{
+	static constexpr uint32 SHADER_ARCHIVE_MAGIC = 0x41485356; // 'VSHA'
+	// Note: Bump when the file layout or the shader key computation changes.
+	static constexpr uint32 SHADER_ARCHIVE_VERSION = 2;
+	// Alignment of each bytecode and reflection blob within the file.
+	static constexpr uint64 SHADER_ARCHIVE_DATA_ALIGNMENT = 16;
+
+	struct ShaderArchiveHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 numShaders;
+		uint32 reserved;
+		uint64 fileSize;
+	};
+
+	struct ShaderArchiveTocEntry
+	{
+		ShaderKey key;
+		uint64 bytecodeOffset;
+		uint64 reflectionOffset;
+		uint32 bytecodeSize;
+		uint32 reflectionSize;
+		uint32 type;
+		uint32 reserved;
+	};
+
+	static_assert(sizeof(ShaderArchiveHeader) == 24 && sizeof(ShaderArchiveTocEntry) == 40, "Shader archive layout changed, bump SHADER_ARCHIVE_VERSION.");
+
+	ShaderArchive::ShaderArchive()
+		: m_File()
+		, m_Toc(nullptr)
+		, m_NumShaders(0)
+	{
+	}
+
+	bool ShaderArchive::Open(const std::string& filePath)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		Close();
+		if (!m_File.Open(filePath))
+			return false;
+
+		const uint8* data = m_File.GetData();
+		const uint64 size = m_File.GetSize();
+
+		ShaderArchiveHeader header = {};
+		bool bIsValid = size >= sizeof(header);
+		if (bIsValid)
+		{
+			memcpy(&header, data, sizeof(header));
+			bIsValid = header.magic == SHADER_ARCHIVE_MAGIC
+				&& header.version == SHADER_ARCHIVE_VERSION
+				&& header.fileSize == size
+				&& sizeof(header) + static_cast<uint64>(header.numShaders) * sizeof(ShaderArchiveTocEntry) <= size;
+		}
+
+		// Note: Only the layout is validated here. Hashing the contents would touch every page of the
+		// mapping, most of which may never be needed.
+		const ShaderArchiveTocEntry* toc = reinterpret_cast<const ShaderArchiveTocEntry*>(data + sizeof(header));
+		for (uint32 i = 0; bIsValid && i < header.numShaders; ++i)
+		{
+			const ShaderArchiveTocEntry& e = toc[i];
+			bIsValid = e.bytecodeSize > 0
+				&& e.bytecodeOffset + e.bytecodeSize <= size
+				&& e.reflectionOffset + e.reflectionSize <= size
+				&& (i == 0 || toc[i - 1].key < e.key);
+		}
+
+		if (!bIsValid)
+		{
+			VAST_LOG_WARNING("[resource] [shader] '{}' is not a valid shader archive.", filePath);
+			Close();
+			return false;
+		}
+
+		m_Toc = toc;
+		m_NumShaders = header.numShaders;
+		VAST_LOG_INFO("[resource] [shader] Mapped shader archive '{}' with {} shaders.", filePath, m_NumShaders);
+		return true;
+	}
+
+	void ShaderArchive::Close()
+	{
+		m_File.Close();
+		m_Toc = nullptr;
+		m_NumShaders = 0;
+	}
+
+	bool ShaderArchive::IsOpen() const
+	{
+		return m_File.IsOpen();
+	}
+
+	bool ShaderArchive::FindShader(const std::string& shaderName, const std::string& entryPoint, ShaderArchiveEntry& outEntry) const
+	{
+		return FindShader(MakeShaderKey(shaderName, entryPoint), outEntry);
+	}
+
+	bool ShaderArchive::FindShader(ShaderKey key, ShaderArchiveEntry& outEntry) const
+	{
+		if (!IsOpen())
+			return false;
+
+		const ShaderArchiveTocEntry* end = m_Toc + m_NumShaders;
+		const ShaderArchiveTocEntry* it = std::lower_bound(m_Toc, end, key, [](const ShaderArchiveTocEntry& e, uint64 k) { return e.key < k; });
+		if (it == end || it->key != key)
+			return false;
+
+		const uint8* data = m_File.GetData();
+		outEntry.type = static_cast<ShaderType>(it->type);
+		outEntry.bytecode = data + it->bytecodeOffset;
+		outEntry.bytecodeSize = it->bytecodeSize;
+		outEntry.reflection = it->reflectionSize ? data + it->reflectionOffset : nullptr;
+		outEntry.reflectionSize = it->reflectionSize;
+		return true;
+	}
+
+	uint32 ShaderArchive::GetNumShaders() const
+	{
+		return m_NumShaders;
+	}
+
+	//
+
+	bool ShaderArchiveWriter::AddShader(const std::string& shaderName, const std::string& entryPoint, ShaderType type,
+		const void* bytecode, size_t bytecodeSize, const void* reflection, size_t reflectionSize)
+	{
+		VAST_ASSERT(bytecode && bytecodeSize);
+
+		const ShaderKey key = MakeShaderKey(shaderName, entryPoint);
+		for (const auto& shader : m_Shaders)
+		{
+			if (shader.key == key)
+				return false;
+		}
+
+		PendingShader shader;
+		shader.key = key;
+		shader.type = type;
+		shader.bytecode.assign(static_cast<const uint8*>(bytecode), static_cast<const uint8*>(bytecode) + bytecodeSize);
+		if (reflectionSize > 0)
+		{
+			shader.reflection.assign(static_cast<const uint8*>(reflection), static_cast<const uint8*>(reflection) + reflectionSize);
+		}
+		m_Shaders.push_back(std::move(shader));
+		return true;
+	}
+
+	bool ShaderArchiveWriter::Write(const std::string& filePath) const
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		Vector<const PendingShader*> sorted;
+		for (const auto& shader : m_Shaders)
+		{
+			sorted.push_back(&shader);
+		}
+		std::sort(sorted.begin(), sorted.end(), [](const PendingShader* a, const PendingShader* b) { return a->key < b->key; });
+
+		const uint32 numShaders = static_cast<uint32>(sorted.size());
+		Vector<ShaderArchiveTocEntry> toc(numShaders);
+
+		uint64 offset = sizeof(ShaderArchiveHeader) + numShaders * sizeof(ShaderArchiveTocEntry);
+		auto AllocData = [&offset](size_t size)
+		{
+			offset = AlignU64(offset, SHADER_ARCHIVE_DATA_ALIGNMENT);
+			const uint64 dataOffset = offset;
+			offset += size;
+			return dataOffset;
+		};
+
+		for (uint32 i = 0; i < numShaders; ++i)
+		{
+			const PendingShader& shader = *sorted[i];
+			ShaderArchiveTocEntry& e = toc[i];
+			e = {};
+			e.key = shader.key;
+			e.type = static_cast<uint32>(shader.type);
+			e.bytecodeSize = static_cast<uint32>(shader.bytecode.size());
+			e.bytecodeOffset = AllocData(shader.bytecode.size());
+			e.reflectionSize = static_cast<uint32>(shader.reflection.size());
+			e.reflectionOffset = AllocData(shader.reflection.size());
+		}
+
+		ShaderArchiveHeader header = {};
+		header.magic = SHADER_ARCHIVE_MAGIC;
+		header.version = SHADER_ARCHIVE_VERSION;
+		header.numShaders = numShaders;
+		header.fileSize = offset;
+
+		Vector<uint8> data(offset, 0);
+		memcpy(data.data(), &header, sizeof(header));
+		if (numShaders > 0)
+		{
+			memcpy(data.data() + sizeof(header), toc.data(), numShaders * sizeof(ShaderArchiveTocEntry));
+		}
+		for (uint32 i = 0; i < numShaders; ++i)
+		{
+			memcpy(data.data() + toc[i].bytecodeOffset, sorted[i]->bytecode.data(), sorted[i]->bytecode.size());
+			if (!sorted[i]->reflection.empty())
+			{
+				memcpy(data.data() + toc[i].reflectionOffset, sorted[i]->reflection.data(), sorted[i]->reflection.size());
+			}
+		}
+
+		return Filesystem::WriteFile(filePath, data.data(), data.size());
+	}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Graphics/Resources.h"
+
+// ======================================== SHADER ARCHIVE ========================================
+//
+// Single file packing precompiled shaders (bytecode plus the compiler's reflection data) for a set of shader
+// source files and entry points. Archives are produced offline by the shadercompiler tool, and are
+// memory-mapped at runtime so that shaders found in them don't need to be compiled at all.
+//
+// Shaders are looked up by their ShaderKey (file name and entry point). The table of contents is
+// sorted by key, and the data of each shader is stored contiguously and aligned, so it can be
+// handed to the graphics API straight from the mapped memory.
+//
+// Archives are a snapshot of the shader sources at the time they were built, and are not checked
+// against them at runtime. Shader reloads always compile from source.
+//
+// ================================================================================================
+
+namespace vast
+{
+	struct ShaderArchiveEntry
+	{
+		ShaderType type = ShaderType::UNKNOWN;
+		const uint8* bytecode = nullptr;
+		uint32 bytecodeSize = 0;
+		const uint8* reflection = nullptr;
+		uint32 reflectionSize = 0;
+	};
+
+	struct ShaderArchiveTocEntry;
+
+	class ShaderArchive
+	{
+	public:
+		ShaderArchive();
+
+		// Maps the archive into memory and validates its layout. Returns false if the file doesn't
+		// exist or isn't a valid archive.
+		bool Open(const std::string& filePath);
+		void Close();
+		bool IsOpen() const;
+
+		// Returned pointers remain valid until the archive is closed.
+		bool FindShader(const std::string& shaderName, const std::string& entryPoint, ShaderArchiveEntry& outEntry) const;
+		bool FindShader(ShaderKey key, ShaderArchiveEntry& outEntry) const;
+		uint32 GetNumShaders() const;
+
+	private:
+		Filesystem::MappedFile m_File;
+		const ShaderArchiveTocEntry* m_Toc;
+		uint32 m_NumShaders;
+	};
+
+	class ShaderArchiveWriter
+	{
+	public:
+		// Returns false if a shader with the same key has already been added.
+		bool AddShader(const std::string& shaderName, const std::string& entryPoint, ShaderType type,
+			const void* bytecode, size_t bytecodeSize, const void* reflection, size_t reflectionSize);
+
+		bool Write(const std::string& filePath) const;
+		uint32 GetNumShaders() const { return static_cast<uint32>(m_Shaders.size()); }
+
+	private:
+		struct PendingShader
+		{
+			ShaderKey key;
+			ShaderType type;
+			Vector<uint8> bytecode;
+			Vector<uint8> reflection;
+		};
+		Vector<PendingShader> m_Shaders;
+	};
+
+}
@@ -0,0 +1,242 @@
+#include "vastpch.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/ShaderFileCache.h"
+
+#include "Core/Filesystem.h"
+#include "Core/Hash.h"
+
+#include <cstring>
+#include <filesystem>
+#include <unordered_set>
+
+namespace vast
+{
+	static constexpr uint32 SHADER_CACHE_MAGIC = 0x43485356; // 'VSHC'
+	// Note: Bump when the file layout, the key computation or the reflection format changes.
+	static constexpr uint32 SHADER_CACHE_VERSION = 4;
+
+	struct ShaderCacheFileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint64 key;
+		uint64 payloadHash;
+		uint32 bytecodeSize;
+		uint32 reflectionSize;
+	};
+
+	ShaderCache::ShaderCache(const std::string& cacheDirectory)
+		: m_CacheDirectory(cacheDirectory)
+		, m_bIsEnabled(false)
+		, m_NumHits(0)
+		, m_NumMisses(0)
+		, m_NumRejected(0)
+		, m_NumStores(0)
+	{
+		m_bIsEnabled = Filesystem::CreateDirectories(m_CacheDirectory);
+		if (!m_bIsEnabled)
+		{
+			VAST_LOG_WARNING("[resource] [shader] Failed to create shader cache directory '{}'. Shader cache is disabled.", m_CacheDirectory);
+		}
+	}
+
+	bool ShaderCache::Load(uint64 key, ShaderCacheEntry& outEntry)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		if (!m_bIsEnabled)
+			return false;
+
+		Vector<uint8> data;
+		if (!Filesystem::ReadFile(GetEntryPath(key), data))
+		{
+			m_NumMisses++;
+			return false;
+		}
+
+		ShaderCacheFileHeader header = {};
+		bool bIsValid = data.size() >= sizeof(header);
+		if (bIsValid)
+		{
+			memcpy(&header, data.data(), sizeof(header));
+			const uint8* payload = data.data() + sizeof(header);
+			const size_t payloadSize = data.size() - sizeof(header);
+
+			bIsValid = header.magic == SHADER_CACHE_MAGIC
+				&& header.version == SHADER_CACHE_VERSION
+				&& header.key == key
+				&& static_cast<size_t>(header.bytecodeSize) + header.reflectionSize == payloadSize
+				&& header.bytecodeSize > 0
+				&& HashBytes(payload, payloadSize) == header.payloadHash;
+
+			if (bIsValid)
+			{
+				outEntry.bytecode.assign(payload, payload + header.bytecodeSize);
+				outEntry.reflection.assign(payload + header.bytecodeSize, payload + payloadSize);
+			}
+		}
+
+		if (!bIsValid)
+		{
+			VAST_LOG_WARNING("[resource] [shader] Discarding invalid shader cache entry '{}'.", GetEntryPath(key));
+			m_NumRejected++;
+			m_NumMisses++;
+			return false;
+		}
+
+		m_NumHits++;
+		return true;
+	}
+
+	bool ShaderCache::Store(uint64 key, const void* bytecode, size_t bytecodeSize, const void* reflection, size_t reflectionSize)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+		VAST_ASSERT(bytecode && bytecodeSize);
+
+		if (!m_bIsEnabled)
+			return false;
+
+		Vector<uint8> data(sizeof(ShaderCacheFileHeader) + bytecodeSize + reflectionSize);
+		uint8* payload = data.data() + sizeof(ShaderCacheFileHeader);
+		memcpy(payload, bytecode, bytecodeSize);
+		if (reflectionSize > 0)
+		{
+			memcpy(payload + bytecodeSize, reflection, reflectionSize);
+		}
+
+		ShaderCacheFileHeader header = {};
+		header.magic = SHADER_CACHE_MAGIC;
+		header.version = SHADER_CACHE_VERSION;
+		header.key = key;
+		header.payloadHash = HashBytes(payload, bytecodeSize + reflectionSize);
+		header.bytecodeSize = static_cast<uint32>(bytecodeSize);
+		header.reflectionSize = static_cast<uint32>(reflectionSize);
+		memcpy(data.data(), &header, sizeof(header));
+
+		if (!Filesystem::WriteFile(GetEntryPath(key), data.data(), data.size()))
+		{
+			VAST_LOG_WARNING("[resource] [shader] Failed to write shader cache entry '{}'.", GetEntryPath(key));
+			return false;
+		}
+
+		m_NumStores++;
+		return true;
+	}
+
+	ShaderCacheStats ShaderCache::GetStats() const
+	{
+		ShaderCacheStats stats;
+		stats.numHits = m_NumHits;
+		stats.numMisses = m_NumMisses;
+		stats.numRejected = m_NumRejected;
+		stats.numStores = m_NumStores;
+		return stats;
+	}
+
+	std::string ShaderCache::GetEntryPath(uint64 key) const
+	{
+		char fileName[32];
+		snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(m_CacheDirectory) / fileName).string();
+	}
+
+	//
+
+	// Calls 'f' with the path of each visited include and its file, or with an empty path and a null
+	// file for includes that couldn't be resolved.
+	template<typename F>
+	static void VisitShaderIncludes(const std::filesystem::path& filePath, const ShaderFile& source, const Vector<std::wstring>& includeDirectories,
+		ShaderFileCache& fileCache, std::unordered_set<std::string>& visited, F&& f)
+	{
+		for (const auto& includeName : source.includes)
+		{
+			std::filesystem::path resolved = (filePath.parent_path() / includeName).lexically_normal();
+			Ref<const ShaderFile> includeFile = fileCache.GetFile(resolved.string());
+			for (uint32 i = 0; !includeFile && i < includeDirectories.size(); ++i)
+			{
+				resolved = (std::filesystem::path(includeDirectories[i]) / includeName).lexically_normal();
+				includeFile = fileCache.GetFile(resolved.string());
+			}
+
+			if (!includeFile)
+			{
+				f(std::string(), includeName, nullptr);
+				continue;
+			}
+
+			const std::string resolvedPath = resolved.string();
+			if (!visited.insert(resolvedPath).second)
+				continue;
+
+			f(resolvedPath, includeName, includeFile.get());
+			VisitShaderIncludes(resolved, *includeFile, includeDirectories, fileCache, visited, f);
+		}
+	}
+
+	Vector<std::string> CollectShaderIncludes(const std::string& sourcePath, const Vector<std::wstring>& includeDirectories, ShaderFileCache& fileCache)
+	{
+		Vector<std::string> includes;
+
+		Ref<const ShaderFile> source = fileCache.GetFile(sourcePath);
+		if (!source)
+			return includes;
+
+		std::unordered_set<std::string> visited;
+		visited.insert(std::filesystem::path(sourcePath).lexically_normal().string());
+		VisitShaderIncludes(std::filesystem::path(sourcePath), *source, includeDirectories, fileCache, visited,
+			[&includes](const std::string& path, const std::string&, const ShaderFile*)
+			{
+				if (!path.empty())
+				{
+					includes.push_back(path);
+				}
+			});
+
+		return includes;
+	}
+
+	bool ComputeShaderCacheKey(const std::string& sourcePath, const Vector<std::wstring>& includeDirectories, ShaderFileCache& fileCache,
+		const Vector<std::wstring>& compilerArgs, const std::string& compilerVersion, uint64& outKey)
+	{
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		Ref<const ShaderFile> source = fileCache.GetFile(sourcePath);
+		if (!source)
+			return false;
+
+		// Note: Files are hashed by the hash of their contents, which the file cache computes once.
+		Hasher h;
+		h.Add(SHADER_CACHE_VERSION);
+		h.Add(compilerVersion);
+		for (uint32 i = 0; i < compilerArgs.size(); ++i)
+		{
+			if (compilerArgs[i].rfind(L"-I", 0) == 0)
+			{
+				// Skip the directory too when passed as a separate argument.
+				if (compilerArgs[i].size() == 2)
+				{
+					++i;
+				}
+				continue;
+			}
+			h.Add(compilerArgs[i]);
+		}
+		h.Add(source->hash);
+
+		// Note: Includes are hashed by name and contents rather than by resolved path, so the key
+		// doesn't depend on where the project is located on disk.
+		std::unordered_set<std::string> visited;
+		visited.insert(std::filesystem::path(sourcePath).lexically_normal().string());
+		VisitShaderIncludes(std::filesystem::path(sourcePath), *source, includeDirectories, fileCache, visited,
+			[&h](const std::string& path, const std::string& includeName, const ShaderFile* includeFile)
+			{
+				h.Add(includeName);
+				h.Add(!path.empty());
+				h.Add(includeFile ? includeFile->hash : 0);
+			});
+
+		outKey = h.Get();
+		return true;
+	}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Core/Types.h"
+
+#include <atomic>
+
+// ======================================== SHADER CACHE ==========================================
+//
+// Persistent on-disk cache of compiled shader bytecode and serialized shader reflection (see
+// ShaderReflection.h), so that warm starts don't need to invoke the shader compiler at all.
+//
+// Entries are keyed by a hash of everything that can affect the compiled output: the contents of
+// the shader source and of every file it includes (transitively), plus the compiler arguments
+// (entry point, target, defines, optimization flags) and the compiler version. Any change to these
+// produces a different key, so stale entries are never returned and don't need to be explicitly
+// invalidated. Include directories are left out of the key, since they are absolute paths and
+// only affect which files get included, which are already hashed by name and contents. This keeps
+// keys stable across checkouts of the project in different locations.
+//
+// Each entry is stored in its own file, with a header that is validated on load (format version,
+// key and a hash of the payload). Entries that fail validation (e.g. truncated writes) are treated
+// as misses and get overwritten on the next store.
+//
+// Load and Store can be called concurrently from multiple threads.
+//
+// The cache has no dependencies on the graphics backend or the shader compiler.
+//
+// ================================================================================================
+
+namespace vast
+{
+	class ShaderFileCache;
+
+	struct ShaderCacheEntry
+	{
+		Vector<uint8> bytecode;
+		// Serialized ShaderReflection.
+		Vector<uint8> reflection;
+	};
+
+	struct ShaderCacheStats
+	{
+		uint32 numHits = 0;
+		uint32 numMisses = 0;
+		// Entries found on disk that failed validation.
+		uint32 numRejected = 0;
+		uint32 numStores = 0;
+	};
+
+	class ShaderCache
+	{
+	public:
+		ShaderCache(const std::string& cacheDirectory);
+
+		bool Load(uint64 key, ShaderCacheEntry& outEntry);
+		bool Store(uint64 key, const void* bytecode, size_t bytecodeSize, const void* reflection, size_t reflectionSize);
+
+		std::string GetEntryPath(uint64 key) const;
+		bool IsEnabled() const { return m_bIsEnabled; }
+		ShaderCacheStats GetStats() const;
+
+	private:
+		std::string m_CacheDirectory;
+		bool m_bIsEnabled;
+		std::atomic<uint32> m_NumHits;
+		std::atomic<uint32> m_NumMisses;
+		std::atomic<uint32> m_NumRejected;
+		std::atomic<uint32> m_NumStores;
+	};
+
+	// Returns the paths of all files included by the given shader source, recursively and without
+	// duplicates. Includes are resolved relative to the including file first, and then to each of
+	// the include directories in order. Preprocessor conditions are not evaluated, so includes in
+	// inactive branches are also returned.
+	Vector<std::string> CollectShaderIncludes(const std::string& sourcePath, const Vector<std::wstring>& includeDirectories, ShaderFileCache& fileCache);
+
+	// Returns false if the source file can't be read. Include directory arguments ('-I <dir>' or
+	// '-I<dir>') in 'compilerArgs' are ignored.
+	bool ComputeShaderCacheKey(const std::string& sourcePath, const Vector<std::wstring>& includeDirectories, ShaderFileCache& fileCache,
+		const Vector<std::wstring>& compilerArgs, const std::string& compilerVersion, uint64& outKey);
+
+}
@@ -0,0 +1,95 @@
+#include "vastpch.h"
+#include "Graphics/ShaderFileCache.h"
+
+#include "Core/Filesystem.h"
+#include "Core/Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace vast
+{
+	// Returns the names of all files included by the source, in order of appearance.
+	static Vector<std::string> ParseIncludeDirectives(const Vector<uint8>& source)
+	{
+		Vector<std::string> includes;
+
+		const char* p = reinterpret_cast<const char*>(source.data());
+		const char* end = p + source.size();
+		while (p < end)
+		{
+			const char* lineEnd = std::find(p, end, '\n');
+
+			const char* c = p;
+			auto SkipSpaces = [&]() { while (c < lineEnd && (*c == ' ' || *c == '\t')) ++c; };
+			SkipSpaces();
+			if (c < lineEnd && *c == '#')
+			{
+				++c;
+				SkipSpaces();
+				static constexpr char kInclude[] = "include";
+				const size_t includeLen = sizeof(kInclude) - 1;
+				if (static_cast<size_t>(lineEnd - c) > includeLen && strncmp(c, kInclude, includeLen) == 0)
+				{
+					c += includeLen;
+					SkipSpaces();
+					if (c < lineEnd && (*c == '"' || *c == '<'))
+					{
+						const char closing = (*c == '"') ? '"' : '>';
+						const char* nameBegin = ++c;
+						const char* nameEnd = std::find(nameBegin, lineEnd, closing);
+						if (nameEnd != lineEnd && nameEnd != nameBegin)
+						{
+							includes.emplace_back(nameBegin, nameEnd);
+						}
+					}
+				}
+			}
+
+			p = lineEnd + 1;
+		}
+
+		return includes;
+	}
+
+	Ref<const ShaderFile> ShaderFileCache::GetFile(const std::string& filePath)
+	{
+		const std::string path = std::filesystem::path(filePath).lexically_normal().string();
+		// Note: The write time is checked before reading, so a file modified while being read is
+		// read again on the next access.
+		const int64 lastWriteTime = Filesystem::GetLastWriteTime(path);
+		if (lastWriteTime == INT64_MIN)
+			return nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			auto it = m_Files.find(path);
+			if (it != m_Files.end() && it->second.lastWriteTime == lastWriteTime)
+			{
+				m_Stats.numHits++;
+				return it->second.file;
+			}
+		}
+
+		// Note: Reading happens outside of the lock, so threads racing to read the same file may
+		// each read it.
+		auto file = MakeRef<ShaderFile>();
+		if (!Filesystem::ReadFile(path, file->contents))
+			return nullptr;
+		file->hash = HashBytes(file->contents.data(), file->contents.size());
+		file->includes = ParseIncludeDirectives(file->contents);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Files[path] = CachedFile{ file, lastWriteTime };
+		m_Stats.numReads++;
+		return file;
+	}
+
+	ShaderFileCacheStats ShaderFileCache::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Stats;
+	}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Core/Types.h"
+
+#include <mutex>
+#include <unordered_map>
+
+// ====================================== SHADER FILE CACHE =======================================
+//
+// In-memory cache of shader source and include files, shared by everything that reads them while
+// compiling shaders: the compiler's include handler, include dependency tracking and shader cache
+// key computation. Headers shared by many shaders are read from disk and parsed once, instead of
+// once per shader and per use.
+//
+// Files are invalidated by their last write time, which is checked on every access, so modified
+// files are read again the next time they are requested (e.g. when reloading shaders).
+//
+// Files can be requested concurrently from multiple threads.
+//
+// ================================================================================================
+
+namespace vast
+{
+	struct ShaderFile
+	{
+		Vector<uint8> contents;
+		uint64 hash = 0;
+		// Names in the file's #include directives, in order of appearance.
+		Vector<std::string> includes;
+	};
+
+	struct ShaderFileCacheStats
+	{
+		uint32 numHits = 0;
+		uint32 numReads = 0;
+	};
+
+	class ShaderFileCache
+	{
+	public:
+		// Returns nullptr if the file can't be read. Returned files are never modified, and remain
+		// valid for as long as they are referenced, even after being invalidated.
+		Ref<const ShaderFile> GetFile(const std::string& filePath);
+
+		ShaderFileCacheStats GetStats();
+
+	private:
+		struct CachedFile
+		{
+			Ref<const ShaderFile> file;
+			int64 lastWriteTime;
+		};
+
+		// Keyed by normalized path.
+		std::unordered_map<std::string, CachedFile> m_Files;
+		std::mutex m_Mutex;
+		ShaderFileCacheStats m_Stats;
+	};
+
+}
@@ -0,0 +1,207 @@
+#include "vastpch.h"
+#include "Graphics/ShaderPermutation.h"
+#include "Graphics/Resources.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+namespace vast
+{
+	ShaderPermutationDomain::ShaderPermutationDomain(std::initializer_list<ShaderPermutationAxis> axes)
+		: m_Axes(axes)
+		, m_AxisOffsets({})
+	{
+		ComputeAxisOffsets();
+	}
+
+	ShaderPermutationDomain::ShaderPermutationDomain(const Vector<ShaderPermutationAxis>& axes)
+		: m_Axes(axes)
+		, m_AxisOffsets({})
+	{
+		ComputeAxisOffsets();
+	}
+
+	void ShaderPermutationDomain::ComputeAxisOffsets()
+	{
+		uint32 offset = 0;
+		m_AxisOffsets.reserve(m_Axes.size() + 1);
+		for (const auto& axis : m_Axes)
+		{
+			VAST_ASSERTF(axis.numValues >= 2, "Shader permutation axis '{}' must have at least 2 values.", axis.define);
+			VAST_ASSERTF(FindAxis(axis.define) == static_cast<uint32>(&axis - m_Axes.data()), "Shader permutation axis '{}' declared more than once.", axis.define);
+			m_AxisOffsets.push_back(static_cast<uint8>(offset));
+			offset += std::bit_width(axis.numValues - 1);
+		}
+		VAST_ASSERTF(offset <= sizeof(ShaderPermutationKey) * 8, "Too many shader permutation axes to fit in a key.");
+		m_AxisOffsets.push_back(static_cast<uint8>(offset));
+	}
+
+	uint64 ShaderPermutationDomain::GetNumPermutations() const
+	{
+		uint64 numPermutations = 1;
+		for (const auto& axis : m_Axes)
+		{
+			numPermutations *= axis.numValues;
+		}
+		return numPermutations;
+	}
+
+	ShaderPermutationKey ShaderPermutationDomain::Set(ShaderPermutationKey key, const std::string& define, uint32 value) const
+	{
+		const uint32 axisIdx = FindAxis(define);
+		VAST_ASSERTF(axisIdx < m_Axes.size(), "Shader permutation axis '{}' not found.", define);
+		VAST_ASSERTF(value < m_Axes[axisIdx].numValues, "Value {} out of range for shader permutation axis '{}'.", value, define);
+
+		const uint32 offset = m_AxisOffsets[axisIdx];
+		const uint32 mask = static_cast<uint32>(((1ull << (m_AxisOffsets[axisIdx + 1] - offset)) - 1) << offset);
+		return (key & ~mask) | ((value << offset) & mask);
+	}
+
+	uint32 ShaderPermutationDomain::Get(ShaderPermutationKey key, const std::string& define) const
+	{
+		const uint32 axisIdx = FindAxis(define);
+		VAST_ASSERTF(axisIdx < m_Axes.size(), "Shader permutation axis '{}' not found.", define);
+		return GetAxisValue(key, axisIdx);
+	}
+
+	bool ShaderPermutationDomain::IsValid(ShaderPermutationKey key) const
+	{
+		const uint32 numBits = m_AxisOffsets.empty() ? 0 : m_AxisOffsets.back();
+		if (numBits < sizeof(ShaderPermutationKey) * 8 && (key >> numBits) != 0)
+			return false;
+
+		for (uint32 i = 0; i < m_Axes.size(); ++i)
+		{
+			if (GetAxisValue(key, i) >= m_Axes[i].numValues)
+				return false;
+		}
+		return true;
+	}
+
+	Vector<std::string> ShaderPermutationDomain::GetDefines(ShaderPermutationKey key) const
+	{
+		VAST_ASSERT(IsValid(key));
+		Vector<std::string> defines;
+		defines.reserve(m_Axes.size());
+		for (uint32 i = 0; i < m_Axes.size(); ++i)
+		{
+			defines.push_back(m_Axes[i].define + "=" + std::to_string(GetAxisValue(key, i)));
+		}
+		return defines;
+	}
+
+	bool ShaderPermutationDomain::operator==(const ShaderPermutationDomain& other) const
+	{
+		return std::equal(m_Axes.begin(), m_Axes.end(), other.m_Axes.begin(), other.m_Axes.end(),
+			[](const ShaderPermutationAxis& a, const ShaderPermutationAxis& b) { return a.define == b.define && a.numValues == b.numValues; });
+	}
+
+	uint32 ShaderPermutationDomain::FindAxis(const std::string& define) const
+	{
+		for (uint32 i = 0; i < m_Axes.size(); ++i)
+		{
+			if (m_Axes[i].define == define)
+				return i;
+		}
+		return static_cast<uint32>(m_Axes.size());
+	}
+
+	uint32 ShaderPermutationDomain::GetAxisValue(ShaderPermutationKey key, uint32 axisIdx) const
+	{
+		const uint32 offset = m_AxisOffsets[axisIdx];
+		const uint32 numBits = m_AxisOffsets[axisIdx + 1] - offset;
+		return static_cast<uint32>((static_cast<uint64>(key) >> offset) & ((1ull << numBits) - 1));
+	}
+
+	//
+
+	static constexpr const char* SHADER_MANIFEST_HEADER = "# vast shader manifest v1";
+
+	static bool ParseUInt(std::string_view s, uint32& outValue)
+	{
+		const auto result = std::from_chars(s.data(), s.data() + s.size(), outValue);
+		return result.ec == std::errc() && result.ptr == s.data() + s.size();
+	}
+
+	static Vector<std::string_view> SplitString(std::string_view s, char separator)
+	{
+		Vector<std::string_view> parts;
+		size_t begin = 0;
+		while (true)
+		{
+			const size_t end = s.find(separator, begin);
+			parts.push_back(s.substr(begin, end - begin));
+			if (end == std::string_view::npos)
+				break;
+			begin = end + 1;
+		}
+		return parts;
+	}
+
+	std::string SerializeShaderManifest(const Vector<ShaderDesc>& descs)
+	{
+		std::string data = std::string(SHADER_MANIFEST_HEADER) + "\n";
+		for (const auto& desc : descs)
+		{
+			data += std::to_string(static_cast<uint32>(desc.type)) + "\t" + desc.filePath + "\t" + desc.shaderName + "\t"
+				+ desc.entryPoint + "\t" + std::to_string(desc.permutation);
+			for (const auto& axis : desc.permutationDomain.GetAxes())
+			{
+				data += "\t" + axis.define + "=" + std::to_string(axis.numValues);
+			}
+			data += "\n";
+		}
+		return data;
+	}
+
+	Vector<ShaderDesc> ParseShaderManifest(const std::string& data)
+	{
+		Vector<ShaderDesc> descs;
+		const Vector<std::string_view> lines = SplitString(data, '\n');
+		if (lines.empty() || lines[0] != SHADER_MANIFEST_HEADER)
+			return descs;
+
+		for (uint32 i = 1; i < lines.size(); ++i)
+		{
+			const Vector<std::string_view> fields = SplitString(lines[i], '\t');
+			if (fields.size() < 5)
+				continue;
+
+			uint32 type = 0;
+			ShaderDesc desc;
+			if (!ParseUInt(fields[0], type) || type == 0 || type > static_cast<uint32>(ShaderType::PIXEL) || !ParseUInt(fields[4], desc.permutation))
+				continue;
+			desc.type = static_cast<ShaderType>(type);
+			desc.filePath = fields[1];
+			desc.shaderName = fields[2];
+			desc.entryPoint = fields[3];
+
+			Vector<ShaderPermutationAxis> axes;
+			uint32 numBits = 0;
+			bool bIsValid = true;
+			for (uint32 j = 5; j < fields.size() && bIsValid; ++j)
+			{
+				const size_t separator = fields[j].rfind('=');
+				ShaderPermutationAxis axis;
+				bIsValid = separator != std::string_view::npos && separator > 0
+					&& ParseUInt(fields[j].substr(separator + 1), axis.numValues) && axis.numValues >= 2;
+				axis.define = fields[j].substr(0, separator);
+				bIsValid = bIsValid && std::none_of(axes.begin(), axes.end(), [&](const auto& a) { return a.define == axis.define; });
+				numBits += bIsValid ? std::bit_width(axis.numValues - 1) : 0;
+				bIsValid = bIsValid && numBits <= sizeof(ShaderPermutationKey) * 8;
+				axes.push_back(std::move(axis));
+			}
+			if (!bIsValid)
+				continue;
+
+			desc.permutationDomain = ShaderPermutationDomain(axes);
+			if (!desc.permutationDomain.IsValid(desc.permutation))
+				continue;
+
+			descs.push_back(std::move(desc));
+		}
+		return descs;
+	}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Core/Types.h"
+
+// ===================================== SHADER PERMUTATIONS ======================================
+//
+// A shader can declare a set of permutation axes (its permutation domain), each of which is a
+// define that takes one of a fixed number of values: 2 for feature toggles, or N for settings such
+// as quality levels. A permutation selects a value for every axis, and is identified by a key with
+// the values packed into as many bits as each axis needs.
+//
+// Each permutation of a shader is compiled as a separate shader, the first time a pipeline using
+// it is created, so combinations that are never used are never compiled. Permutations used in a
+// run are recorded to a usage manifest, which following runs precompile at startup. Since only
+// permutations that were used get recorded, combinations that stop being used are dropped from it.
+//
+// The manifest is a text file with one shader per line, holding its type, file path, name, entry
+// point, permutation key and permutation axes, separated by tabs.
+//
+// Axis defines are always defined when compiling a shader with a permutation domain, with a value
+// of 0 unless selected otherwise.
+//
+// ================================================================================================
+
+namespace vast
+{
+	struct ShaderDesc;
+
+	using ShaderPermutationKey = uint32;
+
+	struct ShaderPermutationAxis
+	{
+		std::string define;
+		uint32 numValues = 2;
+	};
+
+	class ShaderPermutationDomain
+	{
+	public:
+		ShaderPermutationDomain() = default;
+		ShaderPermutationDomain(std::initializer_list<ShaderPermutationAxis> axes);
+		ShaderPermutationDomain(const Vector<ShaderPermutationAxis>& axes);
+
+		bool IsEmpty() const { return m_Axes.empty(); }
+		const Vector<ShaderPermutationAxis>& GetAxes() const { return m_Axes; }
+		// Total number of combinations of the axes, regardless of which are used.
+		uint64 GetNumPermutations() const;
+
+		// Returns the key with the value of the given axis replaced, e.g.
+		// desc.permutation = domain.Set(desc.permutation, "USE_SHADOWS", 1).
+		ShaderPermutationKey Set(ShaderPermutationKey key, const std::string& define, uint32 value) const;
+		uint32 Get(ShaderPermutationKey key, const std::string& define) const;
+		// Returns false if the key selects an out of range value for any axis, or sets bits that
+		// don't belong to any.
+		bool IsValid(ShaderPermutationKey key) const;
+
+		// Returns a 'DEFINE=value' string for each axis, in the order they were declared.
+		Vector<std::string> GetDefines(ShaderPermutationKey key) const;
+
+		bool operator==(const ShaderPermutationDomain& other) const;
+
+	private:
+		void ComputeAxisOffsets();
+		uint32 FindAxis(const std::string& define) const;
+		uint32 GetAxisValue(ShaderPermutationKey key, uint32 axisIdx) const;
+
+		Vector<ShaderPermutationAxis> m_Axes;
+		// Index of the first bit of each axis in the key, followed by the total number of bits.
+		Vector<uint8> m_AxisOffsets;
+	};
+
+	std::string SerializeShaderManifest(const Vector<ShaderDesc>& descs);
+	// Entries that can't be parsed, or whose permutation isn't valid for its axes, are skipped.
+	Vector<ShaderDesc> ParseShaderManifest(const std::string& data);
+
+}
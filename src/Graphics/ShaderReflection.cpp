@@ -0,0 +1,157 @@
+#include "vastpch.h"
+#include "Graphics/ShaderReflection.h"
+
+#include <cstring>
+
+namespace vast
+{
+	static constexpr uint32 SHADER_REFLECTION_MAGIC = 0x46525356; // 'VSRF'
+	// Note: Bump when the serialized layout changes.
+	static constexpr uint32 SHADER_REFLECTION_VERSION = 1;
+
+	static bool operator==(const ShaderInputParameter& a, const ShaderInputParameter& b)
+	{
+		return a.semanticName == b.semanticName && a.semanticIndex == b.semanticIndex
+			&& a.componentType == b.componentType && a.mask == b.mask;
+	}
+
+	static bool operator==(const ShaderResourceBinding& a, const ShaderResourceBinding& b)
+	{
+		return a.name == b.name && a.type == b.type && a.bindPoint == b.bindPoint
+			&& a.space == b.space && a.size == b.size;
+	}
+
+	bool operator==(const ShaderReflection& a, const ShaderReflection& b)
+	{
+		return a.inputParameters == b.inputParameters && a.resources == b.resources;
+	}
+
+	//
+
+	class ReflectionWriter
+	{
+	public:
+		ReflectionWriter(Vector<uint8>& data) : m_Data(data) {}
+
+		void Write(uint32 v)
+		{
+			const uint8* bytes = reinterpret_cast<const uint8*>(&v);
+			m_Data.insert(m_Data.end(), bytes, bytes + sizeof(v));
+		}
+
+		void Write(const std::string& s)
+		{
+			Write(static_cast<uint32>(s.size()));
+			m_Data.insert(m_Data.end(), s.begin(), s.end());
+		}
+
+	private:
+		Vector<uint8>& m_Data;
+	};
+
+	class ReflectionReader
+	{
+	public:
+		ReflectionReader(const void* data, size_t size) : m_Data(static_cast<const uint8*>(data)), m_Size(size), m_Offset(0) {}
+
+		bool Read(uint32& v)
+		{
+			if (m_Size - m_Offset < sizeof(v))
+				return false;
+			memcpy(&v, m_Data + m_Offset, sizeof(v));
+			m_Offset += sizeof(v);
+			return true;
+		}
+
+		bool Read(std::string& s)
+		{
+			uint32 length = 0;
+			if (!Read(length) || m_Size - m_Offset < length)
+				return false;
+			s.assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+			m_Offset += length;
+			return true;
+		}
+
+		bool IsAtEnd() const { return m_Offset == m_Size; }
+
+	private:
+		const uint8* m_Data;
+		size_t m_Size;
+		size_t m_Offset;
+	};
+
+	Vector<uint8> SerializeShaderReflection(const ShaderReflection& reflection)
+	{
+		Vector<uint8> data;
+		ReflectionWriter w(data);
+		w.Write(SHADER_REFLECTION_MAGIC);
+		w.Write(SHADER_REFLECTION_VERSION);
+
+		w.Write(static_cast<uint32>(reflection.inputParameters.size()));
+		for (const auto& param : reflection.inputParameters)
+		{
+			w.Write(param.semanticName);
+			w.Write(param.semanticIndex);
+			w.Write(param.componentType);
+			w.Write(static_cast<uint32>(param.mask));
+		}
+
+		w.Write(static_cast<uint32>(reflection.resources.size()));
+		for (const auto& resource : reflection.resources)
+		{
+			w.Write(resource.name);
+			w.Write(static_cast<uint32>(resource.type));
+			w.Write(resource.bindPoint);
+			w.Write(resource.space);
+			w.Write(resource.size);
+		}
+		return data;
+	}
+
+	bool DeserializeShaderReflection(const void* data, size_t size, ShaderReflection& outReflection)
+	{
+		VAST_ASSERT(data || size == 0);
+		ReflectionReader r(data, size);
+
+		uint32 magic = 0, version = 0;
+		if (!r.Read(magic) || !r.Read(version) || magic != SHADER_REFLECTION_MAGIC || version != SHADER_REFLECTION_VERSION)
+			return false;
+
+		// Note: Counts are not trusted to reserve memory up front, since the data may be corrupted.
+		ShaderReflection reflection;
+		uint32 count = 0;
+		if (!r.Read(count))
+			return false;
+		for (uint32 i = 0; i < count; ++i)
+		{
+			ShaderInputParameter param;
+			uint32 mask = 0;
+			if (!r.Read(param.semanticName) || !r.Read(param.semanticIndex) || !r.Read(param.componentType) || !r.Read(mask))
+				return false;
+			param.mask = static_cast<uint8>(mask);
+			reflection.inputParameters.push_back(std::move(param));
+		}
+
+		if (!r.Read(count))
+			return false;
+		for (uint32 i = 0; i < count; ++i)
+		{
+			ShaderResourceBinding resource;
+			uint32 type = 0;
+			if (!r.Read(resource.name) || !r.Read(type) || !r.Read(resource.bindPoint) || !r.Read(resource.space) || !r.Read(resource.size))
+				return false;
+			if (type > static_cast<uint32>(ShaderResourceType::SAMPLER))
+				return false;
+			resource.type = static_cast<ShaderResourceType>(type);
+			reflection.resources.push_back(std::move(resource));
+		}
+
+		if (!r.IsAtEnd())
+			return false;
+
+		outReflection = std::move(reflection);
+		return true;
+	}
+
+}
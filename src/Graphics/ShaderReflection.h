@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Core/Types.h"
+
+// ====================================== SHADER REFLECTION =======================================
+//
+// The subset of shader reflection the engine uses to build input layouts, root signatures and
+// shader resource proxies, extracted once after compiling a shader.
+//
+// Reflection can be serialized to a compact binary form, which is what the shader cache stores
+// alongside the compiled bytecode, so that loading a cached shader doesn't need to go through the
+// shader compiler's reflection interfaces at all. Serialization has no dependencies on the graphics
+// API or the shader compiler.
+//
+// ================================================================================================
+
+namespace vast
+{
+	enum class ShaderResourceType : uint8
+	{
+		UNKNOWN = 0,
+		CONSTANT_BUFFER,
+		SRV,
+		UAV,
+		SAMPLER,
+	};
+
+	struct ShaderResourceBinding
+	{
+		std::string name;
+		ShaderResourceType type = ShaderResourceType::UNKNOWN;
+		uint32 bindPoint = 0;
+		uint32 space = 0;
+		// Size in bytes of constant buffers, 0 for other types.
+		uint32 size = 0;
+	};
+
+	struct ShaderInputParameter
+	{
+		std::string semanticName;
+		uint32 semanticIndex = 0;
+		// Note: Stored as the graphics API defines it (i.e. D3D_REGISTER_COMPONENT_TYPE).
+		uint32 componentType = 0;
+		uint8 mask = 0;
+	};
+
+	struct ShaderReflection
+	{
+		Vector<ShaderInputParameter> inputParameters;
+		// In the order the shader declares them.
+		Vector<ShaderResourceBinding> resources;
+	};
+
+	bool operator==(const ShaderReflection& a, const ShaderReflection& b);
+
+	Vector<uint8> SerializeShaderReflection(const ShaderReflection& reflection);
+	// Returns false if the data is not a valid serialized reflection (e.g. truncated, or written by
+	// a different version).
+	bool DeserializeShaderReflection(const void* data, size_t size, ShaderReflection& outReflection);
+
+}
@@ -1,40 +1,103 @@
 #include "vastpch.h"
 #include "Graphics/ShaderResourceProxy.h"
 
+#include <algorithm>
+#include <bit>
+
 namespace vast
 {
 
-	ShaderResourceProxy ShaderResourceProxyTable::LookupShaderResource(const std::string& shaderResourceName)
+	ShaderResourceProxyTable::ShaderResourceProxyTable()
+		: m_Resources({})
+		, m_Slots({})
+		, m_Multiplier(0)
+		, m_Shift(0)
 	{
-		return m_Map[shaderResourceName];
 	}
 
 	void ShaderResourceProxyTable::Reset()
 	{
-		m_Map.clear();
+		m_Resources.clear();
+		m_Slots.clear();
+		m_Multiplier = 0;
+		m_Shift = 0;
 	}
 
 	void ShaderResourceProxyTable::Register(const std::string& shaderResourceName, const ShaderResourceProxy& proxyIdx)
 	{
-#ifdef VAST_DEBUG
-		if (IsRegistered(shaderResourceName))
+		VAST_ASSERTF(m_Slots.empty(), "Shader resources can't be registered after the proxy table is built.");
+		const ShaderResourceKey key = MakeShaderResourceKey(shaderResourceName);
+		for (auto& resource : m_Resources)
 		{
-			if (proxyIdx.idx == m_Map[shaderResourceName].idx)
+			if (resource.key == key)
 			{
+				if (resource.proxy.idx != proxyIdx.idx)
+				{
+					VAST_LOG_WARNING("[resource] [shader] Overriding shader resource proxy '{}' value (was '{}', now is '{}'.", shaderResourceName, resource.proxy.idx, proxyIdx.idx);
+					resource.proxy = proxyIdx;
+				}
 				return;
 			}
-			else
-			{
-				VAST_LOG_WARNING("[resource] [shader] Overriding shader resource proxy '{}' value (was '{}', now is '{}'.", shaderResourceName, proxyIdx.idx, m_Map[shaderResourceName].idx);
-			}
 		}
-#endif
-		m_Map[shaderResourceName] = proxyIdx;
+		m_Resources.push_back(Slot{ key, proxyIdx });
+	}
+
+	bool ShaderResourceProxyTable::IsRegistered(const std::string& shaderResourceName) const
+	{
+		const ShaderResourceKey key = MakeShaderResourceKey(shaderResourceName);
+		return std::any_of(m_Resources.begin(), m_Resources.end(), [key](const Slot& resource) { return resource.key == key; });
+	}
+
+	static uint64 SplitMix64(uint64& state)
+	{
+		uint64 z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
 	}
 
-	bool ShaderResourceProxyTable::IsRegistered(const std::string& shaderResourceName)
+	void ShaderResourceProxyTable::Build()
 	{
-		return (m_Map.find(shaderResourceName) != m_Map.end());
+		VAST_PROFILE_TRACE_FUNCTION;
+
+		// Note: Pipelines use few resources, so a multiplier that maps every key to a different slot
+		// is usually found within a few attempts. If not, the table grows, which is guaranteed to
+		// succeed eventually since keys are distinct.
+		const uint32 numResources = static_cast<uint32>(m_Resources.size());
+		uint32 numBits = std::max(1u, static_cast<uint32>(std::bit_width(std::max(numResources, 1u) - 1)));
+		uint64 state = HASH_OFFSET_BASIS;
+		Vector<uint8> bIsSlotUsed;
+		while (true)
+		{
+			VAST_ASSERTF(numBits < 32, "Failed to build shader resource proxy table.");
+			const uint32 shift = 64 - numBits;
+			for (uint32 attempt = 0; attempt < 32; ++attempt)
+			{
+				const uint64 multiplier = SplitMix64(state) | 1;
+				bIsSlotUsed.assign(1ull << numBits, 0);
+
+				bool bIsPerfect = true;
+				for (uint32 i = 0; i < numResources && bIsPerfect; ++i)
+				{
+					uint8& bIsUsed = bIsSlotUsed[GetSlotIndex(m_Resources[i].key, multiplier, shift)];
+					bIsPerfect = !bIsUsed;
+					bIsUsed = true;
+				}
+
+				if (bIsPerfect)
+				{
+					m_Multiplier = multiplier;
+					m_Shift = shift;
+					m_Slots.assign(1ull << numBits, Slot{});
+					for (const auto& resource : m_Resources)
+					{
+						m_Slots[GetSlotIndex(resource.key, m_Multiplier, m_Shift)] = resource;
+					}
+					return;
+				}
+			}
+			numBits++;
+		}
 	}
 
 }
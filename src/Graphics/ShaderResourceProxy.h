@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Core/Core.h"
-
-#include <unordered_map>
+#include "Core/Hash.h"
 
 namespace vast
 {
@@ -15,17 +14,65 @@ namespace vast
 		uint32 idx = kInvalidShaderResourceProxy;
 	};
 
+	// Identifies a shader resource by a hash of its name.
+	using ShaderResourceKey = uint64;
+
+	constexpr ShaderResourceKey MakeShaderResourceKey(std::string_view shaderResourceName)
+	{
+		return HashString(shaderResourceName);
+	}
+
+	// Name of a shader resource to look up, hashed at compile time when given a string literal, e.g.
+	// LookupShaderResource(h, "ObjectConstantBuffer"). Names only known at runtime can be looked up
+	// by their key instead.
+	struct ShaderResourceName
+	{
+		template<size_t N>
+		consteval ShaderResourceName(const char (&name)[N]) : key(MakeShaderResourceKey(std::string_view(name, N - 1))) {}
+		constexpr explicit ShaderResourceName(ShaderResourceKey k) : key(k) {}
+
+		ShaderResourceKey key;
+	};
+
+	// Maps the resources used by a pipeline's shaders to their proxies. Resources are registered
+	// while the pipeline is created, and Build then lays the table out as a flat array where every
+	// registered key hashes to its own slot (i.e. a perfect hash), so that lookups are a single
+	// probe, and never allocate or insert.
 	class ShaderResourceProxyTable
 	{
 	public:
-		ShaderResourceProxy LookupShaderResource(const std::string& shaderResourceName);
+		ShaderResourceProxyTable();
 
 		void Reset();
-		void Register(const std::string& shaderResourceName, const ShaderResourceProxy& proxyIdx);
-		bool IsRegistered(const std::string& shaderResourceName);
+		void Register(const std::string& shaderResourceName, const ShaderResourceProxy& proxy);
+		bool IsRegistered(const std::string& shaderResourceName) const;
+		void Build();
+
+		// Returns an invalid proxy if the resource isn't used by the pipeline.
+		ShaderResourceProxy LookupShaderResource(ShaderResourceKey key) const
+		{
+			VAST_ASSERTF(!m_Slots.empty(), "Shader resource proxy table looked up before being built.");
+			const Slot& slot = m_Slots[GetSlotIndex(key, m_Multiplier, m_Shift)];
+			return (slot.key == key) ? slot.proxy : ShaderResourceProxy{};
+		}
 
 	private:
-		std::unordered_map<std::string, ShaderResourceProxy> m_Map;
+		struct Slot
+		{
+			ShaderResourceKey key = 0;
+			ShaderResourceProxy proxy;
+		};
+
+		static uint32 GetSlotIndex(ShaderResourceKey key, uint64 multiplier, uint32 shift)
+		{
+			return static_cast<uint32>((key * multiplier) >> shift);
+		}
+
+		// Registered resources, laid out into slots on Build.
+		Vector<Slot> m_Resources;
+		Vector<Slot> m_Slots;
+		uint64 m_Multiplier;
+		uint32 m_Shift;
 	};
 
-}
\ No newline at end of file
+}
@@ -143,10 +143,7 @@ namespace vast
 			ctx.BindIndexBuffer(idxView.buffer, idxView.offset, IndexBufFormat::R16_UINT);
 
 			// Bind temporary CBV
-			const float4x4 mvp = ComputeProjectionMatrix(drawData);
-			BufferView cbv = rm.AllocTempBufferView(sizeof(float4x4), CONSTANT_BUFFER_ALIGNMENT);
-			memcpy(cbv.data, &mvp, sizeof(float4x4));
-			ctx.BindConstantBuffer(m_CbvProxy, cbv.buffer, cbv.offset);
+			ctx.BindDynamicConstantBuffer(m_CbvProxy, ComputeProjectionMatrix(drawData));
 
 			ctx.SetBlendFactor(float4(0));
 			uint32 vtxOffset = 0, idxOffset = 0;